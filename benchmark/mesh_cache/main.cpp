@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Logger.h>
+#include <Mesh.h>
+#include <MeshCache.h>
+#include <MeshImporter.h>
+
+namespace {
+    const Vixen::Logger logger{"MeshCacheBenchmark"};
+
+    struct Timing {
+        double minimum = std::numeric_limits<double>::max();
+
+        double total = 0.0;
+
+        uint32_t samples = 0;
+
+        void add(double milliseconds) {
+            minimum = std::min(minimum, milliseconds);
+            total += milliseconds;
+            samples++;
+        }
+
+        [[nodiscard]] double mean() const {
+            return samples == 0 ? 0.0 : total / samples;
+        }
+    };
+
+    /**
+     * Parses a whole number of at least a minimum, throws when the value is not such a number
+     */
+    uint32_t parseCount(const std::string &argument, const std::string &value, uint32_t minimum) {
+        size_t end = 0;
+        long long count = -1;
+        try {
+            count = std::stoll(value, &end);
+        } catch (const std::invalid_argument &) {
+        } catch (const std::out_of_range &) {
+        }
+        /// stoll stops at the first character that is not a digit, the whole value has to be the number
+        if (end != value.size() || count < minimum || count > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error(fmt::format("{} expects a whole number of at least {}, got \"{}\"", argument,
+                                                 minimum, value));
+        return static_cast<uint32_t>(count);
+    }
+
+    template<typename F>
+    double measure(F &&function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * Packs freshly imported meshes the way Mesh lays out its buffer
+     */
+    size_t pack(const std::vector<Vixen::MeshData> &meshes, std::vector<uint8_t> &staging) {
+        size_t offset = 0;
+        for (const auto &mesh : meshes) {
+            const auto size = Vixen::Mesh::packedSize(mesh.layout, mesh.vertices.size(), mesh.indices.size());
+            if (staging.size() < offset + size)
+                staging.resize(offset + size);
+            Vixen::MeshImporter::pack(mesh, staging.data() + offset);
+            offset += size;
+        }
+        return offset;
+    }
+
+    size_t copy(const Vixen::MeshCache &cache, std::vector<uint8_t> &staging) {
+        size_t offset = 0;
+        for (const auto &entry : cache.getEntries()) {
+            const auto size = Vixen::Mesh::packedSize(entry.layout, entry.vertexCount, entry.indexCount);
+            if (staging.size() < offset + size)
+                staging.resize(offset + size);
+            memcpy(staging.data() + offset, entry.data, size);
+            offset += size;
+        }
+        return offset;
+    }
+}
+
+/**
+ * Compares a cold import through Assimp against a warm load from the mesh cache. Both produce the packed mesh data in a
+ * buffer standing in for staging memory, so the warm numbers include touching every mapped page once.
+ */
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+
+    uint32_t iterations = 5;
+    std::vector<std::string> models;
+    try {
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            if (argument == "--iterations") {
+                if (i + 1 >= argc)
+                    throw std::runtime_error(fmt::format("{} misses its value", argument));
+                iterations = parseCount(argument, argv[++i], 1);
+            } else if (argument.starts_with("--")) {
+                throw std::runtime_error(fmt::format("Unknown argument \"{}\"", argument));
+            } else {
+                models.push_back(argument);
+            }
+        }
+        if (models.empty())
+            throw std::runtime_error("No model given");
+    } catch (const std::runtime_error &error) {
+        logger.error("{}", error.what());
+        logger.error("Usage: {} [--iterations <count>] <model>...", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const auto directory = std::filesystem::temp_directory_path() / "vixen-mesh-cache-benchmark";
+    std::vector<uint8_t> staging;
+    bool success = true;
+    for (const auto &model : models) {
+        try {
+            const auto source = Vixen::MeshCache::Source::of(model, Vixen::MeshImporter::importFlags);
+            const auto path = Vixen::MeshCache::locate(directory, model);
+
+            Timing cold;
+            Timing warm;
+            size_t bytes = 0;
+            std::vector<Vixen::MeshData> meshes;
+            for (uint32_t i = 0; i < iterations; i++)
+                cold.add(measure([&]() {
+                    meshes = Vixen::MeshImporter::import(model);
+                    bytes = pack(meshes, staging);
+                }));
+
+            Vixen::MeshCache::write(path, source, meshes);
+            for (uint32_t i = 0; i < iterations; i++)
+                warm.add(measure([&]() {
+                    const Vixen::MeshCache cache(path, source);
+                    bytes = copy(cache, staging);
+                }));
+            std::filesystem::remove(path);
+
+            logger.info("{}: {} meshes, {:.1f} MiB", model, meshes.size(),
+                        static_cast<double>(bytes) / (1024.0 * 1024.0));
+            logger.info("  cold Assimp import  mean {:9.2f}ms  min {:9.2f}ms", cold.mean(), cold.minimum);
+            logger.info("  warm cache load     mean {:9.2f}ms  min {:9.2f}ms", warm.mean(), warm.minimum);
+            logger.info("  speedup             {:.1f}x", cold.mean() / std::max(warm.mean(), 1e-6));
+        } catch (std::exception &error) {
+            logger.error("{}: {}", model, error.what());
+            success = false;
+        }
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,400 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <glm/gtc/constants.hpp>
+#include <VixenEngine.h>
+#include <GeometryArena.h>
+#include <JobSystem.h>
+#include <UploadManager.h>
+
+namespace {
+    const Vixen::Logger logger{"SceneStressBenchmark"};
+
+    struct Options {
+        uint32_t entities = 2000;
+
+        uint32_t meshes = 32;
+
+        uint32_t textures = 16;
+
+        uint32_t lights = 64;
+
+        uint32_t frames = 1000;
+
+        /// Frames rendered before measuring, pipelines are created and the shadow cascades cached during them
+        uint32_t warmup = 100;
+
+        /// The share of entities tagged static, the others spin every frame and are drawn into every cascade
+        float staticShare = 0.75f;
+
+        uint32_t width = 1280;
+
+        uint32_t height = 720;
+
+        uint32_t seed = 1;
+
+        bool windowed = false;
+
+        std::string output = "scene_stress.json";
+
+        /// Where to write the timings of every measured frame, none if empty
+        std::string csv;
+    };
+
+    /**
+     * Parses a whole number of at least a minimum, throws when the value is not such a number
+     */
+    uint32_t parseCount(const std::string &argument, const std::string &value, uint32_t minimum) {
+        size_t end = 0;
+        long long count = -1;
+        try {
+            count = std::stoll(value, &end);
+        } catch (const std::invalid_argument &) {
+        } catch (const std::out_of_range &) {
+        }
+        /// stoll stops at the first character that is not a digit, the whole value has to be the number
+        if (end != value.size() || count < minimum || count > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error(fmt::format("{} expects a whole number of at least {}, got \"{}\"", argument,
+                                                 minimum, value));
+        return static_cast<uint32_t>(count);
+    }
+
+    /**
+     * Parses a share from 0 to 1, throws when the value is not such a number
+     */
+    float parseShare(const std::string &argument, const std::string &value) {
+        size_t end = 0;
+        float share = -1.0f;
+        try {
+            share = std::stof(value, &end);
+        } catch (const std::invalid_argument &) {
+        } catch (const std::out_of_range &) {
+        }
+        if (end != value.size() || !(share >= 0.0f && share <= 1.0f))
+            throw std::runtime_error(fmt::format("{} expects a number from 0 to 1, got \"{}\"", argument, value));
+        return share;
+    }
+
+    /**
+     * Parses the command line, throws when an argument is unknown, misses its value or the value is invalid
+     */
+    Options parseOptions(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const auto value = [&]() -> std::string {
+                if (i + 1 >= argc)
+                    throw std::runtime_error(fmt::format("{} misses its value", argument));
+                return argv[++i];
+            };
+            if (argument == "--windowed")
+                options.windowed = true;
+            else if (argument == "--entities")
+                options.entities = parseCount(argument, value(), 1);
+            else if (argument == "--meshes")
+                options.meshes = parseCount(argument, value(), 1);
+            else if (argument == "--textures")
+                options.textures = parseCount(argument, value(), 1);
+            else if (argument == "--lights")
+                options.lights = parseCount(argument, value(), 0);
+            else if (argument == "--frames")
+                options.frames = parseCount(argument, value(), 1);
+            else if (argument == "--warmup")
+                options.warmup = parseCount(argument, value(), 0);
+            else if (argument == "--static")
+                options.staticShare = parseShare(argument, value());
+            else if (argument == "--width")
+                options.width = parseCount(argument, value(), 1);
+            else if (argument == "--height")
+                options.height = parseCount(argument, value(), 1);
+            else if (argument == "--seed")
+                options.seed = parseCount(argument, value(), 0);
+            else if (argument == "--output")
+                options.output = value();
+            else if (argument == "--csv")
+                options.csv = value();
+            else
+                throw std::runtime_error(fmt::format("Unknown argument \"{}\"", argument));
+        }
+        return options;
+    }
+
+    /**
+     * A unit sphere with bumps that differ per mesh. The ring count differs too, so meshes range from a few hundred to
+     * several thousand vertices.
+     */
+    std::shared_ptr<Vixen::Mesh> createMesh(Vixen::UploadManager &uploader,
+                                            const std::shared_ptr<Vixen::GeometryArena> &arena,
+                                            const std::shared_ptr<Vixen::ImageView> &texture, uint32_t index) {
+        const uint32_t rings = 8 + (index * 37) % 56;
+        const uint32_t segments = 2 * rings;
+        const float frequency = static_cast<float>(2 + index % 7);
+        const float amplitude = 0.05f + 0.02f * static_cast<float>(index % 5);
+
+        std::vector<glm::vec3> vertices;
+        std::vector<glm::vec2> uvs;
+        std::vector<glm::vec4> colors;
+        std::vector<glm::vec3> normals;
+        for (uint32_t ring = 0; ring <= rings; ring++) {
+            const float v = static_cast<float>(ring) / static_cast<float>(rings);
+            const float polar = v * glm::pi<float>();
+            for (uint32_t segment = 0; segment <= segments; segment++) {
+                const float u = static_cast<float>(segment) / static_cast<float>(segments);
+                const float azimuth = u * 2.0f * glm::pi<float>();
+                const glm::vec3 normal{std::sin(polar) * std::cos(azimuth), std::cos(polar),
+                                       std::sin(polar) * std::sin(azimuth)};
+                const float radius = 1.0f + amplitude * std::sin(frequency * polar) * std::cos(frequency * azimuth);
+
+                vertices.push_back(normal * radius);
+                uvs.emplace_back(u, v);
+                colors.emplace_back(1.0f);
+                normals.push_back(normal);
+            }
+        }
+
+        std::vector<uint32_t> indices;
+        indices.reserve(6 * rings * segments);
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const uint32_t current = ring * (segments + 1) + segment;
+                const uint32_t below = current + segments + 1;
+                indices.insert(indices.end(), {current, current + 1, below, current + 1, below + 1, below});
+            }
+        }
+
+        return std::make_shared<Vixen::Mesh>(uploader, arena, texture, vertices, indices, uvs, colors, normals);
+    }
+
+    /**
+     * A checkerboard of two random colors, its mip levels are generated on upload
+     */
+    std::shared_ptr<Vixen::ImageView> createTexture(Vixen::UploadManager &uploader, std::mt19937 &random) {
+        constexpr uint32_t size = 256;
+        constexpr uint32_t tile = 32;
+        std::uniform_int_distribution<uint32_t> channel(0, 255);
+        const std::array<std::array<uint8_t, 4>, 2> palette{{
+                {static_cast<uint8_t>(channel(random)), static_cast<uint8_t>(channel(random)),
+                 static_cast<uint8_t>(channel(random)), 0xFF},
+                {static_cast<uint8_t>(channel(random)), static_cast<uint8_t>(channel(random)),
+                 static_cast<uint8_t>(channel(random)), 0xFF}
+        }};
+
+        const auto pixels = std::make_shared<std::vector<uint8_t>>(size * size * 4);
+        for (uint32_t y = 0; y < size; y++)
+            for (uint32_t x = 0; x < size; x++)
+                std::copy_n(palette[(x / tile + y / tile) % 2].data(), 4, pixels->data() + (y * size + x) * 4);
+
+        return std::make_shared<Vixen::ImageView>(
+                Vixen::Image::from(uploader, Vixen::ImageData{VK_FORMAT_R8G8B8A8_SRGB, size, size, {0},
+                                                              std::shared_ptr<const uint8_t>(pixels, pixels->data()),
+                                                              pixels->size()}),
+                VK_IMAGE_ASPECT_COLOR_BIT);
+    }
+
+    /// JSON has no NaN, times that were not measured are written as null
+    std::string number(double value) {
+        return std::isnan(value) ? "null" : fmt::format("{:.4f}", value);
+    }
+
+    std::string toJson(const Vixen::FrameStatistics::Distribution &distribution) {
+        return fmt::format("{{\"Samples\": {}, \"Average\": {}, \"Median\": {}, \"P95\": {}, \"P99\": {}, "
+                           "\"Max\": {}, \"OnePercentLow\": {}}}", distribution.samples,
+                           number(distribution.average), number(distribution.median), number(distribution.p95),
+                           number(distribution.p99), number(distribution.max), number(distribution.onePercentLow));
+    }
+}
+
+/**
+ * Renders a procedurally built scene for a number of frames and writes the frame times, draw calls and memory usage as
+ * JSON, so changes to the renderer can be compared on the same scene. The window is headless unless asked otherwise,
+ * which lets the benchmark run on a software Vulkan implementation without a display.
+ *
+ * Entities stand on a grid that the camera circles, every entity draws one of the meshes and every mesh samples one of
+ * the textures. Lights float above the grid at random.
+ */
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::runtime_error &e) {
+        logger.error("{}", e.what());
+        logger.error("Usage: {} [--entities <count>] [--meshes <count>] [--textures <count>] [--lights <count>] "
+                     "[--frames <count>] [--warmup <count>] [--static <share>] [--width <pixels>] "
+                     "[--height <pixels>] [--seed <seed>] [--output <file>] [--csv <file>] [--windowed]", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const auto window = std::make_shared<Vixen::Window>("Vixen Scene Stress Benchmark", "../../icon.png", nullptr,
+                                                        static_cast<int>(options.width),
+                                                        static_cast<int>(options.height), !options.windowed);
+    const auto instance = std::make_shared<Vixen::Instance>(window, "Vixen Scene Stress Benchmark",
+                                                            glm::ivec3(0, 0, 1));
+    const auto physicalDevice = std::make_shared<Vixen::PhysicalDevice>(instance);
+    const auto device = std::make_shared<Vixen::LogicalDevice>(instance, window, physicalDevice);
+    const auto jobs = std::make_shared<Vixen::JobSystem>();
+
+    std::mt19937 random(options.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    Vixen::UploadManager uploader(device);
+    const auto arena = std::make_shared<Vixen::GeometryArena>(device);
+    std::vector<std::shared_ptr<Vixen::ImageView>> textures;
+    for (uint32_t i = 0; i < options.textures; i++)
+        textures.push_back(createTexture(uploader, random));
+    std::vector<std::shared_ptr<Vixen::Mesh>> meshes;
+    uint64_t triangles = 0;
+    for (uint32_t i = 0; i < options.meshes; i++) {
+        meshes.push_back(createMesh(uploader, arena, textures[i % textures.size()], i));
+        triangles += meshes.back()->getIndexCount() / 3;
+    }
+    uploader.flush();
+    logger.info("{}: {} meshes with {} triangles in total, {} textures", physicalDevice->deviceProperties.deviceName,
+                meshes.size(), triangles, textures.size());
+
+    constexpr float spacing = 3.0f;
+    const auto side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(options.entities))));
+    const float extent = static_cast<float>(side) * spacing;
+
+    Vixen::Scene scene{};
+    std::vector<Vixen::TransformNode> spinning;
+    for (uint32_t i = 0; i < options.entities; i++) {
+        const glm::vec3 position{(static_cast<float>(i % side) + 0.5f) * spacing - extent / 2.0f, 1.0f,
+                                 (static_cast<float>(i / side) + 0.5f) * spacing - extent / 2.0f};
+        /// Drawn one at a time, the order arguments are evaluated in would change the scene between compilers
+        const float angle = unit(random) * 2.0f * glm::pi<float>();
+        const float scale = 0.5f + unit(random);
+        const auto node = scene.transforms.create(position, glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f)),
+                                                  glm::vec3(scale));
+
+        const Vixen::MeshRenderer renderer{meshes[i % meshes.size()]};
+        if (unit(random) < options.staticShare) {
+            scene.world.create(Vixen::Transform{node}, renderer, Vixen::Static{});
+        } else {
+            scene.world.create(Vixen::Transform{node}, renderer);
+            spinning.push_back(node);
+        }
+    }
+    scene.transforms.update(jobs.get());
+    scene.revision++;
+    scene.staticRevision++;
+
+    for (uint32_t i = 0; i < options.lights; i++) {
+        std::array<float, 8> values{};
+        for (auto &value : values)
+            value = unit(random);
+        scene.lights.emplace_back(glm::vec3{(values[0] - 0.5f) * extent, 2.0f + 4.0f * values[1],
+                                            (values[2] - 0.5f) * extent},
+                                  4.0f + 8.0f * values[3],
+                                  glm::vec3{0.3f + 0.7f * values[4], 0.3f + 0.7f * values[5],
+                                            0.3f + 0.7f * values[6]},
+                                  2.0f + 6.0f * values[7]);
+    }
+    scene.sun = Vixen::DirectionalLight({-0.4f, -1.0f, -0.3f}, {1.0f, 0.95f, 0.9f}, 0.8f);
+
+    Vixen::RenderThread renderThread(
+            device,
+            physicalDevice,
+            scene.camera,
+            Vixen::Shader::Builder()
+                    .addModule(Vixen::ShaderModule::Builder(device)
+                                       .setShaderStage(VK_SHADER_STAGE_VERTEX_BIT)
+                                       .setBytecode("vert.spv")
+                                       .build())
+                    .addModule(Vixen::ShaderModule::Builder(device)
+                                       .setShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT)
+                                       .setBytecode("frag.spv")
+                                       .build())
+                    .addDescriptor(0, 2 * sizeof(glm::mat4), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                   VK_SHADER_STAGE_VERTEX_BIT)
+                    .addDescriptor(1, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                                   VK_SHADER_STAGE_FRAGMENT_BIT)
+                    .addDescriptor(2, 2 * sizeof(glm::mat4), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                   VK_SHADER_STAGE_VERTEX_BIT)
+                    .build());
+    const auto statistics = renderThread.getStatistics();
+
+    /// Every frame advances by the same amount, so every run renders the same sequence of frames
+    uint64_t frame = 0;
+    const auto render = [&]() {
+        const float orbit = static_cast<float>(frame++) * 0.002f;
+        scene.camera.position = {std::cos(orbit) * extent * 0.6f, extent * 0.25f + 2.0f,
+                                 std::sin(orbit) * extent * 0.6f};
+        scene.camera.rotation = glm::normalize(glm::vec3(0.0f, 1.0f, 0.0f) - scene.camera.position);
+
+        const auto spin = glm::angleAxis(0.02f, glm::vec3(0.0f, 1.0f, 0.0f));
+        for (const auto node : spinning)
+            scene.transforms.setRotation(node, scene.transforms.getRotation(node) * spin);
+        scene.transforms.update(jobs.get());
+
+        Vixen::Window::update();
+        renderThread.submit(scene);
+    };
+
+    for (uint32_t i = 0; i < options.warmup; i++)
+        render();
+    renderThread.synchronize();
+
+    /// Frames are recorded once the GPU finished them, so rendering continues until the last measured frame is in
+    statistics->resize(options.frames);
+    const auto start = std::chrono::steady_clock::now();
+    while (statistics->getRecordedCount() < options.frames && !window->shouldClose())
+        render();
+    renderThread.synchronize();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto report = statistics->report();
+    const auto frames = statistics->getFrames();
+    uint64_t totalDraws = 0;
+    uint32_t maxDraws = 0;
+    for (const auto &timing : frames) {
+        totalDraws += timing.draws;
+        maxDraws = std::max(maxDraws, timing.draws);
+    }
+    const double averageDraws = frames.empty() ? 0.0 : static_cast<double>(totalDraws) / frames.size();
+
+    VkDeviceSize usage = 0;
+    for (const auto &heap : device->getHeapBudgets())
+        if (heap.deviceLocal)
+            usage += heap.usage;
+
+    logger.info("{} frames in {:.2f}s: p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms, 1% low {:.0f} FPS, "
+                "{} hitches", report.frames, seconds, report.present.median, report.present.p95, report.present.p99,
+                report.present.max, 1000.0 / report.present.onePercentLow, report.hitches);
+    logger.info("CPU p95 {:.2f}ms, GPU p95 {:.2f}ms, {:.0f} draw calls per frame, {} MiB of device memory",
+                report.cpu.p95, report.gpu.p95, averageDraws, usage / (1024 * 1024));
+
+    std::ofstream output(options.output);
+    output << fmt::format("{{\"Device\": \"{}\", \"Headless\": {}, ", physicalDevice->deviceProperties.deviceName,
+                          !options.windowed)
+           << fmt::format("\"Scene\": {{\"Entities\": {}, \"Static\": {}, \"Meshes\": {}, \"Triangles\": {}, "
+                          "\"Textures\": {}, \"Lights\": {}, \"Width\": {}, \"Height\": {}, \"Seed\": {}}}, ",
+                          options.entities, options.entities - spinning.size(), meshes.size(), triangles,
+                          textures.size(), options.lights, device->extent.width, device->extent.height, options.seed)
+           << fmt::format("\"Frames\": {}, \"Seconds\": {}, \"Hitches\": {}, ", report.frames, number(seconds),
+                          report.hitches)
+           << "\"Cpu\": " << toJson(report.cpu) << ", \"Gpu\": " << toJson(report.gpu)
+           << ", \"Present\": " << toJson(report.present) << ", "
+           << fmt::format("\"DrawCalls\": {{\"Average\": {}, \"Max\": {}}}, ", number(averageDraws), maxDraws)
+           << "\"Memory\": " << device->dumpMemoryStatistics() << "}\n";
+    if (!output) {
+        logger.error("Failed to write the results to {}", options.output);
+        return EXIT_FAILURE;
+    }
+    logger.info("Wrote the results to {}", options.output);
+
+    if (!options.csv.empty()) {
+        std::ofstream csv(options.csv);
+        statistics->writeCsv(csv);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include <JobSystem.h>
+#include <Logger.h>
+#include <TransformHierarchy.h>
+
+namespace {
+    const Vixen::Logger logger{"TransformHierarchyBenchmark"};
+
+    /**
+     * A node of the baseline, every world matrix is composed on its own from glm matrices
+     */
+    struct NaiveNode {
+        glm::vec3 position;
+
+        glm::quat rotation;
+
+        glm::vec3 scale;
+
+        /// Parents come before their children, roots have no parent
+        uint32_t parent;
+
+        glm::mat4 world;
+    };
+
+    /**
+     * Parses a whole number of at least a minimum, throws when the value is not such a number
+     */
+    uint32_t parseCount(const std::string &argument, const std::string &value, uint32_t minimum) {
+        size_t end = 0;
+        long long count = -1;
+        try {
+            count = std::stoll(value, &end);
+        } catch (const std::invalid_argument &) {
+        } catch (const std::out_of_range &) {
+        }
+        /// stoll stops at the first character that is not a digit, the whole value has to be the number
+        if (end != value.size() || count < minimum || count > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error(fmt::format("{} expects a whole number of at least {}, got \"{}\"", argument,
+                                                 minimum, value));
+        return static_cast<uint32_t>(count);
+    }
+
+    /**
+     * Parses a share from 0 to 1, throws when the value is not such a number
+     */
+    float parseShare(const std::string &argument, const std::string &value) {
+        size_t end = 0;
+        float share = -1.0f;
+        try {
+            share = std::stof(value, &end);
+        } catch (const std::invalid_argument &) {
+        } catch (const std::out_of_range &) {
+        }
+        if (end != value.size() || !(share >= 0.0f && share <= 1.0f))
+            throw std::runtime_error(fmt::format("{} expects a number from 0 to 1, got \"{}\"", argument, value));
+        return share;
+    }
+
+    template<typename F>
+    double measure(uint32_t iterations, F &&function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++)
+            function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const std::string &path, size_t updated, uint32_t iterations, double seconds) {
+        const double perIteration = seconds / iterations;
+        logger.info("  {:<28} {:9.1f}M matrices/s  {:9.3f}ms per update ({} matrices)", path,
+                    static_cast<double>(updated) / std::max(perIteration, 1e-9) / 1e6, perIteration * 1e3, updated);
+    }
+
+    void updateNaive(std::vector<NaiveNode> &nodes) {
+        for (auto &node : nodes) {
+            const glm::mat4 local = glm::translate(glm::mat4(1.0f), node.position) * glm::mat4_cast(node.rotation) *
+                                    glm::scale(glm::mat4(1.0f), node.scale);
+            node.world = node.parent == UINT32_MAX ? local : nodes[node.parent].world * local;
+        }
+    }
+}
+
+/**
+ * Measures how many world matrices the transform hierarchy composes per second. Nodes form trees a few levels deep.
+ * A full update moves every root so every node changes, a partial update moves a fraction of random nodes and their
+ * subtrees. A baseline composing every node with plain glm matrix products, the way a flat transform would, is
+ * measured on the same trees.
+ */
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+
+    uint32_t nodeCount = 1000000;
+    uint32_t depth = 5;
+    uint32_t iterations = 20;
+    float fraction = 0.01f;
+    try {
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            const auto value = [&]() -> std::string {
+                if (i + 1 >= argc)
+                    throw std::runtime_error(fmt::format("{} misses its value", argument));
+                return argv[++i];
+            };
+            if (argument == "--nodes")
+                nodeCount = parseCount(argument, value(), 1);
+            else if (argument == "--depth")
+                depth = parseCount(argument, value(), 1);
+            else if (argument == "--iterations")
+                iterations = parseCount(argument, value(), 1);
+            else if (argument == "--dirty")
+                fraction = parseShare(argument, value());
+            else
+                throw std::runtime_error(fmt::format("Unknown argument \"{}\"", argument));
+        }
+    } catch (const std::runtime_error &error) {
+        logger.error("{}", error.what());
+        logger.error("Usage: {} [--nodes <count>] [--depth <levels>] [--iterations <count>] [--dirty <share>]",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    const auto randomRotation = [&]() {
+        return glm::normalize(glm::quat(distribution(random), distribution(random), distribution(random),
+                                        distribution(random)));
+    };
+    const auto randomPosition = [&]() {
+        return glm::vec3(distribution(random), distribution(random), distribution(random)) * 10.0f;
+    };
+
+    /// Every level holds as many nodes, children pick a random parent in the level above
+    Vixen::TransformHierarchy hierarchy;
+    std::vector<Vixen::TransformNode> nodes;
+    std::vector<NaiveNode> naive;
+    nodes.reserve(nodeCount);
+    naive.reserve(nodeCount);
+    const uint32_t levelSize = std::max(nodeCount / depth, 1u);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const uint32_t level = std::min(i / levelSize, depth - 1);
+        const uint32_t parent = level == 0 ? UINT32_MAX : (level - 1) * levelSize + random() % levelSize;
+        const glm::vec3 position = randomPosition();
+        const glm::quat rotation = randomRotation();
+        const glm::vec3 scale(1.0f + distribution(random) * 0.1f);
+
+        nodes.push_back(hierarchy.create(position, rotation, scale,
+                                         parent == UINT32_MAX ? Vixen::TransformNode{} : nodes[parent]));
+        naive.push_back({position, rotation, scale, parent, glm::mat4(1.0f)});
+    }
+    hierarchy.update();
+    updateNaive(naive);
+
+    float error = 0.0f;
+    for (uint32_t i = 0; i < nodeCount; i += std::max(nodeCount / 1000, 1u)) {
+        const glm::mat4 &world = hierarchy.getWorldMatrix(nodes[i]);
+        for (int column = 0; column < 4; column++)
+            for (int row = 0; row < 4; row++)
+                error = std::max(error, std::abs(world[column][row] - naive[i].world[column][row]));
+    }
+    logger.info("{} nodes in {} levels, {} lanes, largest difference to the baseline {}", hierarchy.getSize(),
+                hierarchy.getDepth(), Vixen::TransformHierarchy::lanes, error);
+
+    const uint32_t roots = std::min(levelSize, nodeCount);
+    report("baseline, every node", nodeCount, iterations, measure(iterations, [&]() {
+        updateNaive(naive);
+    }));
+    report("hierarchy, every node", nodeCount, iterations, measure(iterations, [&]() {
+        for (uint32_t i = 0; i < roots; i++)
+            hierarchy.setRotation(nodes[i], hierarchy.getRotation(nodes[i]));
+        hierarchy.update();
+    }));
+
+    Vixen::JobSystem jobs;
+    report(fmt::format("hierarchy, every node, {} threads", jobs.getThreadCount() + 1), nodeCount, iterations,
+           measure(iterations, [&]() {
+               for (uint32_t i = 0; i < roots; i++)
+                   hierarchy.setRotation(nodes[i], hierarchy.getRotation(nodes[i]));
+               hierarchy.update(&jobs);
+           }));
+
+    const auto dirtyCount = static_cast<uint32_t>(static_cast<float>(nodeCount) * fraction);
+    std::vector<uint32_t> dirty(dirtyCount);
+    double seconds = 0.0;
+    size_t partial = 0;
+    for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+        for (auto &node : dirty)
+            node = random() % nodeCount;
+        seconds += measure(1, [&]() {
+            for (const auto node : dirty)
+                hierarchy.setPosition(nodes[node], hierarchy.getPosition(nodes[node]));
+            partial += hierarchy.update();
+        });
+    }
+    report(fmt::format("hierarchy, {:.1f}% moved", fraction * 100.0f), partial / iterations, iterations, seconds);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <VixenEngine.h>
+#include <UploadManager.h>
+
+namespace {
+    const Vixen::Logger logger{"UploadThroughputBenchmark"};
+
+    /**
+     * Parses a whole number of at least a minimum, throws when the value is not such a number
+     */
+    uint32_t parseCount(const std::string &argument, const std::string &value, uint32_t minimum) {
+        size_t end = 0;
+        long long count = -1;
+        try {
+            count = std::stoll(value, &end);
+        } catch (const std::invalid_argument &) {
+        } catch (const std::out_of_range &) {
+        }
+        /// stoll stops at the first character that is not a digit, the whole value has to be the number
+        if (end != value.size() || count < minimum || count > std::numeric_limits<uint32_t>::max())
+            throw std::runtime_error(fmt::format("{} expects a whole number of at least {}, got \"{}\"", argument,
+                                                 minimum, value));
+        return static_cast<uint32_t>(count);
+    }
+
+    template<typename F>
+    double measure(uint32_t iterations, F &&function) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++)
+            function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void report(const std::string &path, VkDeviceSize size, uint32_t iterations, double seconds) {
+        const double mebibytes = static_cast<double>(size) * iterations / (1024.0 * 1024.0);
+        logger.info("  {:<24} {:10.1f} MiB/s  {:9.2f}us per upload", path, mebibytes / std::max(seconds, 1e-9),
+                    seconds * 1e6 / iterations);
+    }
+
+    const char *describe(const Vixen::Buffer &buffer) {
+        const auto flags = buffer.getMemoryFlags();
+        if ((flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) && (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+            return "host visible device memory";
+        if (flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+            return "device memory";
+        return "host memory";
+    }
+}
+
+/**
+ * Compares the ways data reaches the GPU: writing host memory the GPU reads over the bus, writing host visible device
+ * memory directly, copying through a staging buffer on the transfer queue and letting the upload manager choose. Direct
+ * writes only measure the host, their results are visible to the next submission without any GPU work.
+ */
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+
+    uint32_t iterations = 256;
+    try {
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            if (argument != "--iterations")
+                throw std::runtime_error(fmt::format("Unknown argument \"{}\"", argument));
+            if (i + 1 >= argc)
+                throw std::runtime_error(fmt::format("{} misses its value", argument));
+            iterations = parseCount(argument, argv[++i], 1);
+        }
+    } catch (const std::runtime_error &error) {
+        logger.error("{}", error.what());
+        logger.error("Usage: {} [--iterations <count>]", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const auto window = std::make_shared<Vixen::Window>("Vixen Upload Throughput Benchmark", "../../icon.png");
+    const auto instance = std::make_shared<Vixen::Instance>(window, "Vixen Upload Throughput Benchmark",
+                                                            glm::ivec3(0, 0, 1));
+    const auto physicalDevice = std::make_shared<Vixen::PhysicalDevice>(instance);
+    const auto device = std::make_shared<Vixen::LogicalDevice>(instance, window, physicalDevice);
+    Vixen::UploadManager uploader(device);
+
+    logger.info("{}: {}", physicalDevice->deviceProperties.deviceName,
+                device->mappableDeviceMemory ? "all device memory is host visible"
+                                             : device->hostVisibleDeviceMemory
+                                               ? "part of device memory is host visible"
+                                               : "no device memory is host visible");
+
+    for (const VkDeviceSize size : {4 * 1024ull, 64 * 1024ull, 256 * 1024ull, 4 * 1024 * 1024ull}) {
+        const std::vector<uint8_t> data(size, 0x5a);
+        logger.info("{} KiB uploads", size / 1024);
+
+        Vixen::Buffer host(device, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+        report("host memory", size, iterations, measure(iterations, [&]() {
+            memcpy(host.map(), data.data(), size);
+            host.unmap();
+        }));
+
+        Vixen::Buffer dynamic(device, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        if (dynamic.getMemoryFlags() & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+            report("direct device write", size, iterations, measure(iterations, [&]() {
+                memcpy(dynamic.map(), data.data(), size);
+                dynamic.unmap();
+            }));
+        else
+            logger.info("  {:<24} unavailable, dynamic buffers fall back to {}", "direct device write",
+                        describe(dynamic));
+
+        Vixen::Buffer staging(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+        Vixen::Buffer destination(device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+        report("staged copy", size, iterations, measure(iterations, [&]() {
+            memcpy(staging.map(), data.data(), size);
+            staging.unmap();
+
+            /// The transfer pool is transient, so every copy records a new command buffer like the engine does
+            VkBufferCopy region{};
+            region.size = size;
+            Vixen::CommandBuffer transfer(device, Vixen::QueueType::TRANSFER);
+            transfer.recordSingleUsage().cmdCopyBuffer(staging.getBuffer(), destination.getBuffer(), {region});
+            transfer.submit();
+            transfer.wait();
+        }));
+
+        report(fmt::format("upload manager ({})", describe(destination)), size, iterations,
+               measure(iterations, [&]() {
+                   uploader.upload(destination, data.data(), size);
+                   uploader.wait(uploader.flush());
+               }));
+    }
+
+    device->waitIdle();
+    return EXIT_SUCCESS;
+}
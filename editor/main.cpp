@@ -1,4 +1,8 @@
+#include <filesystem>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <string_view>
 #include <VixenEngine.h>
 
 inline constexpr int VIXEN_TEST_VERSION_MAJOR = 0;
@@ -6,6 +10,30 @@ inline constexpr int VIXEN_TEST_VERSION_MINOR = 0;
 inline constexpr int VIXEN_TEST_VERSION_PATCH = 1;
 inline constexpr const char* VIXEN_EDITOR_NAME = "Vixen Editor";
 
+/**
+ * Adds the models to the scene as they become resident, the crystal is requested first so it shows up first
+ */
+Vixen::Task<> populate(Vixen::AssetManager &assets, Vixen::Scene &scene, Vixen::Entity &spinning) {
+    const auto crystal = assets.loadMesh("../../editor/models/crystal/Crystal.fbx", Vixen::AssetPriority::HIGH);
+    const auto ruby = assets.loadMesh("../../editor/models/ruby_rose/Mesh/rubySkel_v001_002.fbx");
+    //const auto fox = assets.loadMesh("../../editor/models/fox/Fox.fbx", Vixen::AssetPriority::LOW);
+    //const auto michiru = assets.loadMesh("../../editor/models/michiru/Meshes/MichiruSkel_v001_002.fbx",
+    //                                     Vixen::AssetPriority::LOW);
+
+    spinning = scene.world.create(Vixen::Transform{scene.transforms.create()},
+                                  Vixen::MeshRenderer{(co_await crystal)->meshes[0]});
+    scene.revision++;
+
+    /// The meshes of the model hang off a shared node, scaling it scales the whole model
+    const auto rubyRoot = scene.transforms.create({}, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(0.01f));
+    for (const auto &mesh : (co_await ruby)->meshes) {
+        const auto node = scene.transforms.create({}, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f), rubyRoot);
+        scene.world.create(Vixen::Transform{node}, Vixen::MeshRenderer{mesh}, Vixen::Static{});
+    }
+    scene.revision++;
+    scene.staticRevision++;
+}
+
 int main() {
     spdlog::set_level(spdlog::level::trace);
     Vixen::Logger logger = Vixen::Logger(VIXEN_EDITOR_NAME);
@@ -20,38 +48,29 @@ int main() {
 
     std::unique_ptr<Vixen::Input> input(new Vixen::Input(window));
 
-    const auto meshStore = std::make_unique<Vixen::MeshStore>(logicalDevice, physicalDevice);
-    meshStore->loadMesh("../../editor/models/fox/Fox.fbx");
-    meshStore->loadMesh("../../editor/models/crystal/Crystal.fbx");
-    //meshStore->loadMesh("../../editor/models/michiru/Meshes/MichiruSkel_v001_002.fbx");
-    meshStore->loadMesh("../../editor/models/ruby_rose/Mesh/rubySkel_v001_002.fbx");
+    /// Shared by asset loading and the per frame work, the job timings are logged every second
+    const auto jobs = std::make_shared<Vixen::JobSystem>();
+    jobs->setProfiling(true);
+
+    const auto assets = std::make_unique<Vixen::AssetManager>(logicalDevice, physicalDevice, "cache", jobs);
+    /// Built with "bundler --root ../../editor assets.vxbundle <models>", replaces the loose model files
+    if (std::filesystem::exists("assets.vxbundle"))
+        assets->mount("assets.vxbundle", "../../editor");
 
     Vixen::Scene scene{};
     scene.camera.position = {0, 0, 3};
-    // Fox
-    //scene.entities.push_back(Vixen::Entity(meshStore->meshes[0], {}, {}, 0.01f));
-    //scene.entities.push_back(Vixen::Entity(meshStore->meshes[1], {}, {}, 0.01f));
-
-    // Crystal
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[2], {}, {}, 1.0f));
-
-    // Michiru
-    //scene.entities.push_back(Vixen::Entity(meshStore->meshes[4], {}, {}, 0.01f));
-    //scene.entities.push_back(Vixen::Entity(meshStore->meshes[5], {}, {}, 0.01f));
-
-    // Ruby
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[3], {}, {}, 0.01f));
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[4], {}, {}, 0.01f));
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[5], {}, {}, 0.01f));
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[6], {}, {}, 0.01f));
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[7], {}, {}, 0.01f));
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[8], {}, {}, 0.01f));
-    scene.entities.push_back(Vixen::Entity(meshStore->meshes[9], {}, {}, 0.01f));
-
-    std::unique_ptr<Vixen::Render> render(new Vixen::Render(
+    Vixen::Entity spinning{};
+    const auto loading = populate(*assets, scene, spinning);
+
+    scene.sun = Vixen::DirectionalLight({-0.4f, -1.0f, -0.3f}, {1.0f, 0.95f, 0.9f}, 0.8f);
+    scene.lights.emplace_back(glm::vec3{2.0f, 2.0f, 2.0f}, 10.0f, glm::vec3{1.0f, 0.9f, 0.8f}, 8.0f);
+    scene.lights.emplace_back(glm::vec3{-2.0f, 1.0f, -1.0f}, 6.0f, glm::vec3{0.4f, 0.5f, 1.0f}, 4.0f);
+
+    /// Draws the snapshot of the previous frame while the next frame is simulated
+    Vixen::RenderThread renderThread(
             logicalDevice,
             physicalDevice,
-            scene,
+            scene.camera,
             Vixen::Shader::Builder()
                     .addModule(Vixen::ShaderModule::Builder(logicalDevice)
                                        .setShaderStage(VK_SHADER_STAGE_VERTEX_BIT)
@@ -61,35 +80,77 @@ int main() {
                                        .setShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT)
                                        .setBytecode("frag.spv")
                                        .build())
-                    .addAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0)
-                    .addAttribute(1, 1, VK_FORMAT_R32G32_SFLOAT, 0)
-                    .addAttribute(2, 2, VK_FORMAT_R32G32B32A32_SFLOAT, 0)
-                    .addBinding(0, VK_VERTEX_INPUT_RATE_VERTEX, sizeof(glm::vec3))
-                    .addBinding(1, VK_VERTEX_INPUT_RATE_VERTEX, sizeof(glm::vec2))
-                    .addBinding(2, VK_VERTEX_INPUT_RATE_VERTEX, sizeof(glm::vec4))
-                    .addDescriptor(0, 3 * sizeof(glm::mat4), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+                    .addDescriptor(0, 2 * sizeof(glm::mat4), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                   VK_SHADER_STAGE_VERTEX_BIT)
                     .addDescriptor(1, 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                                    VK_SHADER_STAGE_FRAGMENT_BIT)
-                    .build()));
+                    .addDescriptor(2, 2 * sizeof(glm::mat4), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                   VK_SHADER_STAGE_VERTEX_BIT)
+                    .build());
 
-    int fps = 0;
+    /// The scene is simulated at 60 ticks per second and rendered in between, the camera follows the frame rate
+    Vixen::MainLoop loop;
+    const auto statistics = renderThread.getStatistics();
     double lastTime = 0;
     while (!window->shouldClose()) {
-        scene.entities[0].rotation.y += 5 * static_cast<float>(render->getDeltaTime());
-
         window->update();
+        if (assets->update() > 0)
+            scene.revision++;
+        if (loading.isDone())
+            loading.get();
+
+        const float alpha = loop.frame([&](double timestep) {
+            if (scene.world.isAlive(spinning)) {
+                const auto node = scene.world.get<Vixen::Transform>(spinning).node;
+                const float angle = glm::radians(5 * static_cast<float>(timestep));
+                scene.transforms.setRotation(node, scene.transforms.getRotation(node) *
+                                                   glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+            }
+            scene.transforms.update(jobs.get());
+        });
 
-        input->update(scene.camera, render->getDeltaTime());
-        render->render(scene.camera);
+        input->update(scene.camera, loop.getFrameTime());
+        renderThread.submit(scene, alpha);
 
         double currentTime = glfwGetTime();
-        fps++;
         if (currentTime - lastTime >= 1.0) {
-            logger.info("FPS: {}", fps);
-            fps = 0;
+            /// Snapshots still waiting to be drawn reference the geometry before it moves, so they are drawn first.
+            /// Waiting for them stalls the pipelining, which is why this only happens once a second.
+            renderThread.synchronize();
+            if (assets->defragment() > 0)
+                scene.revision++;
+
+            VkDeviceSize usage = 0;
+            VkDeviceSize budget = 0;
+            for (const auto &heap : logicalDevice->getHeapBudgets()) {
+                if (heap.deviceLocal) {
+                    usage += heap.usage;
+                    budget += heap.budget;
+                }
+            }
+            /// Percentiles of the frames kept, the 1% low is the frame rate of the slowest percent of the intervals
+            const auto frames = statistics->report();
+            logger.info("Frame time over {} frames: p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms, "
+                        "1% low {:.0f} FPS, {} hitches", frames.frames, frames.present.median, frames.present.p95,
+                        frames.present.p99, frames.present.max, 1000.0 / frames.present.onePercentLow,
+                        frames.hitches);
+            logger.info("CPU p95 {:.2f}ms, GPU p95 {:.2f}ms, using {} of {} MiB of device memory", frames.cpu.p95,
+                        frames.gpu.p95, usage / (1024 * 1024), budget / (1024 * 1024));
+
+            std::map<std::string_view, std::pair<size_t, std::chrono::nanoseconds>> jobTimes;
+            for (const auto &timing : jobs->collectTimings()) {
+                auto &[count, total] = jobTimes[timing.name];
+                count++;
+                total += timing.duration;
+            }
+            for (const auto &[name, time] : jobTimes)
+                logger.debug("{}: {} jobs, {:.2f}ms", name, time.first, static_cast<double>(time.second.count()) / 1e6);
             lastTime = currentTime;
         }
     }
 
+    std::ofstream("memory.json") << logicalDevice->dumpMemoryStatistics(true);
+    std::ofstream frames("frames.csv");
+    statistics->writeCsv(frames);
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 position;
+
+layout(push_constant) uniform Cascade {
+    mat4 modelViewProjection;
+} cascade;
+
+void main() {
+    gl_Position = cascade.modelViewProjection * vec4(position, 1.0);
+}
@@ -1,13 +1,95 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+#define MAX_LIGHTS_PER_CLUSTER 256
+#define CASCADE_COUNT 4
+
+struct PointLight {
+    vec3 position;
+    float radius;
+    vec3 color;
+    float intensity;
+};
+
 layout(location = 0) in vec2 uv;
 layout(location = 1) in vec4 color;
+layout(location = 2) in vec3 viewPosition;
+layout(location = 3) in vec3 viewNormal;
+layout(location = 4) in vec3 worldPosition;
 
 layout(location = 0) out vec4 outColor;
 
 layout(binding = 1) uniform sampler2D tex;
 
+layout(set = 1, binding = 0) uniform ClusterParameters {
+    mat4 inverseProjection;
+    mat4 view;
+    uvec4 gridSize;
+    vec4 screen;
+    vec4 planes;
+} parameters;
+
+layout(std430, set = 1, binding = 1) readonly buffer Lights {
+    PointLight lights[];
+};
+
+layout(std430, set = 1, binding = 3) readonly buffer LightGrid {
+    uint lightCounts[];
+};
+
+layout(std430, set = 1, binding = 4) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+layout(set = 2, binding = 0) uniform ShadowParameters {
+    mat4 cascades[CASCADE_COUNT];
+    vec4 direction;
+    vec4 color;
+} sun;
+
+layout(set = 2, binding = 1) uniform sampler2DArrayShadow shadowMap;
+
+const vec3 ambient = vec3(0.15);
+
+uint clusterIndex() {
+    float depth = -viewPosition.z;
+    uint slice = uint(max(log(depth) * parameters.planes.z + parameters.planes.w, 0.0));
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / parameters.screen.xy), parameters.gridSize.xy - 1);
+
+    return tile.x + tile.y * parameters.gridSize.x +
+           min(slice, parameters.gridSize.z - 1) * parameters.gridSize.x * parameters.gridSize.y;
+}
+
+/// Cached cascades may cover a different area than their slice, so use the first cascade that contains the fragment
+float shadow() {
+    for (int i = 0; i < CASCADE_COUNT; i++) {
+        vec4 projected = sun.cascades[i] * vec4(worldPosition, 1.0);
+        vec3 coordinate = vec3(projected.xy * 0.5 + 0.5, projected.z);
+        if (all(greaterThan(coordinate, vec3(0.0))) && all(lessThan(coordinate, vec3(1.0))))
+            return texture(shadowMap, vec4(coordinate.xy, i, coordinate.z));
+    }
+
+    return 1.0;
+}
+
 void main() {
-    outColor = color * texture(tex, uv);
-}
\ No newline at end of file
+    vec3 normal = normalize(viewNormal);
+    vec3 lighting = ambient + sun.color.rgb * max(dot(normal, normalize(sun.direction.xyz)), 0.0) * shadow();
+
+    uint cluster = clusterIndex();
+    uint count = lightCounts[cluster];
+    for (uint i = 0; i < count; i++) {
+        PointLight light = lights[lightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
+
+        vec3 toLight = (parameters.view * vec4(light.position, 1.0)).xyz - viewPosition;
+        float distance = length(toLight);
+        float ratio = distance / light.radius;
+        float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+        float attenuation = window * window / (distance * distance + 1.0);
+
+        lighting += light.color * light.intensity * attenuation * max(dot(normal, toLight / distance), 0.0);
+    }
+
+    vec4 albedo = color * texture(tex, uv);
+    outColor = vec4(albedo.rgb * lighting, albedo.a);
+}
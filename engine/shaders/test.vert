@@ -4,18 +4,50 @@
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec2 uv;
 layout(location = 2) in vec4 color;
+/// Octahedral encoded
+layout(location = 3) in vec2 normal;
 
 layout(location = 0) out vec2 outUv;
 layout(location = 1) out vec4 outColor;
+layout(location = 2) out vec3 outViewPosition;
+layout(location = 3) out vec3 outViewNormal;
+layout(location = 4) out vec3 outWorldPosition;
 
-layout(binding = 0) uniform ModelViewProjection {
+/// Allocated per draw from the frame allocator
+layout(binding = 0) uniform Draw {
     mat4 model;
+    /// The inverse transpose of the model matrix, normals stay perpendicular under non-uniform scale
+    mat4 normal;
+} draw;
+
+/// Allocated once per frame and shared by every draw
+layout(binding = 2) uniform Frame {
     mat4 view;
     mat4 projection;
-} mvp;
+} frame;
+
+/// Maps quantized positions back to model space
+layout(push_constant) uniform Mesh {
+    mat4 dequantization;
+} mesh;
+
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
 
 void main() {
+    vec4 worldPosition = draw.model * mesh.dequantization * vec4(position, 1.0);
+    vec4 viewPosition = frame.view * worldPosition;
+
     outUv = uv;
     outColor = color;
-    gl_Position = mvp.projection * mvp.view * mvp.model * vec4(position, 1.0);
-}
\ No newline at end of file
+    outViewPosition = viewPosition.xyz;
+    /// The view is rigid, so it rotates normals as is, the fragment shader normalizes them again
+    outViewNormal = mat3(frame.view) * (mat3(draw.normal) * decodeOctahedral(normal));
+    outWorldPosition = worldPosition.xyz;
+    gl_Position = frame.projection * viewPosition;
+}
@@ -0,0 +1,125 @@
+#include "AssetCache.h"
+#include <fstream>
+
+namespace Vixen {
+    uint64_t AssetCache::hash(const void *data, size_t size, uint64_t seed) {
+        const auto bytes = static_cast<const uint8_t *>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    std::shared_ptr<ImageView> AssetCache::getTexture(const std::filesystem::path &path,
+                                                      const std::function<std::shared_ptr<ImageView>(
+                                                              const std::filesystem::path &)> &load) {
+        const auto canonical = std::filesystem::canonical(path);
+        return getTexture(getContentKey(canonical), [&]() { return load(canonical); });
+    }
+
+    std::shared_ptr<ImageView> AssetCache::getTexture(uint64_t key,
+                                                      const std::function<std::shared_ptr<ImageView>()> &create) {
+        {
+            std::scoped_lock lock(mutex);
+            if (const auto texture = textures.find(key); texture != textures.end()) {
+                textureStatistics.hits++;
+                return texture->second;
+            }
+            textureStatistics.misses++;
+        }
+
+        auto texture = create();
+        std::scoped_lock lock(mutex);
+        /// Another thread may have created the same texture in the meantime, keep the first one
+        return textures.emplace(key, texture).first->second;
+    }
+
+    uint64_t AssetCache::getContentKey(const std::filesystem::path &path) {
+        return hashFile(std::filesystem::canonical(path));
+    }
+
+    bool AssetCache::containsTexture(uint64_t key) const {
+        std::scoped_lock lock(mutex);
+        return textures.contains(key);
+    }
+
+    std::shared_ptr<Mesh> AssetCache::getMesh(uint64_t key, const std::function<std::shared_ptr<Mesh>()> &create) {
+        {
+            std::scoped_lock lock(mutex);
+            if (const auto mesh = meshes.find(key); mesh != meshes.end()) {
+                meshStatistics.hits++;
+                return mesh->second;
+            }
+            meshStatistics.misses++;
+        }
+
+        auto mesh = create();
+        std::scoped_lock lock(mutex);
+        return meshes.emplace(key, mesh).first->second;
+    }
+
+    std::vector<std::shared_ptr<ImageView>> AssetCache::getTextures() const {
+        std::scoped_lock lock(mutex);
+        std::vector<std::shared_ptr<ImageView>> snapshot;
+        snapshot.reserve(textures.size());
+        for (const auto &[key, texture] : textures)
+            snapshot.push_back(texture);
+        return snapshot;
+    }
+
+    std::vector<std::shared_ptr<Mesh>> AssetCache::getMeshes() const {
+        std::scoped_lock lock(mutex);
+        std::vector<std::shared_ptr<Mesh>> snapshot;
+        snapshot.reserve(meshes.size());
+        for (const auto &[key, mesh] : meshes)
+            snapshot.push_back(mesh);
+        return snapshot;
+    }
+
+    void AssetCache::clear() {
+        {
+            std::scoped_lock lock(mutex);
+            textures.clear();
+            meshes.clear();
+        }
+        logger.trace("Cleared asset cache");
+    }
+
+    AssetCache::Statistics AssetCache::getTextureStatistics() const {
+        std::scoped_lock lock(mutex);
+        return textureStatistics;
+    }
+
+    AssetCache::Statistics AssetCache::getMeshStatistics() const {
+        std::scoped_lock lock(mutex);
+        return meshStatistics;
+    }
+
+    uint64_t AssetCache::hashFile(const std::filesystem::path &path) {
+        const auto modified = std::filesystem::last_write_time(path);
+        const auto size = std::filesystem::file_size(path);
+        {
+            std::scoped_lock lock(mutex);
+            const auto &entry = files.find(path.string());
+            if (entry != files.end() && entry->second.modified == modified && entry->second.size == size)
+                return entry->second.hash;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Failed to open file for hashing");
+
+        uint64_t hash = 0xcbf29ce484222325;
+        std::vector<char> buffer(64 * 1024);
+        while (file) {
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            hash = AssetCache::hash(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+        }
+
+        std::scoped_lock lock(mutex);
+        files[path.string()] = {modified, size, hash};
+        return hash;
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Logger.h"
+#include "ImageView.h"
+#include "Mesh.h"
+
+namespace Vixen {
+    /**
+     * A content addressed cache for textures and meshes. Textures are looked up by canonical path first and by the hash
+     * of the file contents second, so the same file referenced through different paths or copied under another name is
+     * only decoded and uploaded once. Meshes are looked up by the hash of their vertex and index data. Lookups are
+     * thread safe, the load and create callbacks run on the calling thread without holding the lock.
+     */
+    class AssetCache {
+        const Logger logger{"AssetCache"};
+
+    public:
+        struct Statistics {
+            uint64_t hits = 0;
+
+            uint64_t misses = 0;
+
+            [[nodiscard]] double hitRate() const {
+                return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+            }
+        };
+
+        /**
+         * Computes the 64-bit FNV-1a hash of a block of memory, pass a previous hash as seed to hash several blocks
+         */
+        static uint64_t hash(const void *data, size_t size, uint64_t seed = 0xcbf29ce484222325);
+
+        template<typename T>
+        static uint64_t hash(const std::vector<T> &data, uint64_t seed = 0xcbf29ce484222325) {
+            return hash(data.data(), data.size() * sizeof(T), seed);
+        }
+
+        /**
+         * Returns the cached texture for a file or loads it
+         *
+         * @param[in] path The path of the texture file
+         * @param[in] load Called with the canonical path when the texture is not cached yet
+         */
+        std::shared_ptr<ImageView> getTexture(const std::filesystem::path &path,
+                                              const std::function<std::shared_ptr<ImageView>(
+                                                      const std::filesystem::path &)> &load);
+
+        /**
+         * Returns the cached texture for a content key or creates it
+         *
+         * @param[in] key The content key of the texture file, see getContentKey
+         * @param[in] create Called when no texture with the same content is cached yet
+         */
+        std::shared_ptr<ImageView> getTexture(uint64_t key, const std::function<std::shared_ptr<ImageView>()> &create);
+
+        /**
+         * The content key of a file, the file is only read again when its size or modification time changed
+         */
+        uint64_t getContentKey(const std::filesystem::path &path);
+
+        [[nodiscard]] bool containsTexture(uint64_t key) const;
+
+        /**
+         * Returns the cached mesh for a content hash or creates it
+         *
+         * @param[in] key The hash of every attribute, the indices and the texture of the mesh
+         * @param[in] create Called when no mesh with the same content is cached yet
+         */
+        std::shared_ptr<Mesh> getMesh(uint64_t key, const std::function<std::shared_ptr<Mesh>()> &create);
+
+        /**
+         * Every cached texture at the time of the call
+         */
+        [[nodiscard]] std::vector<std::shared_ptr<ImageView>> getTextures() const;
+
+        /**
+         * Every cached mesh at the time of the call
+         */
+        [[nodiscard]] std::vector<std::shared_ptr<Mesh>> getMeshes() const;
+
+        /**
+         * Releases every cached asset, assets still referenced elsewhere stay alive
+         */
+        void clear();
+
+        [[nodiscard]] Statistics getTextureStatistics() const;
+
+        [[nodiscard]] Statistics getMeshStatistics() const;
+
+    private:
+        struct FileEntry {
+            std::filesystem::file_time_type modified;
+
+            uintmax_t size;
+
+            uint64_t hash;
+        };
+
+        /// The content hash of every file seen so far, reused as long as the file is not modified
+        std::unordered_map<std::string, FileEntry> files;
+
+        std::unordered_map<uint64_t, std::shared_ptr<ImageView>> textures;
+
+        std::unordered_map<uint64_t, std::shared_ptr<Mesh>> meshes;
+
+        Statistics textureStatistics{};
+
+        Statistics meshStatistics{};
+
+        mutable std::mutex mutex;
+
+        uint64_t hashFile(const std::filesystem::path &path);
+    };
+}
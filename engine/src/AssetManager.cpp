@@ -0,0 +1,671 @@
+#include "AssetManager.h"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace Vixen {
+    namespace {
+        /// Hashing the packed data gives a cached mesh the same key as a freshly imported and packed one
+        uint64_t hashMesh(const VertexLayout &layout, const uint8_t *packed, VkDeviceSize size) {
+            const uint32_t encoded = layout.encode();
+            return AssetCache::hash(&encoded, sizeof(encoded), AssetCache::hash(packed, size));
+        }
+    }
+
+    AssetManager::AssetManager(std::shared_ptr<LogicalDevice> logicalDevice,
+                               std::shared_ptr<PhysicalDevice> physicalDevice, std::filesystem::path cacheDirectory,
+                               std::shared_ptr<JobSystem> jobSystem)
+            : logicalDevice(std::move(logicalDevice)),
+              physicalDevice(std::move(physicalDevice)),
+              cacheDirectory(std::move(cacheDirectory)),
+              arena(std::make_shared<GeometryArena>(this->logicalDevice)),
+              uploader(this->logicalDevice),
+              jobSystem(jobSystem ? std::move(jobSystem) : std::make_shared<JobSystem>()) {
+        static constexpr uint8_t white[4]{0xFF, 0xFF, 0xFF, 0xFF};
+        placeholderTexture = std::make_shared<ImageView>(
+                Image::from(uploader, ImageData{VK_FORMAT_R8G8B8A8_SRGB, 1, 1, {0},
+                                       std::shared_ptr<const uint8_t>(white, [](const uint8_t *) {}), sizeof(white)}),
+                VK_IMAGE_ASPECT_COLOR_BIT);
+        uploader.flush();
+    }
+
+    AssetManager::~AssetManager() {
+        stopping = true;
+
+        /// The job system may outlive the manager, the jobs still referencing it have to finish first
+        std::vector<JobHandle> pending;
+        {
+            std::scoped_lock lock(jobMutex);
+            pending.swap(running);
+        }
+        jobSystem->wait(pending);
+    }
+
+    void AssetManager::mount(const std::filesystem::path &path, const std::filesystem::path &root) {
+        auto bundle = std::make_shared<const Bundle>(path);
+        logger.info("Mounted bundle \"{}\" with {} assets", path.string(), bundle->getEntries().size());
+
+        std::scoped_lock lock(mutex);
+        bundles.push_back({std::move(bundle), root.lexically_normal()});
+    }
+
+    AssetHandle<Model> AssetManager::loadMesh(const std::string &path, AssetPriority priority) {
+        auto import = std::make_shared<ModelImport>();
+        {
+            std::scoped_lock lock(mutex);
+            if (const auto &model = models.find(path); model != models.end()) {
+                const auto status = model->second->status.load();
+                if (status == AssetStatus::LOADING || status == AssetStatus::RESIDENT)
+                    return AssetHandle<Model>(model->second);
+            }
+
+            import->state = std::make_shared<ModelState>();
+            import->state->value = placeholderModel;
+            models[path] = import->state;
+        }
+        import->path = path;
+        import->priority = priority;
+
+        enqueue(priority, [this, import]() {
+            importModel(import);
+        });
+        return AssetHandle<Model>(import->state);
+    }
+
+    AssetHandle<ImageView> AssetManager::loadTexture(const std::string &path, AssetPriority priority) {
+        return AssetHandle<ImageView>(requestTexture(path, priority));
+    }
+
+    size_t AssetManager::update() {
+        uploader.poll();
+
+        if (relocation.has_value() && relocation->commandBuffer->isComplete()) {
+            for (const auto &[vertices, indices] : relocation->ranges) {
+                arena->freeVertices(vertices);
+                arena->freeIndices(indices);
+            }
+            relocation.reset();
+
+            if (const VkDeviceSize released = arena->trim(); released > 0)
+                logger.trace("Released {} bytes of geometry", released);
+        }
+
+        std::vector<std::function<void()>> finished;
+        {
+            std::scoped_lock lock(mutex);
+            finished.swap(completions);
+        }
+        for (const auto &finish : finished)
+            finish();
+
+        if (publications.empty())
+            return 0;
+
+        /// Everything created above is usable by graphics work submitted after this flush
+        uploader.flush();
+
+        std::vector<std::function<void()>> published;
+        published.swap(publications);
+        for (const auto &publish : published)
+            publish();
+        return published.size();
+    }
+
+    size_t AssetManager::defragment(VkDeviceSize maxBytes) {
+        if (relocation.has_value())
+            return 0;
+
+        auto commandBuffer = std::make_unique<CommandBuffer>(logicalDevice, QueueType::GRAPHICS);
+        commandBuffer->recordSingleUsage();
+
+        Relocation moved;
+        VkDeviceSize bytes = 0;
+        const size_t count = compactMeshes(*commandBuffer, moved, bytes, maxBytes) +
+                             relocateTextures(*commandBuffer, moved, bytes, maxBytes);
+        if (count == 0) {
+            commandBuffer->stop();
+            return 0;
+        }
+
+        commandBuffer->submit();
+        moved.commandBuffer = std::move(commandBuffer);
+        relocation = std::move(moved);
+        logger.trace("Defragmenting moved {} assets ({} bytes)", count, bytes);
+        return count;
+    }
+
+    size_t AssetManager::compactMeshes(CommandBuffer &commandBuffer, Relocation &moved, VkDeviceSize &bytes,
+                                       VkDeviceSize maxBytes) {
+        if (!arena->isFragmented() || arena->getUsed() == compactedUsage)
+            return 0;
+
+        auto meshes = cache.getMeshes();
+        std::sort(meshes.begin(), meshes.end(), [](const auto &a, const auto &b) {
+            const auto &first = a->getVertexRange();
+            const auto &second = b->getVertexRange();
+            return first.block != second.block ? first.block > second.block : first.offset > second.offset;
+        });
+
+        /// The free ranges may have been read by earlier frames, and the copies read what the uploads wrote
+        commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, {});
+
+        size_t count = 0;
+        for (const auto &mesh : meshes) {
+            if (bytes >= maxBytes)
+                break;
+
+            const auto previous = mesh->relocate(commandBuffer);
+            if (previous.first.size == 0 && previous.second.size == 0)
+                continue;
+
+            bytes += previous.first.size + previous.second.size;
+            moved.ranges.push_back(previous);
+            count++;
+        }
+
+        if (count == 0) {
+            compactedUsage = arena->getUsed();
+            return 0;
+        }
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_TRANSFER_READ_BIT;
+        commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                         VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                                         {barrier}, {}, {});
+        return count;
+    }
+
+    size_t AssetManager::relocateTextures(CommandBuffer &commandBuffer, Relocation &moved, VkDeviceSize &bytes,
+                                          VkDeviceSize maxBytes) {
+        if (bytes >= maxBytes)
+            return 0;
+
+        /// Blocks holding a single texture are skipped, those are mostly dedicated allocations that would only move
+        /// into another dedicated allocation
+        const auto textures = cache.getTextures();
+        std::unordered_map<VkDeviceMemory, size_t> blocks;
+        for (const auto &texture : textures)
+            blocks[texture->getMemory()]++;
+        if (blocks.size() < 2)
+            return 0;
+
+        VkDeviceMemory sparsest = VK_NULL_HANDLE;
+        VkDeviceSize sparsestUsage = std::numeric_limits<VkDeviceSize>::max();
+        for (const auto &[memory, count] : blocks) {
+            const VkDeviceSize usage = logicalDevice->memoryStatistics.getBlockUsage(memory);
+            if (count > 1 && usage < sparsestUsage) {
+                sparsest = memory;
+                sparsestUsage = usage;
+            }
+        }
+        if (sparsest == VK_NULL_HANDLE || settledBlock == std::make_pair(sparsest, sparsestUsage))
+            return 0;
+
+        size_t count = 0;
+        for (const auto &texture : textures) {
+            if (bytes >= maxBytes)
+                break;
+            if (texture->getMemory() != sparsest)
+                continue;
+
+            bytes += texture->getAllocationSize();
+            moved.images.push_back(texture->relocate(commandBuffer));
+            count++;
+            /// The allocator placed it in the same block again, the remaining textures would not leave it either
+            if (texture->getMemory() == sparsest) {
+                /// Compared against the usage once the previous allocation has been released
+                settledBlock = {sparsest, logicalDevice->memoryStatistics.getBlockUsage(sparsest) -
+                                          moved.images.back()->getAllocationSize()};
+                break;
+            }
+        }
+        return count;
+    }
+
+    size_t AssetManager::getQueuedCount() {
+        std::scoped_lock lock(jobMutex);
+        return jobs.size();
+    }
+
+    const std::shared_ptr<ImageView> &AssetManager::getPlaceholderTexture() const {
+        return placeholderTexture;
+    }
+
+    const AssetCache &AssetManager::getCache() const {
+        return cache;
+    }
+
+    const std::shared_ptr<GeometryArena> &AssetManager::getArena() const {
+        return arena;
+    }
+
+    void AssetManager::enqueue(AssetPriority priority, std::function<void()> work) {
+        std::scoped_lock lock(jobMutex);
+        jobs.push({priority, sequence++, std::move(work)});
+        std::erase_if(running, [](const JobHandle &job) {
+            return job.isDone();
+        });
+        /// Jobs of the job system run in no particular order, every one of them picks the most important asset job
+        /// at that time
+        running.push_back(jobSystem->schedule("Asset job", [this]() {
+            runNext();
+        }));
+    }
+
+    void AssetManager::runNext() {
+        std::function<void()> work;
+        {
+            std::scoped_lock lock(jobMutex);
+            if (jobs.empty())
+                return;
+
+            work = jobs.top().work;
+            jobs.pop();
+        }
+
+        if (stopping)
+            return;
+
+        try {
+            work();
+        } catch (std::exception &error) {
+            logger.error("Asset job failed ({})", error.what());
+        }
+    }
+
+    void AssetManager::complete(std::function<void()> finish) {
+        std::scoped_lock lock(mutex);
+        completions.push_back(std::move(finish));
+    }
+
+    std::shared_ptr<AssetManager::TextureState>
+    AssetManager::requestTexture(const std::filesystem::path &path, AssetPriority priority) {
+        const auto key = path.lexically_normal().string();
+        auto state = std::make_shared<TextureState>();
+        state->value = placeholderTexture;
+        {
+            std::scoped_lock lock(mutex);
+            if (const auto &texture = textures.find(key); texture != textures.end()) {
+                const auto status = texture->second.state->status.load();
+                if (status == AssetStatus::LOADING || status == AssetStatus::RESIDENT)
+                    return texture->second.state;
+            }
+            textures[key] = {state, {}};
+        }
+
+        enqueue(priority, [this, key, state]() {
+            if (state->cancelled) {
+                complete([this, state]() {
+                    publications.emplace_back([state]() {
+                        resolve(*state, std::shared_ptr<ImageView>(), AssetStatus::CANCELLED);
+                    });
+                });
+                return;
+            }
+
+            auto decoded = decodeTexture(key);
+            complete([this, key, state, decoded = std::move(decoded)]() mutable {
+                createTexture(key, state, decoded);
+            });
+        });
+        return state;
+    }
+
+    void AssetManager::importModel(const std::shared_ptr<ModelImport> &import) {
+        if (import->state->cancelled) {
+            complete([this, import]() {
+                createModel(*import);
+            });
+            return;
+        }
+
+        if (importBundled(import))
+            return;
+
+        try {
+            import->source = MeshCache::Source::of(import->path, MeshImporter::importFlags);
+            import->cachePath = MeshCache::locate(cacheDirectory, import->path);
+        } catch (std::exception &error) {
+            import->error = error.what();
+            complete([this, import]() {
+                createModel(*import);
+            });
+            return;
+        }
+
+        if (importCached(import))
+            return;
+
+        import->importer = std::make_unique<Assimp::Importer>();
+        import->scene = import->importer->ReadFile(import->path, MeshImporter::importFlags);
+        if (!import->scene) {
+            import->error = import->importer->GetErrorString();
+            import->importer = nullptr;
+            complete([this, import]() {
+                createModel(*import);
+            });
+            return;
+        }
+
+        const uint32_t meshCount = import->scene->mNumMeshes;
+        import->entries.resize(meshCount);
+        import->packed.resize(meshCount);
+        import->keys.resize(meshCount);
+        import->textures.resize(meshCount);
+        if (meshCount == 0) {
+            convertMesh(import, 0);
+            return;
+        }
+
+        import->remaining = meshCount;
+        for (uint32_t i = 0; i < meshCount; i++)
+            enqueue(import->priority, [this, import, i]() {
+                convertMesh(import, i);
+            });
+    }
+
+    bool AssetManager::importCached(const std::shared_ptr<ModelImport> &import) {
+        if (!std::filesystem::exists(import->cachePath))
+            return false;
+
+        try {
+            import->cached = std::make_unique<MeshCache>(import->cachePath, import->source);
+        } catch (std::runtime_error &error) {
+            logger.debug("Rebuilding mesh cache of \"{}\" ({})", import->path, error.what());
+            return false;
+        }
+
+        const auto &entries = import->cached->getEntries();
+        import->keys.resize(entries.size());
+        import->textures.resize(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            const auto &entry = entries[i];
+            if (!entry.texture.empty())
+                import->textures[i] = requestTexture(MeshImporter::resolve(import->path, entry.texture),
+                                                     import->priority);
+            /// Pages the mesh in from the mapping here rather than on the updating thread
+            import->keys[i] = hashMesh(entry.layout, entry.data,
+                                       Mesh::packedSize(entry.layout, entry.vertexCount, entry.indexCount));
+        }
+
+        complete([this, import]() {
+            createModel(*import);
+        });
+        return true;
+    }
+
+    bool AssetManager::importBundled(const std::shared_ptr<ModelImport> &import) {
+        const auto [bundle, entry] = findBundled(import->path);
+        if (!entry)
+            return false;
+
+        try {
+            if (entry->type != Bundle::Type::MESH)
+                throw std::runtime_error("Bundle entry is not a mesh");
+
+            /// The records are decompressed first, then every mesh into the buffer it is uploaded from
+            Bundle::Reader reader(*entry, bundle->read(*entry));
+            std::vector<uint8_t> records(MeshCache::headerSize);
+            reader.read(records.data(), records.size());
+            const uint64_t dataOffset = MeshCache::getDataOffset(records.data());
+            if (dataOffset < MeshCache::headerSize || dataOffset > entry->size)
+                throw std::runtime_error("Bundled mesh is corrupt");
+            records.resize(dataOffset);
+            reader.read(records.data() + MeshCache::headerSize, records.size() - MeshCache::headerSize);
+
+            import->entries = MeshCache::parse(records.data(), records.size(), std::nullopt);
+            import->packed.resize(import->entries.size());
+            import->keys.resize(import->entries.size());
+            for (size_t i = 0; i < import->entries.size(); i++) {
+                auto &mesh = import->entries[i];
+                const VkDeviceSize size = Mesh::packedSize(mesh.layout, mesh.vertexCount, mesh.indexCount);
+                if (mesh.offset > entry->size || size > entry->size - mesh.offset)
+                    throw std::runtime_error("Bundled mesh is corrupt");
+
+                auto &packed = import->packed[i];
+                packed.resize(size);
+                /// Skips the padding in front of the mesh
+                reader.seek(mesh.offset);
+                reader.read(packed.data(), packed.size());
+                mesh.data = packed.data();
+                import->keys[i] = hashMesh(mesh.layout, packed.data(), packed.size());
+            }
+        } catch (std::exception &error) {
+            import->error = error.what();
+            import->entries.clear();
+            import->packed.clear();
+            import->keys.clear();
+        }
+
+        import->textures.resize(import->entries.size());
+        for (size_t i = 0; i < import->entries.size(); i++)
+            if (!import->entries[i].texture.empty())
+                import->textures[i] = requestTexture(MeshImporter::resolve(import->path, import->entries[i].texture),
+                                                     import->priority);
+
+        complete([this, import]() {
+            createModel(*import);
+        });
+        return true;
+    }
+
+    std::pair<std::shared_ptr<const Bundle>, const Bundle::Entry *>
+    AssetManager::findBundled(const std::filesystem::path &path) {
+        const auto normal = path.lexically_normal();
+        std::scoped_lock lock(mutex);
+        for (auto mount = bundles.rbegin(); mount != bundles.rend(); mount++) {
+            const auto name = mount->root.empty() ? normal : normal.lexically_relative(mount->root);
+            if (name.empty())
+                continue;
+            if (const auto entry = mount->bundle->find(name.generic_string()))
+                return {mount->bundle, entry};
+        }
+        return {nullptr, nullptr};
+    }
+
+    void AssetManager::convertMesh(const std::shared_ptr<ModelImport> &import, uint32_t index) {
+        if (import->scene && index < import->scene->mNumMeshes && !import->state->cancelled) {
+            try {
+                auto data = MeshImporter::convert(import->scene, import->scene->mMeshes[index]);
+                auto &packed = import->packed[index];
+                packed.resize(Mesh::packedSize(data.layout, data.vertices.size(), data.indices.size()));
+                MeshImporter::pack(data, packed.data());
+                import->keys[index] = hashMesh(data.layout, packed.data(), packed.size());
+                /// Start decoding the texture while the remaining meshes are still converting
+                if (!data.texture.empty())
+                    import->textures[index] = requestTexture(MeshImporter::resolve(import->path, data.texture),
+                                                             import->priority);
+                import->entries[index] = MeshCache::describe(data, packed.data());
+            } catch (std::exception &error) {
+                std::scoped_lock lock(import->mutex);
+                import->error = error.what();
+            }
+        }
+
+        if (import->remaining == 0 || --import->remaining == 0) {
+            /// Releases the Assimp scene as soon as every mesh has been converted
+            import->importer = nullptr;
+            import->scene = nullptr;
+
+            if (import->error.empty() && !import->state->cancelled) {
+                try {
+                    MeshCache::write(import->cachePath, import->source, import->entries);
+                } catch (std::exception &error) {
+                    logger.warning("Failed to write mesh cache of \"{}\" ({})", import->path, error.what());
+                }
+            }
+
+            complete([this, import]() {
+                createModel(*import);
+            });
+        }
+    }
+
+    void AssetManager::createModel(ModelImport &import) {
+        const auto state = import.state;
+        if (state->cancelled) {
+            publications.emplace_back([state]() {
+                resolve(*state, std::shared_ptr<Model>(), AssetStatus::CANCELLED);
+            });
+            return;
+        }
+
+        if (!import.error.empty()) {
+            logger.warning("Failed to load model \"{}\" ({})", import.path, import.error);
+            publications.emplace_back([state, error = import.error]() {
+                resolve(*state, std::shared_ptr<Model>(), AssetStatus::FAILED, error);
+            });
+            return;
+        }
+
+        const auto create = [&](size_t index, uint64_t key, const std::string &textureName,
+                                const std::function<std::shared_ptr<Mesh>(const std::shared_ptr<ImageView> &)> &make) {
+            const auto &textureState = import.textures[index];
+            const bool textureLoading = textureState && textureState->status == AssetStatus::LOADING;
+            const auto texture = textureState && textureState->status == AssetStatus::RESIDENT ? textureState->value
+                                                                                                : placeholderTexture;
+
+            const auto texturePath = textureName.empty() ? std::string() : MeshImporter::resolve(import.path,
+                                                                                                 textureName);
+            key = AssetCache::hash(texturePath.data(), texturePath.size(), key);
+            auto mesh = cache.getMesh(key, [&]() {
+                return make(texture);
+            });
+
+            if (textureLoading) {
+                std::scoped_lock lock(mutex);
+                if (const auto &entry = textures.find(texturePath);
+                        entry != textures.end() && entry->second.state == textureState)
+                    entry->second.dependents.push_back(mesh);
+            }
+            return mesh;
+        };
+
+        auto model = std::make_shared<Model>();
+        /// Cached meshes are copied straight out of the mapping, the others out of the buffers they were packed into
+        const auto &entries = import.cached ? import.cached->getEntries() : import.entries;
+        model->meshes.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            const auto &entry = entries[i];
+            model->meshes.push_back(create(i, import.keys[i], entry.texture, [&](const auto &texture) {
+                return std::make_shared<Mesh>(uploader, arena, texture, entry.layout, entry.data,
+                                              entry.vertexCount, entry.indexCount, entry.minimum, entry.maximum);
+            }));
+        }
+        /// Everything has been copied into staging memory, neither the mapping nor the packed meshes are needed
+        import.cached = nullptr;
+        import.entries.clear();
+        import.packed.clear();
+
+        publications.emplace_back([state, model]() {
+            resolve(*state, model, AssetStatus::RESIDENT);
+        });
+    }
+
+    void AssetManager::createTexture(const std::string &path, const std::shared_ptr<TextureState> &state,
+                                     DecodedTexture &decoded) {
+        std::shared_ptr<ImageView> view;
+        std::string error = decoded.error;
+        if (error.empty() && !state->cancelled) {
+            try {
+                view = cache.getTexture(decoded.key, [&]() {
+                    /// Decoding was skipped because the contents were cached when the worker looked
+                    if (!decoded.data)
+                        throw std::runtime_error("Texture was evicted from the cache while loading");
+                    return std::make_shared<ImageView>(Image::from(uploader, *decoded.data),
+                                                       VK_IMAGE_ASPECT_COLOR_BIT);
+                });
+            } catch (std::exception &exception) {
+                error = exception.what();
+            }
+        }
+        decoded.data.reset();
+
+        if (!error.empty())
+            logger.warning("Failed to load texture at path \"{}\" ({})", path, error);
+
+        publications.emplace_back([this, path, state, view, error]() {
+            std::vector<std::weak_ptr<Mesh>> dependents;
+            {
+                std::scoped_lock lock(mutex);
+                if (const auto &entry = textures.find(path);
+                        entry != textures.end() && entry->second.state == state)
+                    dependents.swap(entry->second.dependents);
+            }
+
+            if (state->cancelled && !view) {
+                resolve(*state, std::shared_ptr<ImageView>(), AssetStatus::CANCELLED);
+                return;
+            }
+
+            if (!view) {
+                resolve(*state, std::shared_ptr<ImageView>(), AssetStatus::FAILED, error);
+                return;
+            }
+
+            for (const auto &dependent : dependents)
+                if (const auto mesh = dependent.lock())
+                    mesh->setTexture(view);
+            resolve(*state, view, AssetStatus::RESIDENT);
+        });
+    }
+
+    template<typename State, typename T>
+    void AssetManager::resolve(State &state, std::shared_ptr<T> value, AssetStatus status, std::string error) {
+        if (value)
+            state.value = std::move(value);
+        state.error = std::move(error);
+        state.status = status;
+
+        /// A resumed coroutine may await this asset again, so the waiters are taken out first
+        std::vector<std::coroutine_handle<>> waiters;
+        waiters.swap(state.waiters);
+        for (const auto &waiter : waiters)
+            waiter.resume();
+    }
+
+    AssetManager::DecodedTexture AssetManager::decodeTexture(const std::filesystem::path &path) {
+        DecodedTexture decoded;
+        try {
+            if (const auto [bundle, entry] = findBundled(path); entry) {
+                const auto contents = bundle->load(*entry);
+                decoded.key = AssetCache::hash(contents);
+                if (cache.containsTexture(decoded.key))
+                    return decoded;
+
+                if (entry->type == Bundle::Type::KTX2) {
+                    std::istringstream stream(std::string(contents.begin(), contents.end()), std::ios::binary);
+                    decoded.data = Image::loadKtx2(*physicalDevice, stream);
+                } else {
+                    decoded.data = Image::load(contents.data(), contents.size());
+                }
+                return decoded;
+            }
+
+            decoded.key = cache.getContentKey(path);
+            if (cache.containsTexture(decoded.key))
+                return decoded;
+
+            auto compressed = path;
+            compressed.replace_extension(".ktx2");
+            if (std::filesystem::exists(compressed)) {
+                try {
+                    decoded.data = Image::loadKtx2(*physicalDevice, compressed.string());
+                    return decoded;
+                } catch (std::runtime_error &error) {
+                    logger.debug("Falling back to \"{}\" ({})", path.string(), error.what());
+                }
+            }
+
+            decoded.data = Image::load(path.string());
+        } catch (std::exception &error) {
+            decoded.error = error.what();
+        }
+        return decoded;
+    }
+}
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Mesh.h"
+#include "ImageView.h"
+#include "AssetCache.h"
+#include "Bundle.h"
+#include "GeometryArena.h"
+#include "MeshCache.h"
+#include "MeshImporter.h"
+#include "JobSystem.h"
+#include "UploadManager.h"
+#include "Task.h"
+
+namespace Vixen {
+    enum class AssetPriority : uint8_t {
+        LOW,
+        NORMAL,
+        HIGH
+    };
+
+    enum class AssetStatus : uint8_t {
+        LOADING,
+        RESIDENT,
+        FAILED,
+        CANCELLED
+    };
+
+    /**
+     * Every mesh imported from a single model file, in the order of the file
+     */
+    struct Model {
+        std::vector<std::shared_ptr<Mesh>> meshes;
+    };
+
+    /**
+     * A reference to an asset that may still be loading. Until the asset is resident get() returns a placeholder, the
+     * reference it returns stays valid and is swapped to the asset in place. Awaiting a handle suspends the coroutine
+     * until the asset is resident, a failed or cancelled load resumes it with an exception.
+     *
+     * Handles are shared between every request for the same path and must only be used on the thread that calls
+     * AssetManager::update.
+     */
+    template<typename T>
+    class AssetHandle {
+        friend class AssetManager;
+
+        struct State {
+            std::shared_ptr<T> value;
+
+            std::atomic<AssetStatus> status = AssetStatus::LOADING;
+
+            std::atomic<bool> cancelled = false;
+
+            std::string error;
+
+            std::vector<std::coroutine_handle<>> waiters;
+        };
+
+        std::shared_ptr<State> state;
+
+        explicit AssetHandle(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+    public:
+        [[nodiscard]] const std::shared_ptr<T> &get() const {
+            return state->value;
+        }
+
+        [[nodiscard]] AssetStatus getStatus() const {
+            return state->status;
+        }
+
+        [[nodiscard]] bool isResident() const {
+            return state->status == AssetStatus::RESIDENT;
+        }
+
+        [[nodiscard]] const std::string &getError() const {
+            return state->error;
+        }
+
+        /**
+         * Abandons the load for every holder of this handle, queued work is skipped and waiting coroutines are resumed
+         * with an exception on the next update. Cancelling a resident asset has no effect.
+         */
+        void cancel() const {
+            state->cancelled = true;
+        }
+
+        auto operator co_await() const noexcept {
+            struct Awaiter {
+                std::shared_ptr<State> state;
+
+                bool await_ready() const noexcept {
+                    return state->status != AssetStatus::LOADING;
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) const {
+                    state->waiters.push_back(handle);
+                }
+
+                std::shared_ptr<T> await_resume() const {
+                    switch (state->status) {
+                        case AssetStatus::FAILED:
+                            throw std::runtime_error(state->error);
+                        case AssetStatus::CANCELLED:
+                            throw std::runtime_error("Asset load was cancelled");
+                        default:
+                            return state->value;
+                    }
+                }
+            };
+            return Awaiter{state};
+        }
+    };
+
+    /**
+     * Loads models and textures without blocking the calling thread. Reading files, Assimp post-processing, mesh
+     * conversion and image decoding run as jobs in priority order, higher priorities first and requests of the
+     * same priority in the order they were made. Only creating the GPU resources and recording their uploads happens in
+     * update, which also resumes the coroutines waiting on assets that became resident.
+     *
+     * Every imported model is written to a mesh cache, later loads of an unchanged model map the cache instead of
+     * running Assimp. Assets found in a mounted bundle are read from the bundle instead of from loose files.
+     */
+    class AssetManager {
+        using ModelState = AssetHandle<Model>::State;
+
+        using TextureState = AssetHandle<ImageView>::State;
+
+        struct Job {
+            AssetPriority priority;
+
+            uint64_t sequence;
+
+            std::function<void()> work;
+        };
+
+        struct JobOrder {
+            bool operator()(const Job &a, const Job &b) const {
+                return a.priority != b.priority ? a.priority < b.priority : a.sequence > b.sequence;
+            }
+        };
+
+        /**
+         * A model file being loaded from a bundle, from its mesh cache or through Assimp with every mesh converted by
+         * its own job
+         */
+        struct ModelImport {
+            std::string path;
+            std::shared_ptr<ModelState> state;
+            AssetPriority priority;
+            MeshCache::Source source{};
+            std::filesystem::path cachePath;
+            /// Set when the model is loaded from its mesh cache, the meshes are copied straight out of the mapping
+            std::unique_ptr<MeshCache> cached;
+            std::unique_ptr<Assimp::Importer> importer;
+            const aiScene *scene = nullptr;
+            /// Every converted or bundled mesh, pointing into the buffer a worker packed or decompressed it into
+            std::vector<MeshCache::Entry> entries;
+            std::vector<std::vector<uint8_t>> packed;
+            /// The content key of every mesh, hashed by a worker so update never reads the mesh data
+            std::vector<uint64_t> keys;
+            /// The diffuse texture of every mesh, null when the mesh is untextured
+            std::vector<std::shared_ptr<TextureState>> textures;
+            std::atomic<size_t> remaining = 0;
+            std::mutex mutex;
+            std::string error;
+        };
+
+        /**
+         * A texture decoded by a worker, the content key is always set so textures decoded under different paths
+         * still share a single image
+         */
+        struct DecodedTexture {
+            uint64_t key = 0;
+            std::optional<ImageData> data;
+            std::string error;
+        };
+
+        struct MountedBundle {
+            std::shared_ptr<const Bundle> bundle;
+            std::filesystem::path root;
+        };
+
+        /**
+         * Assets moved by a defragmentation pass, the previous allocations are released once the copies finished
+         */
+        struct Relocation {
+            std::unique_ptr<CommandBuffer> commandBuffer;
+            std::vector<std::pair<GeometryArena::Range, GeometryArena::Range>> ranges;
+            std::vector<std::unique_ptr<ImageView>> images;
+        };
+
+        struct TextureEntry {
+            std::shared_ptr<TextureState> state;
+            /// Meshes drawn with the placeholder until this texture is resident
+            std::vector<std::weak_ptr<Mesh>> dependents;
+        };
+
+        Logger logger{"AssetManager"};
+
+        const std::shared_ptr<LogicalDevice> logicalDevice;
+
+        const std::shared_ptr<PhysicalDevice> physicalDevice;
+
+        const std::filesystem::path cacheDirectory;
+
+        /// Every mesh is suballocated from the arena, so passes bind the geometry buffers once per block. Declared
+        /// before the uploader so its pending uploads are finished before the arena can be destroyed.
+        const std::shared_ptr<GeometryArena> arena;
+
+        UploadManager uploader;
+
+        AssetCache cache;
+
+        std::shared_ptr<ImageView> placeholderTexture;
+
+        const std::shared_ptr<Model> placeholderModel = std::make_shared<Model>();
+
+        std::mutex jobMutex;
+
+        std::priority_queue<Job, std::vector<Job>, JobOrder> jobs;
+
+        uint64_t sequence = 0;
+
+        /// Jobs scheduled on the job system that may not have finished yet, guarded by the job mutex
+        std::vector<JobHandle> running;
+
+        /// Guards the maps and completions below, which are shared with the workers
+        std::mutex mutex;
+
+        std::unordered_map<std::string, std::shared_ptr<ModelState>> models;
+
+        std::unordered_map<std::string, TextureEntry> textures;
+
+        /// Searched last to first, so later bundles override earlier ones
+        std::vector<MountedBundle> bundles;
+
+        /// Work finished by the workers that still has to create its GPU resources on the updating thread
+        std::vector<std::function<void()>> completions;
+
+        /// Assets whose uploads are recorded and that become visible after the next flush, only used by update
+        std::vector<std::function<void()>> publications;
+
+        /// The pass in flight, only used by update and defragment
+        std::optional<Relocation> relocation;
+
+        /// The arena usage when the last pass found no mesh to move, compacting is skipped until it changes
+        VkDeviceSize compactedUsage = 0;
+
+        /// A block textures moved back into and its usage at the time, skipped until its usage changes
+        std::pair<VkDeviceMemory, VkDeviceSize> settledBlock{VK_NULL_HANDLE, 0};
+
+        std::atomic<bool> stopping = false;
+
+        /// Declared last so a job system owned by this manager alone joins its workers before anything they touch is
+        /// destroyed
+        const std::shared_ptr<JobSystem> jobSystem;
+
+        void enqueue(AssetPriority priority, std::function<void()> work);
+
+        void runNext();
+
+        void complete(std::function<void()> finish);
+
+        std::shared_ptr<TextureState> requestTexture(const std::filesystem::path &path, AssetPriority priority);
+
+        void importModel(const std::shared_ptr<ModelImport> &import);
+
+        void convertMesh(const std::shared_ptr<ModelImport> &import, uint32_t index);
+
+        void createModel(ModelImport &import);
+
+        /**
+         * Moves meshes towards the front of the arena, the meshes at the back first so its last blocks empty out
+         */
+        size_t compactMeshes(CommandBuffer &commandBuffer, Relocation &moved, VkDeviceSize &bytes,
+                             VkDeviceSize maxBytes);
+
+        /**
+         * Moves textures out of the memory block holding the fewest bytes, so the allocator can release it
+         */
+        size_t relocateTextures(CommandBuffer &commandBuffer, Relocation &moved, VkDeviceSize &bytes,
+                                VkDeviceSize maxBytes);
+
+        void createTexture(const std::string &path, const std::shared_ptr<TextureState> &state,
+                           DecodedTexture &decoded);
+
+        bool importCached(const std::shared_ptr<ModelImport> &import);
+
+        bool importBundled(const std::shared_ptr<ModelImport> &import);
+
+        /**
+         * Finds an asset in the mounted bundles, the entry is null when no bundle contains the path
+         */
+        std::pair<std::shared_ptr<const Bundle>, const Bundle::Entry *> findBundled(const std::filesystem::path &path);
+
+        /**
+         * Decodes a texture unless its contents are cached already, preferring a transcoded KTX2 file next to the
+         * source image when the device supports its format
+         */
+        DecodedTexture decodeTexture(const std::filesystem::path &path);
+
+        template<typename State, typename T>
+        static void resolve(State &state, std::shared_ptr<T> value, AssetStatus status, std::string error = {});
+
+    public:
+        /**
+         * @param[in] cacheDirectory The directory mesh caches are read from and written to
+         * @param[in] jobSystem The job system reading and decoding assets, the manager creates its own when none is
+         * given
+         */
+        AssetManager(std::shared_ptr<LogicalDevice> logicalDevice, std::shared_ptr<PhysicalDevice> physicalDevice,
+                     std::filesystem::path cacheDirectory = "cache", std::shared_ptr<JobSystem> jobSystem = nullptr);
+
+        AssetManager(const AssetManager &) = delete;
+
+        AssetManager &operator=(const AssetManager &) = delete;
+
+        /**
+         * Skips every queued job, waiting coroutines are not resumed
+         */
+        ~AssetManager();
+
+        /**
+         * Makes the assets of a bundle available, they take precedence over loose files and bundles mounted earlier
+         *
+         * @param[in] root The directory the bundle's asset names are relative to
+         * @throws std::runtime_error When the file is not a valid bundle
+         */
+        void mount(const std::filesystem::path &path, const std::filesystem::path &root = {});
+
+        /**
+         * Queues a model import, the placeholder is a model without meshes. Meshes become resident with a placeholder
+         * texture when their own texture is still loading, the texture is swapped in once it is resident.
+         */
+        AssetHandle<Model> loadMesh(const std::string &path, AssetPriority priority = AssetPriority::NORMAL);
+
+        /**
+         * Queues a texture load, the placeholder is a single white texel
+         */
+        AssetHandle<ImageView> loadTexture(const std::string &path, AssetPriority priority = AssetPriority::NORMAL);
+
+        /**
+         * Creates the GPU resources of finished loads, flushes their uploads and resumes the coroutines waiting on
+         * them, call this once per frame. Never waits on the workers.
+         *
+         * @return The amount of assets that finished loading, any meshes drawn so far may have changed textures when
+         * this is not zero
+         */
+        size_t update();
+
+        /**
+         * Runs one incremental defragmentation step on the graphics queue, call this once per frame. Meshes are
+         * compacted within the geometry arena and textures are moved out of sparsely used memory blocks, at most
+         * maxBytes are copied per step and only one step is in flight at a time. Memory freed by a step is released by
+         * the first update after it finished.
+         *
+         * @return The amount of assets that moved, command buffers drawing any asset have to be recorded again before
+         * the next update when this is not zero
+         */
+        size_t defragment(VkDeviceSize maxBytes = 8 * 1024 * 1024);
+
+        [[nodiscard]] size_t getQueuedCount();
+
+        [[nodiscard]] const std::shared_ptr<ImageView> &getPlaceholderTexture() const;
+
+        [[nodiscard]] const AssetCache &getCache() const;
+
+        [[nodiscard]] const std::shared_ptr<GeometryArena> &getArena() const;
+    };
+}
@@ -2,26 +2,52 @@
 
 namespace Vixen {
     Buffer::Buffer(const std::shared_ptr<LogicalDevice> &device, VkDeviceSize size, VkBufferUsageFlags bufferUsage,
-                   VmaMemoryUsage allocationUsage)
-            : device(device), allocation(nullptr), buffer(nullptr), size(size) {
+                   VmaMemoryUsage allocationUsage, const std::vector<QueueType> &queues)
+            : device(device), allocation(nullptr), buffer(nullptr), size(size), concurrent(false), memoryFlags(0),
+              mapped(nullptr) {
+        std::set<uint32_t> families;
+        for (const auto queue : queues)
+            families.insert(device->getQueueFamilyIndex(queue));
+        const std::vector<uint32_t> familyIndices(families.begin(), families.end());
+
         VkBufferCreateInfo bufferCreateInfo = {};
         bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferCreateInfo.size = size;
         bufferCreateInfo.usage = bufferUsage;
-        bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (familyIndices.size() > 1) {
+            concurrent = true;
+            bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(familyIndices.size());
+            bufferCreateInfo.pQueueFamilyIndices = familyIndices.data();
+        } else {
+            bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        }
 
         VmaAllocationCreateInfo allocationCreateInfo = {};
         allocationCreateInfo.usage = allocationUsage;
+        if (allocationUsage == VMA_MEMORY_USAGE_GPU_ONLY && device->mappableDeviceMemory)
+            allocationCreateInfo.preferredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                  VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        /// Ignored by the allocator when the memory type it picks is not host visible
+        allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
+        VmaAllocationInfo allocationInfo{};
         VK_CHECK_RESULT(
                 vmaCreateBuffer(device->allocator, &bufferCreateInfo, &allocationCreateInfo, &buffer, &allocation,
-                                nullptr))
+                                &allocationInfo))
+        device->memoryStatistics.track(allocation, MemoryStatistics::categorizeBuffer(bufferUsage), allocationInfo);
+        vmaGetMemoryTypeProperties(device->allocator, allocationInfo.memoryType, &memoryFlags);
+        mapped = allocationInfo.pMappedData;
     }
 
     Buffer::Buffer(Buffer &&other) noexcept: device(other.device), allocation(std::exchange(other.allocation, nullptr)),
-                                             buffer(std::exchange(other.buffer, nullptr)), size(other.size) {}
+                                             buffer(std::exchange(other.buffer, nullptr)), size(other.size),
+                                             concurrent(other.concurrent), memoryFlags(other.memoryFlags),
+                                             mapped(std::exchange(other.mapped, nullptr)) {}
 
     Buffer::~Buffer() {
+        if (allocation)
+            device->memoryStatistics.untrack(allocation);
         vmaDestroyBuffer(device->allocator, buffer, allocation);
     }
 
@@ -30,7 +56,7 @@ namespace Vixen {
             throw std::runtime_error("Buffer overflow");
 
         void *d = map();
-        memcpy(d, data, dataSize);
+        memcpy(static_cast<char *>(d) + offset, data, dataSize);
         unmap();
     }
 
@@ -40,13 +66,23 @@ namespace Vixen {
     }
 
     void *Buffer::map() {
+        if (mapped)
+            return mapped;
+
         void *data = nullptr;
         VK_CHECK_RESULT(vmaMapMemory(device->allocator, allocation, &data))
         return data;
     }
 
     void Buffer::unmap() {
-        vmaUnmapMemory(device->allocator, allocation);
+        flush(0, VK_WHOLE_SIZE);
+        if (!mapped)
+            vmaUnmapMemory(device->allocator, allocation);
+    }
+
+    void Buffer::flush(VkDeviceSize offset, VkDeviceSize flushSize) {
+        /// The allocator skips the call when the memory is host coherent
+        vmaFlushAllocation(device->allocator, allocation, offset, flushSize);
     }
 
     void Buffer::copyFrom(const Buffer &other) const {
@@ -62,4 +98,20 @@ namespace Vixen {
     VkBuffer Buffer::getBuffer() const {
         return buffer;
     }
+
+    VkDeviceSize Buffer::getSize() const {
+        return size;
+    }
+
+    bool Buffer::isConcurrent() const {
+        return concurrent;
+    }
+
+    VkMemoryPropertyFlags Buffer::getMemoryFlags() const {
+        return memoryFlags;
+    }
+
+    void *Buffer::getMapped() const {
+        return mapped;
+    }
 }
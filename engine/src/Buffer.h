@@ -15,9 +15,22 @@ namespace Vixen {
 
         VkDeviceSize size;
 
+        bool concurrent;
+
+        VkMemoryPropertyFlags memoryFlags;
+
+        /// Host visible buffers stay mapped for their whole lifetime
+        void *mapped;
+
     public:
+        /**
+         * @param[in] queues The queues accessing this buffer, when they span several queue families the buffer is
+         * shared concurrently instead of requiring ownership transfers. VMA_MEMORY_USAGE_CPU_TO_GPU places dynamic data
+         * in device local memory the host can write to when there is any, and VMA_MEMORY_USAGE_GPU_ONLY buffers are
+         * host visible as well when all of device memory is.
+         */
         Buffer(const std::shared_ptr<LogicalDevice> &device, VkDeviceSize size, VkBufferUsageFlags bufferUsage,
-               VmaMemoryUsage allocationUsage);
+               VmaMemoryUsage allocationUsage, const std::vector<QueueType> &queues = {});
 
         Buffer(const Buffer &) = delete;
 
@@ -32,10 +45,35 @@ namespace Vixen {
 
         void *map();
 
+        /**
+         * Flushes the writes made through the mapping, the buffer itself stays mapped when it is host visible
+         */
         void unmap();
 
+        /**
+         * Makes host writes to a range visible to the device, this does nothing for host coherent memory
+         */
+        void flush(VkDeviceSize offset, VkDeviceSize flushSize);
+
         void copyFrom(const Buffer &other) const;
 
         [[nodiscard]] VkBuffer getBuffer() const;
+
+        [[nodiscard]] VkDeviceSize getSize() const;
+
+        /**
+         * Whether the buffer is shared concurrently between queue families
+         */
+        [[nodiscard]] bool isConcurrent() const;
+
+        /**
+         * The properties of the memory type the buffer was placed in
+         */
+        [[nodiscard]] VkMemoryPropertyFlags getMemoryFlags() const;
+
+        /**
+         * The persistent mapping of a host visible buffer, nullptr when the host can not write to it directly
+         */
+        [[nodiscard]] void *getMapped() const;
     };
 }
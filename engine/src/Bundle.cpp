@@ -0,0 +1,223 @@
+#include "Bundle.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <zstd.h>
+#include "Logger.h"
+
+namespace Vixen {
+    namespace {
+        constexpr std::array<char, 4> magic{'V', 'X', 'B', 'N'};
+
+        struct Header {
+            std::array<char, 4> magic;
+            uint32_t version;
+            uint32_t entryCount;
+            uint32_t namesSize;
+        };
+
+        struct TableEntry {
+            uint64_t offset;
+            uint64_t compressedSize;
+            uint64_t size;
+            uint32_t type;
+            uint32_t compression;
+            /// The offset of the name from the start of the bundle
+            uint32_t nameOffset;
+            uint32_t nameLength;
+        };
+
+        static_assert(sizeof(Header) == 16 && sizeof(TableEntry) == 40);
+
+        uint64_t align(uint64_t offset) {
+            return (offset + Bundle::alignment - 1) & ~(Bundle::alignment - 1);
+        }
+    }
+
+    Bundle::Reader::Reader(const Entry &entry, std::vector<uint8_t> compressed)
+            : entry(entry), compressed(std::move(compressed)) {
+        if (entry.compression == Compression::ZSTD) {
+            context = ZSTD_createDCtx();
+            if (!context)
+                throw std::runtime_error("Failed to create zstd context");
+        }
+    }
+
+    Bundle::Reader::~Reader() {
+        ZSTD_freeDCtx(context);
+    }
+
+    void Bundle::Reader::read(void *destination, size_t size) {
+        if (position + size > entry.size)
+            throw std::runtime_error(fmt::format("Read past the end of \"{}\"", entry.name));
+
+        if (entry.compression == Compression::NONE) {
+            /// The reader may be given any blob, not only one read from a validated bundle
+            if (position + size > compressed.size())
+                throw std::runtime_error(fmt::format("\"{}\" is truncated", entry.name));
+            memcpy(destination, compressed.data() + position, size);
+            position += size;
+            return;
+        }
+
+        ZSTD_outBuffer output{destination, size, 0};
+        while (output.pos < output.size) {
+            ZSTD_inBuffer input{compressed.data(), compressed.size(), consumed};
+            const size_t produced = output.pos;
+            const size_t result = ZSTD_decompressStream(context, &output, &input);
+            if (ZSTD_isError(result))
+                throw std::runtime_error(fmt::format("Failed to decompress \"{}\" ({})", entry.name,
+                                                     ZSTD_getErrorName(result)));
+            /// No progress with all input consumed means the frame ended early
+            if (input.pos == input.size && output.pos == produced)
+                throw std::runtime_error(fmt::format("\"{}\" is truncated", entry.name));
+            consumed = input.pos;
+        }
+        position += size;
+    }
+
+    void Bundle::Reader::seek(uint64_t offset) {
+        if (offset < position)
+            throw std::runtime_error("Bundle readers can only seek forward");
+
+        std::array<uint8_t, 4096> discard{};
+        while (position < offset)
+            read(discard.data(), std::min<uint64_t>(discard.size(), offset - position));
+    }
+
+    uint64_t Bundle::Reader::tell() const {
+        return position;
+    }
+
+    Bundle::Bundle(const std::filesystem::path &path) : file(path) {
+        const uint8_t *data = file.getData();
+        const size_t size = file.getSize();
+
+        if (size < sizeof(Header))
+            throw std::runtime_error("Bundle is truncated");
+        Header header{};
+        memcpy(&header, data, sizeof(header));
+        if (header.magic != magic)
+            throw std::runtime_error("File is not a bundle");
+        if (header.version != version)
+            throw std::runtime_error("Bundle was written by another version");
+        if (sizeof(Header) + static_cast<uint64_t>(header.entryCount) * sizeof(TableEntry) + header.namesSize > size)
+            throw std::runtime_error("Bundle is truncated");
+
+        entries.reserve(header.entryCount);
+        for (uint32_t i = 0; i < header.entryCount; i++) {
+            TableEntry table{};
+            memcpy(&table, data + sizeof(Header) + i * sizeof(TableEntry), sizeof(table));
+            if (table.offset > size || table.compressedSize > size - table.offset ||
+                static_cast<uint64_t>(table.nameOffset) + table.nameLength > size)
+                throw std::runtime_error("Bundle is truncated");
+            if (table.compression != static_cast<uint32_t>(Compression::NONE) &&
+                table.compression != static_cast<uint32_t>(Compression::ZSTD))
+                throw std::runtime_error("Bundle uses an unknown compression");
+            /// Uncompressed blobs are copied as they are, so they have to be exactly as large as their contents
+            if (table.compression == static_cast<uint32_t>(Compression::NONE) && table.compressedSize != table.size)
+                throw std::runtime_error("Bundle is corrupt");
+
+            entries.push_back({
+                    std::string(reinterpret_cast<const char *>(data + table.nameOffset), table.nameLength),
+                    static_cast<Type>(table.type),
+                    static_cast<Compression>(table.compression),
+                    table.offset,
+                    table.compressedSize,
+                    table.size
+            });
+            names.emplace(entries.back().name, i);
+        }
+    }
+
+    const Bundle::Entry *Bundle::find(const std::string &name) const {
+        const auto &entry = names.find(name);
+        return entry == names.end() ? nullptr : &entries[entry->second];
+    }
+
+    const std::vector<Bundle::Entry> &Bundle::getEntries() const {
+        return entries;
+    }
+
+    std::vector<uint8_t> Bundle::read(const Entry &entry) const {
+        const uint8_t *begin = file.getData() + entry.offset;
+        return {begin, begin + entry.compressedSize};
+    }
+
+    std::vector<uint8_t> Bundle::load(const Entry &entry) const {
+        std::vector<uint8_t> contents(entry.size);
+        Reader reader(entry, read(entry));
+        reader.read(contents.data(), contents.size());
+        return contents;
+    }
+
+    void Bundle::write(const std::filesystem::path &path, const std::vector<Source> &sources, int level) {
+        std::vector<TableEntry> table(sources.size());
+        std::vector<std::vector<uint8_t>> blobs(sources.size());
+        uint64_t offset = sizeof(Header) + sources.size() * sizeof(TableEntry);
+        uint32_t namesSize = 0;
+        for (size_t i = 0; i < sources.size(); i++) {
+            const auto &source = sources[i];
+            table[i].nameOffset = static_cast<uint32_t>(offset + namesSize);
+            table[i].nameLength = static_cast<uint32_t>(source.name.size());
+            namesSize += table[i].nameLength;
+
+            auto &blob = blobs[i];
+            blob.resize(ZSTD_compressBound(source.contents.size()));
+            const size_t compressedSize = ZSTD_compress(blob.data(), blob.size(), source.contents.data(),
+                                                        source.contents.size(), level);
+            if (ZSTD_isError(compressedSize))
+                throw std::runtime_error(fmt::format("Failed to compress \"{}\" ({})", source.name,
+                                                     ZSTD_getErrorName(compressedSize)));
+
+            table[i].type = static_cast<uint32_t>(source.type);
+            table[i].size = source.contents.size();
+            if (compressedSize < source.contents.size()) {
+                blob.resize(compressedSize);
+                table[i].compression = static_cast<uint32_t>(Compression::ZSTD);
+            } else {
+                blob = source.contents;
+                table[i].compression = static_cast<uint32_t>(Compression::NONE);
+            }
+            table[i].compressedSize = blob.size();
+        }
+
+        offset += namesSize;
+        for (size_t i = 0; i < sources.size(); i++) {
+            table[i].offset = align(offset);
+            offset = table[i].offset + table[i].compressedSize;
+        }
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            throw std::runtime_error("Failed to create bundle");
+
+        const Header header{magic, version, static_cast<uint32_t>(sources.size()), namesSize};
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char *>(table.data()),
+                     static_cast<std::streamsize>(table.size() * sizeof(TableEntry)));
+        for (const auto &source : sources)
+            stream.write(source.name.data(), static_cast<std::streamsize>(source.name.size()));
+
+        uint64_t position = sizeof(Header) + table.size() * sizeof(TableEntry) + namesSize;
+        static constexpr std::array<char, alignment> padding{};
+        for (size_t i = 0; i < sources.size(); i++) {
+            stream.write(padding.data(), static_cast<std::streamsize>(table[i].offset - position));
+            stream.write(reinterpret_cast<const char *>(blobs[i].data()),
+                         static_cast<std::streamsize>(blobs[i].size()));
+            position = table[i].offset + blobs[i].size();
+        }
+
+        if (!stream)
+            throw std::runtime_error("Failed to write bundle");
+    }
+
+    int Bundle::getMinLevel() {
+        return ZSTD_minCLevel();
+    }
+
+    int Bundle::getMaxLevel() {
+        return ZSTD_maxCLevel();
+    }
+}
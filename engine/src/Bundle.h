@@ -0,0 +1,151 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MappedFile.h"
+
+struct ZSTD_DCtx_s;
+
+namespace Vixen {
+    /**
+     * A single file packing many assets, a table of contents followed by blobs that are individually compressed with
+     * zstd. Every blob starts at a page boundary so it can be read with direct I/O or mapped without touching its
+     * neighbours, blobs that do not shrink are stored uncompressed.
+     *
+     * Layout, little endian: a header, one table entry per asset, the asset names and the blobs.
+     */
+    class Bundle {
+    public:
+        static constexpr uint32_t version = 1;
+
+        static constexpr uint64_t alignment = 4096;
+
+        enum class Type : uint32_t {
+            /// A mesh cache file, see MeshCache
+            MESH,
+            /// An image file decoded with stb
+            IMAGE,
+            /// A KTX2 texture
+            KTX2
+        };
+
+        enum class Compression : uint32_t {
+            NONE,
+            ZSTD
+        };
+
+        struct Entry {
+            std::string name;
+
+            Type type;
+
+            Compression compression;
+
+            /// The offset of the blob from the start of the bundle
+            uint64_t offset;
+
+            uint64_t compressedSize;
+
+            uint64_t size;
+        };
+
+        struct Source {
+            std::string name;
+
+            Type type;
+
+            std::vector<uint8_t> contents;
+        };
+
+        /**
+         * Decompresses a blob incrementally, so it can be decoded straight into its destination without ever holding
+         * the whole uncompressed blob in memory
+         */
+        class Reader {
+            const Entry &entry;
+
+            std::vector<uint8_t> compressed;
+
+            size_t consumed = 0;
+
+            uint64_t position = 0;
+
+            ZSTD_DCtx_s *context = nullptr;
+
+        public:
+            /**
+             * @param[in] compressed The blob as stored in the bundle, see Bundle::read
+             */
+            Reader(const Entry &entry, std::vector<uint8_t> compressed);
+
+            Reader(const Reader &) = delete;
+
+            Reader &operator=(const Reader &) = delete;
+
+            ~Reader();
+
+            /**
+             * Decompresses exactly size bytes into the destination
+             *
+             * @throws std::runtime_error When the blob is corrupt or ends early
+             */
+            void read(void *destination, size_t size);
+
+            /**
+             * Skips forward to an offset of the uncompressed blob
+             */
+            void seek(uint64_t offset);
+
+            [[nodiscard]] uint64_t tell() const;
+        };
+
+        /**
+         * Maps a bundle and reads its table of contents, blobs are only read when requested
+         *
+         * @throws std::runtime_error When the file is not a bundle of this version, is truncated or is corrupt
+         */
+        explicit Bundle(const std::filesystem::path &path);
+
+        [[nodiscard]] const Entry *find(const std::string &name) const;
+
+        [[nodiscard]] const std::vector<Entry> &getEntries() const;
+
+        /**
+         * Copies a blob out of the mapping as it is stored, this is where the disk is read so it belongs on a worker
+         */
+        [[nodiscard]] std::vector<uint8_t> read(const Entry &entry) const;
+
+        /**
+         * Reads and decompresses a whole blob
+         */
+        [[nodiscard]] std::vector<uint8_t> load(const Entry &entry) const;
+
+        /**
+         * Writes a bundle, the blobs are written in the order of the sources
+         *
+         * @param[in] level The zstd compression level, from getMinLevel to getMaxLevel
+         */
+        static void write(const std::filesystem::path &path, const std::vector<Source> &sources, int level = 19);
+
+        /**
+         * The fastest compression level zstd accepts, negative levels trade compression for speed
+         */
+        [[nodiscard]] static int getMinLevel();
+
+        /**
+         * The strongest compression level zstd accepts
+         */
+        [[nodiscard]] static int getMaxLevel();
+
+    private:
+        MappedFile file;
+
+        std::vector<Entry> entries;
+
+        std::unordered_map<std::string, size_t> names;
+    };
+}
@@ -0,0 +1,251 @@
+#include "ClusteredLighting.h"
+
+namespace Vixen {
+    ClusteredLighting::ClusteredLighting(const std::shared_ptr<LogicalDevice> &device, const Camera &camera,
+                                         uint32_t imageCount)
+            : device(device), imageCount(imageCount), asyncCompute(device->physicalDevice->hasAsyncCompute()) {
+        const auto &extent = device->extent;
+
+        glm::mat4 projection = camera.getProjection(static_cast<float>(extent.width) /
+                                                    static_cast<float>(extent.height));
+        projection[1][1] *= -1.0f;
+
+        const float logRatio = std::log(camera.farPlane / camera.nearPlane);
+        parameters.inverseProjection = glm::inverse(projection);
+        parameters.view = glm::mat4(1.0f);
+        parameters.gridSize = {gridWidth, gridHeight, gridDepth, 0};
+        parameters.screen = {
+                std::ceil(static_cast<float>(extent.width) / gridWidth),
+                std::ceil(static_cast<float>(extent.height) / gridHeight),
+                static_cast<float>(extent.width),
+                static_cast<float>(extent.height)
+        };
+        parameters.planes = {
+                camera.nearPlane,
+                camera.farPlane,
+                static_cast<float>(gridDepth) / logRatio,
+                -static_cast<float>(gridDepth) * std::log(camera.nearPlane) / logRatio
+        };
+
+        createBuffers();
+        createDescriptorSets();
+        createPipelines();
+        buildClusters();
+        if (asyncCompute)
+            createCommandBuffers();
+    }
+
+    ClusteredLighting::~ClusteredLighting() {
+        computeCommandBuffers.clear();
+        vkDestroyPipeline(device->device, cullingPipeline, nullptr);
+        vkDestroyPipeline(device->device, buildPipeline, nullptr);
+        vkDestroyPipelineLayout(device->device, pipelineLayout, nullptr);
+    }
+
+    void ClusteredLighting::update(uint32_t imageIndex, const Camera &camera, const std::vector<PointLight> &lights) {
+        const auto count = static_cast<uint32_t>(std::min<size_t>(lights.size(), maxLights));
+        if (count < lights.size())
+            logger.warning("Scene has {} lights but only {} are supported, the rest are ignored", lights.size(),
+                           maxLights);
+
+        parameters.view = camera.getView();
+        parameters.gridSize.w = count;
+        parameterBuffers[imageIndex].write(&parameters, sizeof(Parameters), 0);
+        if (count > 0)
+            lightBuffers[imageIndex].write(lights.data(), count * sizeof(PointLight), 0);
+    }
+
+    void ClusteredLighting::recordCulling(CommandBuffer &commandBuffer, uint32_t imageIndex) const {
+        if (asyncCompute) {
+            commandBuffer.cmdAcquireBuffers({gridBuffers[imageIndex].getBuffer(), indexBuffers[imageIndex].getBuffer()},
+                                            QueueType::COMPUTE, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                            VK_ACCESS_SHADER_READ_BIT);
+            return;
+        }
+
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        recordDispatch(commandBuffer, imageIndex);
+        commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                                         {barrier}, {}, {});
+    }
+
+    VkSemaphore ClusteredLighting::submitCulling(uint32_t imageIndex) {
+        if (!asyncCompute)
+            return VK_NULL_HANDLE;
+
+        const VkSemaphore semaphore = cullingSemaphores[imageIndex]->getSemaphore();
+        computeCommandBuffers[imageIndex]->submit({}, {semaphore}, {});
+        return semaphore;
+    }
+
+    void ClusteredLighting::recordDispatch(CommandBuffer &commandBuffer, uint32_t imageIndex) const {
+        commandBuffer
+                .cmdBindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, cullingPipeline)
+                .cmdBindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0,
+                                       {descriptorSets[imageIndex]}, {})
+                .cmdDispatch((clusterCount + 127) / 128, 1, 1);
+    }
+
+    void ClusteredLighting::createCommandBuffers() {
+        computeCommandBuffers.reserve(imageCount);
+        cullingSemaphores.reserve(imageCount);
+        for (uint32_t i = 0; i < imageCount; i++) {
+            cullingSemaphores.push_back(std::make_unique<Semaphore>(device));
+
+            auto &commandBuffer = *computeCommandBuffers.emplace_back(
+                    std::make_unique<CommandBuffer>(device, QueueType::COMPUTE));
+            commandBuffer.recordSimultaneous();
+            recordDispatch(commandBuffer, i);
+            /// The light lists are rewritten every frame, so ownership is never returned to the compute queue and
+            /// their previous contents are simply discarded
+            commandBuffer
+                    .cmdReleaseBuffers({gridBuffers[i].getBuffer(), indexBuffers[i].getBuffer()}, QueueType::GRAPHICS,
+                                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT)
+                    .stop();
+        }
+        logger.trace("Light culling runs on the async compute queue");
+    }
+
+    VkDescriptorSetLayout ClusteredLighting::getDescriptorSetLayout() const {
+        return descriptorSetLayout->getDescriptorSetLayout();
+    }
+
+    VkDescriptorSet ClusteredLighting::getDescriptorSet(uint32_t imageIndex) const {
+        return descriptorSets[imageIndex];
+    }
+
+    void ClusteredLighting::createBuffers() {
+        clusterBuffer = std::make_unique<Buffer>(device, clusterCount * 2 * sizeof(glm::vec4),
+                                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+
+        parameterBuffers.reserve(imageCount);
+        lightBuffers.reserve(imageCount);
+        gridBuffers.reserve(imageCount);
+        indexBuffers.reserve(imageCount);
+        for (uint32_t i = 0; i < imageCount; i++) {
+            /// Written by the host and read on both queues every frame
+            parameterBuffers.emplace_back(device, sizeof(Parameters), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                          VMA_MEMORY_USAGE_CPU_TO_GPU,
+                                          std::vector<QueueType>{QueueType::GRAPHICS, QueueType::COMPUTE});
+            parameterBuffers[i].write(&parameters, sizeof(Parameters), 0);
+            lightBuffers.emplace_back(device, maxLights * sizeof(PointLight), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                      VMA_MEMORY_USAGE_CPU_TO_GPU,
+                                      std::vector<QueueType>{QueueType::GRAPHICS, QueueType::COMPUTE});
+            gridBuffers.emplace_back(device, clusterCount * sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                     VMA_MEMORY_USAGE_GPU_ONLY);
+            indexBuffers.emplace_back(device, clusterCount * maxLightsPerCluster * sizeof(uint32_t),
+                                      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+        }
+    }
+
+    void ClusteredLighting::createDescriptorSets() {
+        const VkShaderStageFlags shared = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        const std::vector<std::pair<VkDescriptorType, VkShaderStageFlags>> descriptors{
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, shared},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, shared},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, shared},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, shared}
+        };
+
+        std::vector<VkDescriptorSetLayoutBinding> bindings{};
+        for (uint32_t i = 0; i < descriptors.size(); i++) {
+            VkDescriptorSetLayoutBinding binding{};
+            binding.binding = i;
+            binding.descriptorType = descriptors[i].first;
+            binding.descriptorCount = 1;
+            binding.stageFlags = descriptors[i].second;
+            binding.pImmutableSamplers = nullptr;
+
+            bindings.push_back(binding);
+        }
+        descriptorSetLayout = std::make_unique<DescriptorSetLayout>(device, bindings);
+
+        descriptorPool = std::make_unique<DescriptorPool>(device, std::vector<VkDescriptorPoolSize>{
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, imageCount},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * imageCount}
+        }, imageCount);
+        descriptorSets = descriptorPool->createSets(std::vector<VkDescriptorSetLayout>(
+                imageCount, descriptorSetLayout->getDescriptorSetLayout()));
+
+        for (uint32_t i = 0; i < imageCount; i++) {
+            std::array<VkDescriptorBufferInfo, 5> buffers{};
+            buffers[0] = {parameterBuffers[i].getBuffer(), 0, sizeof(Parameters)};
+            buffers[1] = {lightBuffers[i].getBuffer(), 0, VK_WHOLE_SIZE};
+            buffers[2] = {clusterBuffer->getBuffer(), 0, VK_WHOLE_SIZE};
+            buffers[3] = {gridBuffers[i].getBuffer(), 0, VK_WHOLE_SIZE};
+            buffers[4] = {indexBuffers[i].getBuffer(), 0, VK_WHOLE_SIZE};
+
+            std::array<VkWriteDescriptorSet, 5> writes{};
+            for (uint32_t j = 0; j < writes.size(); j++) {
+                writes[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[j].dstSet = descriptorSets[i];
+                writes[j].dstBinding = j;
+                writes[j].dstArrayElement = 0;
+                writes[j].descriptorType = descriptors[j].first;
+                writes[j].descriptorCount = 1;
+                writes[j].pBufferInfo = &buffers[j];
+            }
+            vkUpdateDescriptorSets(device->device, writes.size(), writes.data(), 0, nullptr);
+        }
+    }
+
+    void ClusteredLighting::createPipelines() {
+        buildModule = ShaderModule::Builder(device)
+                .setShaderStage(VK_SHADER_STAGE_COMPUTE_BIT)
+                .setBytecode("clusters.spv")
+                .build();
+        cullingModule = ShaderModule::Builder(device)
+                .setShaderStage(VK_SHADER_STAGE_COMPUTE_BIT)
+                .setBytecode("light_culling.spv")
+                .build();
+
+        auto layout = descriptorSetLayout->getDescriptorSetLayout();
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 1;
+        pipelineLayoutCreateInfo.pSetLayouts = &layout;
+
+        VK_CHECK_RESULT(vkCreatePipelineLayout(device->device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout))
+
+        std::array<VkComputePipelineCreateInfo, 2> createInfos{};
+        const std::array<std::shared_ptr<const ShaderModule>, 2> modules{buildModule, cullingModule};
+        for (size_t i = 0; i < createInfos.size(); i++) {
+            createInfos[i].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            createInfos[i].stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            createInfos[i].stage.stage = modules[i]->getStage();
+            createInfos[i].stage.module = modules[i]->getModule();
+            createInfos[i].stage.pName = modules[i]->getEntryPoint().c_str();
+            createInfos[i].layout = pipelineLayout;
+            createInfos[i].basePipelineIndex = -1;
+        }
+
+        std::array<VkPipeline, 2> pipelines{};
+        VK_CHECK_RESULT(vkCreateComputePipelines(device->device, VK_NULL_HANDLE, createInfos.size(),
+                                                 createInfos.data(), nullptr, pipelines.data()))
+        buildPipeline = pipelines[0];
+        cullingPipeline = pipelines[1];
+        logger.trace("Successfully created cluster pipelines");
+    }
+
+    void ClusteredLighting::buildClusters() {
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        CommandBuffer(device, QueueType::COMPUTE)
+                .recordSingleUsage()
+                .cmdBindPipeline(VK_PIPELINE_BIND_POINT_COMPUTE, buildPipeline)
+                .cmdBindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, {descriptorSets[0]}, {})
+                .cmdDispatch(gridWidth, gridHeight, gridDepth)
+                .cmdPipelineBarrier(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                                    {barrier}, {}, {})
+                .submit();
+        logger.trace("Built {} light clusters", clusterCount);
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "LogicalDevice.h"
+#include "Buffer.h"
+#include "CommandBuffer.h"
+#include "Semaphore.h"
+#include "DescriptorSetLayout.h"
+#include "DescriptorPool.h"
+#include "ShaderModule.h"
+#include "Camera.h"
+#include "Light.h"
+
+namespace Vixen {
+    /**
+     * Clustered forward lighting. The view frustum is divided into a grid of froxel clusters, a compute pass assigns
+     * every point light to the clusters it touches and the fragment shader only iterates the lights of its own cluster.
+     * When the device has a separate compute queue family the culling runs on the async compute queue and overlaps with
+     * the graphics work of earlier frames.
+     */
+    class ClusteredLighting {
+        const Logger logger{"ClusteredLighting"};
+
+        /**
+         * The uniform block shared by the cluster build, light culling and fragment shaders, std140 layout
+         */
+        struct Parameters {
+            glm::mat4 inverseProjection;
+            glm::mat4 view;
+            /// x, y and z are the cluster grid dimensions, w is the number of lights
+            glm::uvec4 gridSize;
+            /// xy is the tile size in pixels, zw the screen size in pixels
+            glm::vec4 screen;
+            /// x is the near plane, y the far plane, z and w the depth slice scale and bias
+            glm::vec4 planes;
+        };
+
+        const std::shared_ptr<LogicalDevice> device;
+
+        const uint32_t imageCount;
+
+        /**
+         * Whether culling is submitted to the compute queue instead of being recorded into the graphics command buffer
+         */
+        const bool asyncCompute;
+
+        Parameters parameters{};
+
+        std::unique_ptr<DescriptorSetLayout> descriptorSetLayout;
+
+        std::unique_ptr<DescriptorPool> descriptorPool;
+
+        std::vector<VkDescriptorSet> descriptorSets;
+
+        /**
+         * The view space bounding boxes of every cluster, these only change when the projection does
+         */
+        std::unique_ptr<Buffer> clusterBuffer;
+
+        std::vector<Buffer> parameterBuffers;
+
+        std::vector<Buffer> lightBuffers;
+
+        std::vector<Buffer> gridBuffers;
+
+        std::vector<Buffer> indexBuffers;
+
+        std::shared_ptr<const ShaderModule> buildModule;
+
+        std::shared_ptr<const ShaderModule> cullingModule;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+        VkPipeline buildPipeline = VK_NULL_HANDLE;
+
+        VkPipeline cullingPipeline = VK_NULL_HANDLE;
+
+        std::vector<std::unique_ptr<CommandBuffer>> computeCommandBuffers;
+
+        /**
+         * Signalled by the compute queue when the light lists of a swap chain image are ready
+         */
+        std::vector<std::unique_ptr<Semaphore>> cullingSemaphores;
+
+        void createBuffers();
+
+        void createDescriptorSets();
+
+        void createPipelines();
+
+        void buildClusters();
+
+        void createCommandBuffers();
+
+        void recordDispatch(CommandBuffer &commandBuffer, uint32_t imageIndex) const;
+
+    public:
+        static constexpr uint32_t gridWidth = 16;
+
+        static constexpr uint32_t gridHeight = 9;
+
+        static constexpr uint32_t gridDepth = 24;
+
+        static constexpr uint32_t clusterCount = gridWidth * gridHeight * gridDepth;
+
+        /**
+         * The maximum number of lights uploaded per frame, any lights beyond this are ignored
+         */
+        static constexpr uint32_t maxLights = 4096;
+
+        /**
+         * Must match MAX_LIGHTS_PER_CLUSTER in the light culling and fragment shaders
+         */
+        static constexpr uint32_t maxLightsPerCluster = 256;
+
+        /**
+         * Creates the cluster grid for a camera and builds the cluster bounds for the current swap chain extent
+         *
+         * @param[in] device The device to create the lighting resources on
+         * @param[in] camera The camera the clusters are built for, only its projection is used
+         * @param[in] imageCount The amount of swap chain images, every image gets its own light lists
+         */
+        ClusteredLighting(const std::shared_ptr<LogicalDevice> &device, const Camera &camera, uint32_t imageCount);
+
+        ClusteredLighting(const ClusteredLighting &) = delete;
+
+        ClusteredLighting &operator=(const ClusteredLighting &) = delete;
+
+        ~ClusteredLighting();
+
+        /**
+         * Uploads the lights and the camera view for a swap chain image, the image must not be in use by the GPU
+         */
+        void update(uint32_t imageIndex, const Camera &camera, const std::vector<PointLight> &lights);
+
+        /**
+         * Records the light culling dispatch into a graphics command buffer, or the acquire of the light lists when
+         * culling runs on the compute queue. Must be recorded outside of a render pass and before any fragment shader
+         * reads the light lists.
+         */
+        void recordCulling(CommandBuffer &commandBuffer, uint32_t imageIndex) const;
+
+        /**
+         * Submits the light culling of a swap chain image to the compute queue, call after update
+         *
+         * @return The semaphore the graphics submission must wait on at the fragment shader stage, or VK_NULL_HANDLE
+         * when culling is recorded into the graphics command buffer
+         */
+        VkSemaphore submitCulling(uint32_t imageIndex);
+
+        [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayout() const;
+
+        [[nodiscard]] VkDescriptorSet getDescriptorSet(uint32_t imageIndex) const;
+    };
+}
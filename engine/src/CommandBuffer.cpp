@@ -1,11 +1,12 @@
 #include "CommandBuffer.h"
 
 namespace Vixen {
-    CommandBuffer::CommandBuffer(const std::shared_ptr<LogicalDevice> &device) : device(device), fence(device) {
+    CommandBuffer::CommandBuffer(const std::shared_ptr<LogicalDevice> &device, QueueType type)
+            : device(device), type(type), pool(device->getCommandPool(type)), fence(device) {
         VkCommandBufferAllocateInfo allocateInfo = {};
         allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocateInfo.commandPool = device->commandPool;
+        allocateInfo.commandPool = pool;
         allocateInfo.commandBufferCount = 1;
 
         VK_CHECK_RESULT(vkAllocateCommandBuffers(device->device, &allocateInfo, &buffer))
@@ -19,7 +20,7 @@ namespace Vixen {
         if (!fence.isReady())
             fence.waitAndReset();
 
-        vkFreeCommandBuffers(device->device, device->commandPool, 1, &buffer);
+        vkFreeCommandBuffers(device->device, pool, 1, &buffer);
     }
 
     void
@@ -43,13 +44,21 @@ namespace Vixen {
         submitInfo.signalSemaphoreCount = signalSemaphores.size();
         submitInfo.pSignalSemaphores = signalSemaphores.data();
 
-        fence.submit(device->graphicsQueue, submitInfo);
+        fence.submit(device->getQueue(type), submitInfo);
     }
 
     void CommandBuffer::wait() {
         fence.wait();
     }
 
+    bool CommandBuffer::isComplete() {
+        return fence.isReady();
+    }
+
+    QueueType CommandBuffer::getQueueType() const {
+        return type;
+    }
+
     CommandBuffer &CommandBuffer::record(VkCommandBufferUsageFlags usage) {
         if (recording)
             throw std::runtime_error("Already recording");
@@ -100,6 +109,27 @@ namespace Vixen {
         return *this;
     }
 
+    CommandBuffer &CommandBuffer::cmdCopyImage(VkImage source, VkImageLayout sourceLayout, VkImage destination,
+                                               VkImageLayout destinationLayout,
+                                               const std::vector<VkImageCopy> &regions) {
+        if (!recording)
+            throw std::runtime_error("Command buffer is not recording");
+
+        vkCmdCopyImage(buffer, source, sourceLayout, destination, destinationLayout, regions.size(), regions.data());
+        return *this;
+    }
+
+    CommandBuffer &CommandBuffer::cmdBlitImage(VkImage source, VkImageLayout sourceLayout, VkImage destination,
+                                               VkImageLayout destinationLayout,
+                                               const std::vector<VkImageBlit> &regions, VkFilter filter) {
+        if (!recording)
+            throw std::runtime_error("Command buffer is not recording");
+
+        vkCmdBlitImage(buffer, source, sourceLayout, destination, destinationLayout, regions.size(), regions.data(),
+                       filter);
+        return *this;
+    }
+
     CommandBuffer &
     CommandBuffer::cmdPipelineBarrier(VkPipelineStageFlags sourceStages, VkPipelineStageFlags destinationStages,
                                       VkDependencyFlags dependencies, const std::vector<VkMemoryBarrier> &barriers,
@@ -187,6 +217,76 @@ namespace Vixen {
         return *this;
     }
 
+    CommandBuffer &CommandBuffer::cmdDispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+        if (!recording)
+            throw std::runtime_error("Command buffer is not recording");
+
+        vkCmdDispatch(buffer, groupCountX, groupCountY, groupCountZ);
+        return *this;
+    }
+
+    CommandBuffer &CommandBuffer::cmdResetQueryPool(VkQueryPool pool, uint32_t firstQuery, uint32_t queryCount) {
+        if (!recording)
+            throw std::runtime_error("Command buffer is not recording");
+
+        vkCmdResetQueryPool(buffer, pool, firstQuery, queryCount);
+        return *this;
+    }
+
+    CommandBuffer &CommandBuffer::cmdWriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool pool, uint32_t query) {
+        if (!recording)
+            throw std::runtime_error("Command buffer is not recording");
+
+        vkCmdWriteTimestamp(buffer, stage, pool, query);
+        return *this;
+    }
+
+    CommandBuffer &CommandBuffer::cmdReleaseBuffers(const std::vector<VkBuffer> &buffers, QueueType destination,
+                                                    VkPipelineStageFlags sourceStages, VkAccessFlags sourceAccess) {
+        const uint32_t sourceFamily = device->getQueueFamilyIndex(type);
+        const uint32_t destinationFamily = device->getQueueFamilyIndex(destination);
+        if (sourceFamily == destinationFamily)
+            return *this;
+
+        std::vector<VkBufferMemoryBarrier> barriers(buffers.size());
+        for (size_t i = 0; i < buffers.size(); i++) {
+            barriers[i].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barriers[i].srcAccessMask = sourceAccess;
+            barriers[i].dstAccessMask = 0;
+            barriers[i].srcQueueFamilyIndex = sourceFamily;
+            barriers[i].dstQueueFamilyIndex = destinationFamily;
+            barriers[i].buffer = buffers[i];
+            barriers[i].offset = 0;
+            barriers[i].size = VK_WHOLE_SIZE;
+        }
+
+        return cmdPipelineBarrier(sourceStages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, {}, barriers, {});
+    }
+
+    CommandBuffer &CommandBuffer::cmdAcquireBuffers(const std::vector<VkBuffer> &buffers, QueueType source,
+                                                    VkPipelineStageFlags destinationStages,
+                                                    VkAccessFlags destinationAccess) {
+        const uint32_t sourceFamily = device->getQueueFamilyIndex(source);
+        const uint32_t destinationFamily = device->getQueueFamilyIndex(type);
+        if (sourceFamily == destinationFamily)
+            return *this;
+
+        std::vector<VkBufferMemoryBarrier> barriers(buffers.size());
+        for (size_t i = 0; i < buffers.size(); i++) {
+            barriers[i].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barriers[i].srcAccessMask = 0;
+            barriers[i].dstAccessMask = destinationAccess;
+            barriers[i].srcQueueFamilyIndex = sourceFamily;
+            barriers[i].dstQueueFamilyIndex = destinationFamily;
+            barriers[i].buffer = buffers[i];
+            barriers[i].offset = 0;
+            barriers[i].size = VK_WHOLE_SIZE;
+        }
+
+        /// The source stages match the semaphore wait stages so the acquire is chained after the release
+        return cmdPipelineBarrier(destinationStages, destinationStages, 0, {}, barriers, {});
+    }
+
     CommandBuffer &
     CommandBuffer::cmdPushConstants(VkPipelineLayout layout, VkPipelineStageFlags stages, uint32_t offset,
                                     uint32_t size, const void *values) {
@@ -10,6 +10,13 @@ namespace Vixen {
 
         const std::shared_ptr<LogicalDevice> device;
 
+        const QueueType type;
+
+        /**
+         * The pool of the thread that allocated the command buffer, it must only be recorded on that thread
+         */
+        const VkCommandPool pool;
+
         VkCommandBuffer buffer{};
 
         bool recording = false;
@@ -19,7 +26,11 @@ namespace Vixen {
         CommandBuffer &record(VkCommandBufferUsageFlags usage);
 
     public:
-        explicit CommandBuffer(const std::shared_ptr<LogicalDevice> &device);
+        /**
+         * @param[in] device The device to allocate the command buffer on
+         * @param[in] type The queue this command buffer is submitted to, it is allocated from that queue's pool
+         */
+        explicit CommandBuffer(const std::shared_ptr<LogicalDevice> &device, QueueType type = QueueType::GRAPHICS);
 
         CommandBuffer(const CommandBuffer &) = delete;
 
@@ -34,6 +45,13 @@ namespace Vixen {
 
         void wait();
 
+        /**
+         * Whether the last submission of this command buffer has finished executing
+         */
+        [[nodiscard]] bool isComplete();
+
+        [[nodiscard]] QueueType getQueueType() const;
+
         CommandBuffer &recordSingleUsage();
 
         CommandBuffer &recordSimultaneous();
@@ -45,6 +63,13 @@ namespace Vixen {
         CommandBuffer &cmdCopyBufferToImage(VkBuffer source, VkImage destination, VkImageLayout layout,
                                             const std::vector<VkBufferImageCopy> &regions);
 
+        CommandBuffer &cmdCopyImage(VkImage source, VkImageLayout sourceLayout, VkImage destination,
+                                    VkImageLayout destinationLayout, const std::vector<VkImageCopy> &regions);
+
+        CommandBuffer &cmdBlitImage(VkImage source, VkImageLayout sourceLayout, VkImage destination,
+                                    VkImageLayout destinationLayout, const std::vector<VkImageBlit> &regions,
+                                    VkFilter filter);
+
         CommandBuffer &cmdPipelineBarrier(VkPipelineStageFlags sourceStages, VkPipelineStageFlags destinationStages,
                                           VkDependencyFlags dependencies, const std::vector<VkMemoryBarrier> &barriers,
                                           const std::vector<VkBufferMemoryBarrier> &bufferBarriers,
@@ -69,6 +94,27 @@ namespace Vixen {
         cmdDrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset,
                        uint32_t firstInstance);
 
+        CommandBuffer &cmdDispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+
+        CommandBuffer &cmdResetQueryPool(VkQueryPool pool, uint32_t firstQuery, uint32_t queryCount);
+
+        CommandBuffer &cmdWriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool pool, uint32_t query);
+
+        /**
+         * Releases ownership of buffers to another queue family. The destination must record the matching
+         * cmdAcquireBuffers after waiting on a semaphore signalled by this command buffer's submission. Nothing is
+         * recorded when both queues share a family.
+         */
+        CommandBuffer &cmdReleaseBuffers(const std::vector<VkBuffer> &buffers, QueueType destination,
+                                         VkPipelineStageFlags sourceStages, VkAccessFlags sourceAccess);
+
+        /**
+         * Acquires ownership of buffers released by another queue family. The submission must wait on the releasing
+         * submission's semaphore at the given stages. Nothing is recorded when both queues share a family.
+         */
+        CommandBuffer &cmdAcquireBuffers(const std::vector<VkBuffer> &buffers, QueueType source,
+                                         VkPipelineStageFlags destinationStages, VkAccessFlags destinationAccess);
+
         CommandBuffer &
         cmdPushConstants(VkPipelineLayout layout, VkPipelineStageFlags stages, uint32_t offset, uint32_t size,
                          const void *values);
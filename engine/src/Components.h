@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include "Mesh.h"
+#include "TransformHierarchy.h"
+
+namespace Vixen {
+    /**
+     * The node of an entity in the scene's transform hierarchy, its world matrix places the entity
+     */
+    struct Transform {
+        TransformNode node;
+    };
+
+    struct MeshRenderer {
+        std::shared_ptr<Mesh> mesh;
+    };
+
+    /**
+     * Tags entities that rarely move, they are the only ones drawn into cached shadow cascades
+     */
+    struct Static {
+    };
+}
@@ -23,6 +23,7 @@ namespace Vixen {
 
     void Fence::submit(VkQueue queue, const VkSubmitInfo &info) {
         reset();
+        std::scoped_lock lock(device->queueMutex);
         vkQueueSubmit(queue, 1, &info, fence);
     }
 
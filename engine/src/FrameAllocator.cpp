@@ -0,0 +1,92 @@
+#include "FrameAllocator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Vixen {
+    namespace {
+        /// Every limit is a power of two of at most 256, so sizes rounded to it keep every region aligned
+        VkDeviceSize roundRegion(VkDeviceSize size) {
+            return (std::max<VkDeviceSize>(size, 1) + 255) / 256 * 256;
+        }
+    }
+
+    FrameAllocator::FrameAllocator(const std::shared_ptr<LogicalDevice> &device, uint32_t frameCount,
+                                   VkDeviceSize frameSize)
+            : device(device),
+              uniformAlignment(std::max<VkDeviceSize>(
+                      device->physicalDevice->deviceProperties.limits.minUniformBufferOffsetAlignment, 1)),
+              storageAlignment(std::max<VkDeviceSize>(
+                      device->physicalDevice->deviceProperties.limits.minStorageBufferOffsetAlignment, 1)) {
+        if (frameCount == 0)
+            throw std::runtime_error("A frame allocator needs at least one frame");
+
+        regions.reserve(frameCount);
+        for (uint32_t i = 0; i < frameCount; i++)
+            regions.push_back(createRegion(roundRegion(frameSize)));
+        end = regions[0].buffer->getSize();
+    }
+
+    FrameAllocator::Region FrameAllocator::createRegion(VkDeviceSize size) const {
+        auto buffer = std::make_unique<Buffer>(device, size,
+                                               VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                               VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                                               VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        auto *data = static_cast<char *>(buffer->map());
+        return {std::move(buffer), data};
+    }
+
+    bool FrameAllocator::reset(uint32_t frame, VkDeviceSize required) {
+        if (frame >= regions.size())
+            throw std::runtime_error("Frame is out of range");
+
+        /// Growing by at least half keeps a slowly growing scene from replacing the region every frame
+        auto &region = regions[frame];
+        const VkDeviceSize size = region.buffer->getSize();
+        const bool grow = required > size;
+        if (grow)
+            region = createRegion(roundRegion(std::max(required, size + size / 2)));
+
+        this->frame = frame;
+        head = 0;
+        end = region.buffer->getSize();
+        return grow;
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+        const VkDeviceSize offset = (head + alignment - 1) & ~(alignment - 1);
+        if (offset + size > end)
+            throw std::runtime_error("Frame allocator is out of memory");
+
+        head = offset + size;
+        return {regions[frame].buffer->getBuffer(), offset, regions[frame].data + offset};
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocateUniform(VkDeviceSize size) {
+        return allocate(size, uniformAlignment);
+    }
+
+    FrameAllocator::Allocation FrameAllocator::allocateStorage(VkDeviceSize size) {
+        return allocate(size, storageAlignment);
+    }
+
+    VkDeviceSize FrameAllocator::getUniformFootprint(VkDeviceSize size) const {
+        return (size + uniformAlignment - 1) & ~(uniformAlignment - 1);
+    }
+
+    void FrameAllocator::flush() {
+        if (head > 0)
+            regions[frame].buffer->flush(0, head);
+    }
+
+    VkBuffer FrameAllocator::getBuffer(uint32_t frame) const {
+        return regions[frame].buffer->getBuffer();
+    }
+
+    VkDeviceSize FrameAllocator::getFrameSize(uint32_t frame) const {
+        return regions[frame].buffer->getSize();
+    }
+
+    VkDeviceSize FrameAllocator::getUsed() const {
+        return head;
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "LogicalDevice.h"
+#include "Buffer.h"
+
+namespace Vixen {
+    /**
+     * Hands out slices of persistently mapped buffers for data that only lives for a single frame, like uniforms,
+     * instance data and indirect arguments. Every frame has a region of its own, allocations bump a pointer through the
+     * region of the current frame and the whole region is reset at once when the frame is reused. Allocating never
+     * calls into the driver.
+     *
+     * Each region is a buffer of its own, so a frame that needs more memory than its region holds grows it when it is
+     * reset, while the regions of the frames still in flight stay untouched.
+     */
+    class FrameAllocator {
+    public:
+        struct Allocation {
+            VkBuffer buffer;
+
+            /// The offset from the start of the buffer, used as the dynamic offset when binding it
+            VkDeviceSize offset;
+
+            void *data;
+        };
+
+    private:
+        struct Region {
+            std::unique_ptr<Buffer> buffer;
+
+            char *data;
+        };
+
+        const std::shared_ptr<LogicalDevice> device;
+
+        std::vector<Region> regions;
+
+        const VkDeviceSize uniformAlignment;
+
+        const VkDeviceSize storageAlignment;
+
+        uint32_t frame = 0;
+
+        VkDeviceSize head = 0;
+
+        VkDeviceSize end = 0;
+
+        [[nodiscard]] Region createRegion(VkDeviceSize size) const;
+
+    public:
+        /**
+         * @param[in] frameCount The amount of frames that can be in flight at once, each gets its own region
+         * @param[in] frameSize The bytes initially available to every frame
+         */
+        FrameAllocator(const std::shared_ptr<LogicalDevice> &device, uint32_t frameCount,
+                       VkDeviceSize frameSize = 4 * 1024 * 1024);
+
+        FrameAllocator(const FrameAllocator &) = delete;
+
+        FrameAllocator &operator=(const FrameAllocator &) = delete;
+
+        /**
+         * Starts allocating from the region of a frame, discarding everything allocated from it before. The command
+         * buffers of the last frame that used the region must have completed.
+         *
+         * @param[in] required The bytes the frame is going to allocate, the region is replaced by a larger buffer when
+         * it holds less
+         * @return Whether the region was replaced, descriptors referring to the buffer of the frame must be written
+         * again
+         */
+        bool reset(uint32_t frame, VkDeviceSize required = 0);
+
+        /**
+         * Allocates from the region of the current frame, throws when the region is full. Reserve the memory a frame
+         * needs when resetting it instead of relying on this.
+         *
+         * @param[in] alignment The alignment of the offset, must be a power of two
+         */
+        Allocation allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        /**
+         * Allocates a slice that can be bound as a dynamic uniform buffer
+         */
+        Allocation allocateUniform(VkDeviceSize size);
+
+        /**
+         * Allocates a slice that can be bound as a dynamic storage buffer
+         */
+        Allocation allocateStorage(VkDeviceSize size);
+
+        /**
+         * The bytes a uniform allocation takes from a region including its alignment, for working out what to reserve
+         */
+        [[nodiscard]] VkDeviceSize getUniformFootprint(VkDeviceSize size) const;
+
+        /**
+         * Makes the writes to the current frame's region visible to the device, this does nothing when the buffer is
+         * host coherent. Call it before submitting the frame.
+         */
+        void flush();
+
+        /**
+         * The buffer backing the region of a frame, it changes when the region grows
+         */
+        [[nodiscard]] VkBuffer getBuffer(uint32_t frame) const;
+
+        [[nodiscard]] VkDeviceSize getFrameSize(uint32_t frame) const;
+
+        /**
+         * The bytes allocated from the current frame's region so far, including alignment padding
+         */
+        [[nodiscard]] VkDeviceSize getUsed() const;
+    };
+}
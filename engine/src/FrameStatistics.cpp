@@ -0,0 +1,143 @@
+#include "FrameStatistics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace Vixen {
+    FrameStatistics::FrameStatistics(size_t capacity, double hitchFactor) : hitchFactor(hitchFactor) {
+        if (hitchFactor <= 1.0)
+            throw std::runtime_error("The hitch factor must be larger than one");
+        resize(capacity);
+    }
+
+    void FrameStatistics::record(const FrameTiming &timing) {
+        std::scoped_lock lock(mutex);
+        if (frames.size() < capacity)
+            frames.push_back(timing);
+        else
+            frames[next] = timing;
+        next = (next + 1) % capacity;
+        recorded++;
+    }
+
+    FrameStatistics::Distribution FrameStatistics::summarize(std::vector<double> times) {
+        std::erase_if(times, [](double time) { return std::isnan(time); });
+        if (times.empty()) {
+            constexpr double none = std::numeric_limits<double>::quiet_NaN();
+            return {0, none, none, none, none, none, none};
+        }
+
+        std::sort(times.begin(), times.end());
+        /// Nearest rank, the percentile is a frame that actually happened
+        const auto percentile = [&](double fraction) {
+            const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(times.size())));
+            return times[std::clamp<size_t>(rank, 1, times.size()) - 1];
+        };
+        const size_t slowest = std::max<size_t>(times.size() / 100, 1);
+
+        return {
+                times.size(),
+                std::accumulate(times.begin(), times.end(), 0.0) / static_cast<double>(times.size()),
+                percentile(0.5),
+                percentile(0.95),
+                percentile(0.99),
+                times.back(),
+                std::accumulate(times.end() - static_cast<ptrdiff_t>(slowest), times.end(), 0.0) /
+                static_cast<double>(slowest)
+        };
+    }
+
+    FrameStatistics::Report FrameStatistics::report() const {
+        const auto kept = getFrames();
+        std::vector<double> cpu, gpu, present;
+        cpu.reserve(kept.size());
+        gpu.reserve(kept.size());
+        present.reserve(kept.size());
+        for (const auto &frame : kept) {
+            cpu.push_back(frame.cpu);
+            gpu.push_back(frame.gpu);
+            present.push_back(frame.present);
+        }
+
+        Report report{kept.size(), summarize(cpu), summarize(gpu), summarize(present), 0};
+        if (report.present.samples > 0) {
+            const double threshold = report.present.median * hitchFactor;
+            report.hitches = std::count_if(present.begin(), present.end(),
+                                           [threshold](double time) { return time > threshold; });
+        }
+        return report;
+    }
+
+    std::vector<FrameTiming> FrameStatistics::getFrames() const {
+        std::scoped_lock lock(mutex);
+        return copyFrames();
+    }
+
+    std::vector<FrameTiming> FrameStatistics::copyFrames() const {
+        if (frames.size() < capacity)
+            return frames;
+
+        std::vector<FrameTiming> ordered;
+        ordered.reserve(frames.size());
+        ordered.insert(ordered.end(), frames.begin() + static_cast<ptrdiff_t>(next), frames.end());
+        ordered.insert(ordered.end(), frames.begin(), frames.begin() + static_cast<ptrdiff_t>(next));
+        return ordered;
+    }
+
+    void FrameStatistics::writeCsv(std::ostream &stream) const {
+        uint64_t first;
+        std::vector<FrameTiming> kept;
+        {
+            std::scoped_lock lock(mutex);
+            first = recorded - frames.size();
+            kept = copyFrames();
+        }
+
+        const auto field = [&stream](double time) {
+            if (!std::isnan(time))
+                stream << time;
+        };
+        stream << "frame,cpu_ms,gpu_ms,present_ms,draws\n";
+        for (size_t i = 0; i < kept.size(); i++) {
+            stream << first + i << ',';
+            field(kept[i].cpu);
+            stream << ',';
+            field(kept[i].gpu);
+            stream << ',';
+            field(kept[i].present);
+            stream << ',' << kept[i].draws << '\n';
+        }
+    }
+
+    void FrameStatistics::clear() {
+        std::scoped_lock lock(mutex);
+        frames.clear();
+        next = 0;
+        recorded = 0;
+    }
+
+    void FrameStatistics::resize(size_t capacity) {
+        if (capacity == 0)
+            throw std::runtime_error("Frame statistics must keep at least one frame");
+
+        std::scoped_lock lock(mutex);
+        this->capacity = capacity;
+        frames.clear();
+        frames.shrink_to_fit();
+        frames.reserve(capacity);
+        next = 0;
+        recorded = 0;
+    }
+
+    size_t FrameStatistics::getCapacity() const {
+        std::scoped_lock lock(mutex);
+        return capacity;
+    }
+
+    uint64_t FrameStatistics::getRecordedCount() const {
+        std::scoped_lock lock(mutex);
+        return recorded;
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace Vixen {
+    /**
+     * The times of a single frame in milliseconds, NaN where a time could not be measured, and the work it recorded
+     */
+    struct FrameTiming {
+        /// The time the render thread spent recording and submitting the frame, waiting for the GPU left out
+        double cpu;
+
+        /// The time the GPU took from the start of the shadow pass until the end of the scene pass
+        double gpu;
+
+        /// The time since the previous frame was presented
+        double present;
+
+        /// The draw calls recorded for the frame, those of the shadow passes included
+        uint32_t draws;
+    };
+
+    /**
+     * Keeps the timings of the most recent frames in a ring buffer and summarizes them as percentiles. Averages hide
+     * stutter, a single frame taking ten times as long barely moves the frame rate but is plainly visible, so the
+     * report leads with the tail of the distribution.
+     *
+     * The render thread records frames while any other thread reports on them, recording only takes a short lock.
+     */
+    class FrameStatistics {
+    public:
+        struct Distribution {
+            /// The amount of frames the time was measured for
+            size_t samples;
+
+            double average;
+
+            double median;
+
+            double p95;
+
+            double p99;
+
+            double max;
+
+            /// The average of the slowest percent of the frames, the frame rate it works out to is the 1% low
+            double onePercentLow;
+        };
+
+        struct Report {
+            size_t frames;
+
+            Distribution cpu;
+
+            Distribution gpu;
+
+            Distribution present;
+
+            /// The frames presented more than the hitch factor times later than the median interval
+            size_t hitches;
+        };
+
+    private:
+        mutable std::mutex mutex;
+
+        size_t capacity;
+
+        std::vector<FrameTiming> frames;
+
+        /// The slot the next frame is recorded into, the oldest frame once the ring buffer is full
+        size_t next = 0;
+
+        uint64_t recorded = 0;
+
+        const double hitchFactor;
+
+        /**
+         * Copies the frames oldest first, the lock must be held
+         */
+        [[nodiscard]] std::vector<FrameTiming> copyFrames() const;
+
+        [[nodiscard]] static Distribution summarize(std::vector<double> times);
+
+    public:
+        /**
+         * @param[in] capacity The amount of frames kept, older frames are overwritten
+         * @param[in] hitchFactor How many times the median interval a present has to take to count as a hitch
+         */
+        explicit FrameStatistics(size_t capacity = 1024, double hitchFactor = 2.0);
+
+        void record(const FrameTiming &timing);
+
+        /**
+         * Summarizes the frames currently kept
+         */
+        [[nodiscard]] Report report() const;
+
+        /**
+         * Copies the frames currently kept, oldest first
+         */
+        [[nodiscard]] std::vector<FrameTiming> getFrames() const;
+
+        /**
+         * Writes the frames currently kept as CSV with a header row, times that were not measured are left empty
+         */
+        void writeCsv(std::ostream &stream) const;
+
+        void clear();
+
+        /**
+         * Changes the amount of frames kept and drops the frames recorded so far
+         */
+        void resize(size_t capacity);
+
+        [[nodiscard]] size_t getCapacity() const;
+
+        /**
+         * The amount of frames recorded since the last clear, including those overwritten since
+         */
+        [[nodiscard]] uint64_t getRecordedCount() const;
+    };
+}
@@ -0,0 +1,165 @@
+#include "GeometryArena.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Vixen {
+    GeometryArena::GeometryArena(const std::shared_ptr<LogicalDevice> &device, VkDeviceSize vertexBlockSize,
+                                 VkDeviceSize indexBlockSize)
+            : device(device),
+              vertices{"vertex", VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBlockSize},
+              indices{"index", VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                               VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBlockSize} {}
+
+    GeometryArena::Range GeometryArena::allocateVertices(VkDeviceSize size, VkDeviceSize alignment) {
+        return allocate(vertices, size, alignment);
+    }
+
+    GeometryArena::Range GeometryArena::allocateIndices(VkDeviceSize size, VkDeviceSize alignment) {
+        return allocate(indices, size, alignment);
+    }
+
+    void GeometryArena::freeVertices(const Range &range) {
+        free(vertices, range);
+    }
+
+    void GeometryArena::freeIndices(const Range &range) {
+        free(indices, range);
+    }
+
+    std::shared_ptr<LogicalDevice> GeometryArena::getDevice() const {
+        return device;
+    }
+
+    VkDeviceSize GeometryArena::getUsed() {
+        std::scoped_lock lock(mutex);
+        return vertices.used + indices.used;
+    }
+
+    VkDeviceSize GeometryArena::getCapacity() {
+        std::scoped_lock lock(mutex);
+        VkDeviceSize capacity = 0;
+        for (const auto *pool : {&vertices, &indices})
+            for (const auto &block : pool->blocks)
+                if (block)
+                    capacity += block->buffer.getSize();
+        return capacity;
+    }
+
+    bool GeometryArena::isFragmented() {
+        std::scoped_lock lock(mutex);
+        for (const auto *pool : {&vertices, &indices}) {
+            VkDeviceSize capacity = 0;
+            for (const auto &block : pool->blocks)
+                if (block)
+                    capacity += block->buffer.getSize();
+            if (capacity - pool->used >= pool->blockSize)
+                return true;
+        }
+        return false;
+    }
+
+    VkDeviceSize GeometryArena::trim() {
+        std::scoped_lock lock(mutex);
+        VkDeviceSize released = 0;
+        for (auto *pool : {&vertices, &indices}) {
+            /// The first block is kept so loading the next mesh does not create it again
+            for (size_t i = 1; i < pool->blocks.size(); i++) {
+                auto &block = pool->blocks[i];
+                if (!block || block->free.size() != 1 || block->free.begin()->second != block->buffer.getSize())
+                    continue;
+
+                released += block->buffer.getSize();
+                logger.trace("Released {} block {} of {} bytes", pool->name, i, block->buffer.getSize());
+                block = nullptr;
+            }
+        }
+        return released;
+    }
+
+    GeometryArena::Range GeometryArena::allocate(Pool &pool, VkDeviceSize size, VkDeviceSize alignment) {
+        if (size == 0)
+            return {};
+        if (alignment == 0)
+            throw std::runtime_error("Geometry alignment must not be zero");
+
+        std::scoped_lock lock(mutex);
+        for (uint32_t i = 0; i < pool.blocks.size(); i++) {
+            if (!pool.blocks[i])
+                continue;
+            if (const auto range = allocate(*pool.blocks[i], i, size, alignment)) {
+                pool.used += size;
+                return range.value();
+            }
+        }
+
+        /// Slots of trimmed blocks are reused so the indices of the remaining blocks stay the same
+        auto slot = std::find(pool.blocks.begin(), pool.blocks.end(), nullptr);
+        if (slot == pool.blocks.end())
+            slot = pool.blocks.insert(slot, nullptr);
+        const auto index = static_cast<uint32_t>(slot - pool.blocks.begin());
+
+        /// Meshes larger than a block get one of their own, it is reused like any other block once they are freed
+        const VkDeviceSize blockSize = std::max(pool.blockSize, size);
+        *slot = std::make_unique<Block>(Block{
+                Buffer(device, blockSize, pool.usage, VMA_MEMORY_USAGE_GPU_ONLY,
+                       {QueueType::GRAPHICS, QueueType::TRANSFER}),
+                {{0, blockSize}}
+        });
+        logger.trace("Created {} block {} of {} bytes", pool.name, index, blockSize);
+
+        pool.used += size;
+        return allocate(**slot, index, size, alignment).value();
+    }
+
+    std::optional<GeometryArena::Range> GeometryArena::allocate(Block &block, uint32_t index, VkDeviceSize size,
+                                                                VkDeviceSize alignment) {
+        for (auto entry = block.free.begin(); entry != block.free.end(); ++entry) {
+            const auto [offset, length] = *entry;
+            /// Strides are not always powers of two, so round up to the next multiple
+            const VkDeviceSize aligned = (offset + alignment - 1) / alignment * alignment;
+            if (aligned + size > offset + length)
+                continue;
+
+            block.free.erase(entry);
+            if (aligned > offset)
+                block.free.emplace(offset, aligned - offset);
+            if (aligned + size < offset + length)
+                block.free.emplace(aligned + size, offset + length - aligned - size);
+            return Range{&block.buffer, index, aligned, size};
+        }
+        return std::nullopt;
+    }
+
+    void GeometryArena::free(Pool &pool, const Range &range) {
+        if (range.size == 0)
+            return;
+
+        std::scoped_lock lock(mutex);
+        if (range.block >= pool.blocks.size() || !pool.blocks[range.block] ||
+            &pool.blocks[range.block]->buffer != range.buffer)
+            throw std::runtime_error("Range was not allocated from this arena");
+
+        auto &free = pool.blocks[range.block]->free;
+        VkDeviceSize offset = range.offset;
+        VkDeviceSize size = range.size;
+
+        const auto next = free.lower_bound(offset);
+        if (next != free.end() && offset + size == next->first) {
+            size += next->second;
+            free.erase(next);
+        }
+
+        const auto following = free.lower_bound(offset);
+        if (following != free.begin()) {
+            if (const auto previous = std::prev(following); previous->first + previous->second == offset) {
+                offset = previous->first;
+                size += previous->second;
+                free.erase(previous);
+            }
+        }
+
+        free.emplace(offset, size);
+        pool.used -= range.size;
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include "LogicalDevice.h"
+#include "Buffer.h"
+
+namespace Vixen {
+    /**
+     * Suballocates the vertices and indices of every mesh from a few large buffers, so draws of meshes in the same block
+     * share their buffer bindings and only differ in their vertex offset and first index. Each block keeps a free list
+     * sorted by offset, allocations take the first range that fits and freed ranges are merged with their neighbours.
+     *
+     * Blocks are shared concurrently between the graphics and transfer queues, uploads into one block never need an
+     * ownership transfer that would discard the contents of the other meshes in it. Ranges must not be freed while GPU
+     * work using them is pending, empty blocks are only released by trim.
+     */
+    class GeometryArena {
+    public:
+        struct Range {
+            Buffer *buffer = nullptr;
+
+            uint32_t block = 0;
+
+            VkDeviceSize offset = 0;
+
+            VkDeviceSize size = 0;
+        };
+
+    private:
+        struct Block {
+            Buffer buffer;
+
+            /// Free ranges by offset
+            std::map<VkDeviceSize, VkDeviceSize> free;
+        };
+
+        struct Pool {
+            const char *name;
+
+            VkBufferUsageFlags usage;
+
+            VkDeviceSize blockSize;
+
+            std::vector<std::unique_ptr<Block>> blocks;
+
+            VkDeviceSize used = 0;
+        };
+
+        Logger logger{"GeometryArena"};
+
+        const std::shared_ptr<LogicalDevice> device;
+
+        std::mutex mutex;
+
+        Pool vertices;
+
+        Pool indices;
+
+        Range allocate(Pool &pool, VkDeviceSize size, VkDeviceSize alignment);
+
+        void free(Pool &pool, const Range &range);
+
+        static std::optional<Range> allocate(Block &block, uint32_t index, VkDeviceSize size, VkDeviceSize alignment);
+
+    public:
+        /**
+         * @param[in] vertexBlockSize The size of every vertex buffer, larger meshes get a block of their own
+         * @param[in] indexBlockSize The size of every index buffer, larger meshes get a block of their own
+         */
+        explicit GeometryArena(const std::shared_ptr<LogicalDevice> &device,
+                               VkDeviceSize vertexBlockSize = 64 * 1024 * 1024,
+                               VkDeviceSize indexBlockSize = 16 * 1024 * 1024);
+
+        GeometryArena(const GeometryArena &) = delete;
+
+        GeometryArena &operator=(const GeometryArena &) = delete;
+
+        /**
+         * @param[in] alignment The stride of the vertices, the offset of the range is a whole amount of vertices
+         */
+        Range allocateVertices(VkDeviceSize size, VkDeviceSize alignment);
+
+        /**
+         * @param[in] alignment The size of an index, the offset of the range is a whole amount of indices
+         */
+        Range allocateIndices(VkDeviceSize size, VkDeviceSize alignment);
+
+        void freeVertices(const Range &range);
+
+        void freeIndices(const Range &range);
+
+        [[nodiscard]] std::shared_ptr<LogicalDevice> getDevice() const;
+
+        /**
+         * The bytes allocated for vertices and indices combined
+         */
+        [[nodiscard]] VkDeviceSize getUsed();
+
+        /**
+         * The size of every block combined
+         */
+        [[nodiscard]] VkDeviceSize getCapacity();
+
+        /**
+         * Whether the free space of either pool adds up to at least a block, compacting it would let trim release one
+         */
+        [[nodiscard]] bool isFragmented();
+
+        /**
+         * Releases every empty block except the first of each pool, no GPU work may still use the released blocks
+         *
+         * @return The bytes released
+         */
+        VkDeviceSize trim();
+    };
+}
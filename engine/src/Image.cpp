@@ -1,20 +1,23 @@
 #include "Image.h"
+#include "UploadManager.h"
+#include "Ktx2.h"
+#include <cmath>
+#include <fstream>
 
 namespace Vixen {
     Image::Image(const std::shared_ptr<LogicalDevice> &device, uint32_t width, uint32_t height, VkFormat format,
-                 VkImageTiling tiling, VkImageUsageFlags usageFlags) : allocation(nullptr), width(width),
-                                                                       height(height),
-                                                                       layout(VK_IMAGE_LAYOUT_UNDEFINED),
-                                                                       usageFlags(usageFlags), device(device),
-                                                                       image(nullptr), format(format) {
+                 VkImageTiling tiling, VkImageUsageFlags usageFlags, uint32_t layers, uint32_t mipLevels)
+            : allocation(nullptr), width(width), height(height), layers(layers), mipLevels(mipLevels),
+              layout(VK_IMAGE_LAYOUT_UNDEFINED), tiling(tiling),
+              usageFlags(usageFlags), device(device), image(nullptr), format(format) {
         VkImageCreateInfo imageCreateInfo{};
         imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
         imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
         imageCreateInfo.extent.width = width;
         imageCreateInfo.extent.height = height;
         imageCreateInfo.extent.depth = 1;
-        imageCreateInfo.mipLevels = 1;
-        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.mipLevels = mipLevels;
+        imageCreateInfo.arrayLayers = layers;
         imageCreateInfo.format = format;
         imageCreateInfo.tiling = tiling;
         imageCreateInfo.initialLayout = layout;
@@ -25,106 +28,141 @@ namespace Vixen {
         VmaAllocationCreateInfo allocationCreateInfo = {};
         allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
+        VmaAllocationInfo allocationInfo{};
         VK_CHECK_RESULT(vmaCreateImage(device->allocator, &imageCreateInfo, &allocationCreateInfo, &image, &allocation,
-                                       nullptr))
+                                       &allocationInfo))
+        device->memoryStatistics.track(allocation, MemoryStatistics::categorizeImage(usageFlags), allocationInfo);
     }
 
     Image::Image(Image &&other) noexcept: allocation(std::exchange(other.allocation, nullptr)), width(other.width),
-                                          height(other.height), layout(other.layout), usageFlags(other.usageFlags),
+                                          height(other.height), layers(other.layers), mipLevels(other.mipLevels),
+                                          layout(other.layout), tiling(other.tiling),
+                                          usageFlags(other.usageFlags),
                                           device(other.device), image(std::exchange(other.image, nullptr)),
                                           format(other.format) {}
 
     Image::~Image() {
+        if (allocation)
+            device->memoryStatistics.untrack(allocation);
         vmaDestroyImage(device->allocator, image, allocation);
     }
 
-    Image Image::from(const std::shared_ptr<LogicalDevice> &device, const std::string &path) {
+    Image Image::from(UploadManager &uploader, const std::string &path) {
+        return from(uploader, load(path));
+    }
+
+    Image Image::from(UploadManager &uploader, const ImageData &data) {
+        const bool generateMips = data.levelOffsets.size() == 1 && uploader.supportsMipGeneration(data.format);
+        const uint32_t mipLevels = generateMips ? fullMipLevels(data.width, data.height)
+                                                : static_cast<uint32_t>(data.levelOffsets.size());
+
+        /// Transfer source is also needed for relocating the image when defragmenting
+        const VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                        VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        auto image = Image(uploader.getDevice(), data.width, data.height, data.format, VK_IMAGE_TILING_OPTIMAL, usage,
+                           1, mipLevels);
+        memcpy(uploader.stage(image, data.size, data.levelOffsets), data.data.get(), data.size);
+        return image;
+    }
+
+    ImageData Image::load(const std::string &path) {
         int32_t width, height, channels;
         stbi_uc *pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
         if (!pixels)
             throw std::runtime_error("Failed to open image");
 
-        VkDeviceSize size = width * height * 4;
-        Buffer staging = Buffer(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-        staging.write(pixels, size, 0);
-        stbi_image_free(pixels);
-
-        auto image = Image(device, width, height, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-                           VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
-        image.transition(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        image.copyFrom(staging);
-        image.transition(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-        return image;
+        return {
+                VK_FORMAT_R8G8B8A8_SRGB,
+                static_cast<uint32_t>(width),
+                static_cast<uint32_t>(height),
+                {0},
+                std::shared_ptr<const uint8_t>(pixels, stbi_image_free),
+                static_cast<VkDeviceSize>(width) * height * 4
+        };
     }
 
-    void Image::transition(VkImageLayout newLayout) {
-        VkImageMemoryBarrier barrier{};
-        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        barrier.oldLayout = layout;
-        barrier.newLayout = newLayout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT; // TODO: This looks sus too
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = 0;
-
-        VkPipelineStageFlags source;
-        VkPipelineStageFlags destination;
-
-        if (layout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-            source = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            destination = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        } else if (layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
-                   newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-            source = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            destination = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        } else {
-            throw std::runtime_error("Unsupported transition layout");
-        }
+    ImageData Image::load(const uint8_t *encoded, size_t size) {
+        int32_t width, height, channels;
+        stbi_uc *pixels = stbi_load_from_memory(encoded, static_cast<int>(size), &width, &height, &channels,
+                                                STBI_rgb_alpha);
+        if (!pixels)
+            throw std::runtime_error("Failed to decode image");
+
+        return {
+                VK_FORMAT_R8G8B8A8_SRGB,
+                static_cast<uint32_t>(width),
+                static_cast<uint32_t>(height),
+                {0},
+                std::shared_ptr<const uint8_t>(pixels, stbi_image_free),
+                static_cast<VkDeviceSize>(width) * height * 4
+        };
+    }
 
-        CommandBuffer(device)
-                .recordSingleUsage()
-                .cmdPipelineBarrier(source, destination, {}, {}, {}, {barrier})
-                .submit();
+    ImageData Image::loadKtx2(const PhysicalDevice &physicalDevice, const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Failed to open image");
 
-        layout = newLayout;
+        return loadKtx2(physicalDevice, file);
     }
 
-    void Image::copyFrom(const Buffer &buffer) {
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
+    ImageData Image::loadKtx2(const PhysicalDevice &physicalDevice, std::istream &file) {
+        const auto ktx = Ktx2::read(file);
 
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice.device, ktx.format, &properties);
+        if (!(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+            throw std::runtime_error(fmt::format("Device can not sample {}", string_VkFormat(ktx.format)));
 
-        region.imageOffset = {0, 0, 0};
-        region.imageExtent = {width, height, 1};
+        ImageData data{ktx.format, ktx.width, ktx.height, std::vector<VkDeviceSize>(ktx.levels.size()), nullptr, 0};
+        for (size_t i = 0; i < ktx.levels.size(); i++) {
+            data.levelOffsets[i] = data.size;
+            data.size += (ktx.levels[i].length + UploadManager::stagingAlignment - 1) /
+                         UploadManager::stagingAlignment * UploadManager::stagingAlignment;
+        }
+
+        const std::shared_ptr<uint8_t> contents(new uint8_t[data.size], std::default_delete<uint8_t[]>());
+        for (size_t i = 0; i < ktx.levels.size(); i++) {
+            file.seekg(static_cast<std::streamoff>(ktx.levels[i].offset));
+            file.read(reinterpret_cast<char *>(contents.get() + data.levelOffsets[i]),
+                      static_cast<std::streamsize>(ktx.levels[i].length));
+        }
+        if (!file)
+            throw std::runtime_error("Truncated KTX2 level data");
 
-        CommandBuffer(device)
-                .recordSingleUsage()
-                .cmdCopyBufferToImage(buffer.getBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, {region})
-                .submit();
+        data.data = contents;
+        return data;
     }
 
     std::shared_ptr<LogicalDevice> Image::getDevice() const {
         return device;
     }
 
+    VkImage Image::getImage() const {
+        return image;
+    }
+
+    uint32_t Image::getWidth() const {
+        return width;
+    }
+
+    uint32_t Image::getHeight() const {
+        return height;
+    }
+
+    uint32_t Image::getLayers() const {
+        return layers;
+    }
+
+    uint32_t Image::getMipLevels() const {
+        return mipLevels;
+    }
+
+    uint32_t Image::fullMipLevels(uint32_t width, uint32_t height) {
+        return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    }
+
     VkFormat Image::getFormat() const {
         return format;
     }
@@ -132,4 +170,70 @@ namespace Vixen {
     VkImageUsageFlags Image::getUsageFlags() const {
         return usageFlags;
     }
+
+    VkDeviceMemory Image::getMemory() const {
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(device->allocator, allocation, &info);
+        return info.deviceMemory;
+    }
+
+    VkDeviceSize Image::getAllocationSize() const {
+        VmaAllocationInfo info{};
+        vmaGetAllocationInfo(device->allocator, allocation, &info);
+        return info.size;
+    }
+
+    Image Image::relocate(CommandBuffer &commandBuffer) {
+        if (!(usageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+            throw std::runtime_error("Only images created with VK_IMAGE_USAGE_TRANSFER_SRC_BIT can be relocated");
+        if (layout == VK_IMAGE_LAYOUT_UNDEFINED)
+            throw std::runtime_error("Image has no contents to relocate");
+
+        Image relocated(device, width, height, format, tiling, usageFlags, layers, mipLevels);
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, layers};
+
+        std::vector<VkImageMemoryBarrier> barriers(2, barrier);
+        barriers[0].image = image;
+        barriers[0].oldLayout = layout;
+        barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        barriers[1].image = relocated.image;
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {}, barriers);
+
+        std::vector<VkImageCopy> regions(mipLevels);
+        for (uint32_t level = 0; level < mipLevels; level++) {
+            auto &region = regions[level];
+            region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, layers};
+            region.dstSubresource = region.srcSubresource;
+            region.extent = {std::max(width >> level, 1u), std::max(height >> level, 1u), 1};
+        }
+        commandBuffer.cmdCopyImage(image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, relocated.image,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+
+        /// Both images go back to the layout they are sampled in, frames recorded before the move still use the old one
+        barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barriers[0].newLayout = layout;
+        barriers[0].srcAccessMask = 0;
+        barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barriers[1].newLayout = layout;
+        barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, {},
+                                         {}, barriers);
+
+        relocated.layout = layout;
+        std::swap(allocation, relocated.allocation);
+        std::swap(image, relocated.image);
+        return relocated;
+    }
 }
@@ -1,19 +1,49 @@
 #pragma once
 
+#include <istream>
 #include "Vulkan.h"
 #include "Buffer.h"
 #include "LogicalDevice.h"
 
 namespace Vixen {
+    class UploadManager;
+
+    /**
+     * Image contents decoded on the CPU and ready to be uploaded, decoding does not touch the device so it can run on
+     * any thread
+     */
+    struct ImageData {
+        VkFormat format;
+
+        uint32_t width;
+
+        uint32_t height;
+
+        /// The offset of every pre-built mip level in data, a single level has the remaining levels generated
+        std::vector<VkDeviceSize> levelOffsets;
+
+        std::shared_ptr<const uint8_t> data;
+
+        VkDeviceSize size;
+    };
+
     class Image {
+        friend class UploadManager;
+
         VmaAllocation allocation;
 
         uint32_t width;
 
         uint32_t height;
 
+        uint32_t layers;
+
+        uint32_t mipLevels;
+
         VkImageLayout layout;
 
+        VkImageTiling tiling;
+
         VkImageUsageFlags usageFlags;
 
     protected:
@@ -25,7 +55,7 @@ namespace Vixen {
 
     public:
         Image(const std::shared_ptr<LogicalDevice> &device, uint32_t width, uint32_t height, VkFormat format,
-              VkImageTiling tiling, VkImageUsageFlags usageFlags);
+              VkImageTiling tiling, VkImageUsageFlags usageFlags, uint32_t layers = 1, uint32_t mipLevels = 1);
 
         Image(const Image &other) = delete;
 
@@ -33,16 +63,82 @@ namespace Vixen {
 
         ~Image();
 
-        static Image from(const std::shared_ptr<LogicalDevice> &device, const std::string &path);
+        /**
+         * Loads an image from disk and queues its upload including a full mip chain, the image can be used by graphics
+         * work submitted after the uploader's next flush
+         */
+        static Image from(UploadManager &uploader, const std::string &path);
+
+        /**
+         * Creates an image from decoded contents and queues its upload, the image can be used by graphics work
+         * submitted after the uploader's next flush
+         */
+        static Image from(UploadManager &uploader, const ImageData &data);
+
+        /**
+         * Decodes an image file to sRGB RGBA8
+         *
+         * @throws std::runtime_error When the file can not be decoded
+         */
+        static ImageData load(const std::string &path);
+
+        /**
+         * Decodes an image file held in memory to sRGB RGBA8
+         *
+         * @throws std::runtime_error When the contents can not be decoded
+         */
+        static ImageData load(const uint8_t *encoded, size_t size);
+
+        /**
+         * Reads a KTX2 texture with pre-built mip levels without decoding its block compressed data
+         *
+         * @throws std::runtime_error When the file can not be read or the device can not sample its format
+         */
+        static ImageData loadKtx2(const PhysicalDevice &physicalDevice, const std::string &path);
+
+        static ImageData loadKtx2(const PhysicalDevice &physicalDevice, std::istream &stream);
 
-        void transition(VkImageLayout newLayout);
+        [[nodiscard]] std::shared_ptr<LogicalDevice> getDevice() const;
 
-        void copyFrom(const Buffer &buffer);
+        [[nodiscard]] VkImage getImage() const;
 
-        [[nodiscard]] std::shared_ptr<LogicalDevice> getDevice() const;
+        [[nodiscard]] uint32_t getWidth() const;
+
+        [[nodiscard]] uint32_t getHeight() const;
+
+        [[nodiscard]] uint32_t getLayers() const;
+
+        [[nodiscard]] uint32_t getMipLevels() const;
+
+        /**
+         * The amount of mip levels in a full mip chain down to 1x1 for an image of the given size
+         */
+        static uint32_t fullMipLevels(uint32_t width, uint32_t height);
 
         [[nodiscard]] VkFormat getFormat() const;
 
         [[nodiscard]] VkImageUsageFlags getUsageFlags() const;
+
+        /**
+         * The memory block the image is placed in, shared with other allocations
+         */
+        [[nodiscard]] VkDeviceMemory getMemory() const;
+
+        /**
+         * The size of the image's allocation
+         */
+        [[nodiscard]] VkDeviceSize getAllocationSize() const;
+
+        /**
+         * Records copying every level of a color image into a new allocation with the same properties, placed by the
+         * allocator like any new image. Afterwards this image refers to the copy, the command buffer must be on a
+         * graphics queue and is submitted by the caller.
+         *
+         * @return The image holding the previous allocation, keep it alive until the copy and every command buffer
+         * using it have finished
+         * @throws std::runtime_error When the image was not created with VK_IMAGE_USAGE_TRANSFER_SRC_BIT or has no
+         * contents
+         */
+        Image relocate(CommandBuffer &commandBuffer);
     };
 }
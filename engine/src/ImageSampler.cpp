@@ -1,7 +1,8 @@
 #include "ImageSampler.h"
 
 namespace Vixen {
-    ImageSampler::ImageSampler(const std::shared_ptr<LogicalDevice>& device) : device(device), sampler() {
+    ImageSampler::ImageSampler(const std::shared_ptr<LogicalDevice>& device, uint32_t mipLevels)
+            : device(device), sampler() {
         VkSamplerCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
         info.magFilter = VK_FILTER_LINEAR;
@@ -18,7 +19,7 @@ namespace Vixen {
         info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         info.mipLodBias = 0.0f;
         info.minLod = 0.0f;
-        info.maxLod = 0.0f;
+        info.maxLod = static_cast<float>(mipLevels);
 
         VK_CHECK_RESULT(vkCreateSampler(device->device, &info, nullptr, &sampler))
     }
@@ -9,7 +9,10 @@ namespace Vixen {
         VkSampler sampler;
 
     public:
-        explicit ImageSampler(const std::shared_ptr<LogicalDevice>& device);
+        /**
+         * @param[in] mipLevels The largest mip count of the images sampled with this sampler
+         */
+        explicit ImageSampler(const std::shared_ptr<LogicalDevice>& device, uint32_t mipLevels = 1);
 
         ImageSampler(const ImageSampler &) = delete;
 
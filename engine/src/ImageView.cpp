@@ -2,26 +2,39 @@
 
 namespace Vixen {
     ImageView::ImageView(Image &&image, VkImageAspectFlags aspectFlags)
-            : Image(std::move(image)) {
+            : Image(std::move(image)), aspectFlags(aspectFlags), view(createView()) {}
+
+    ImageView::ImageView(Image &&image, VkImageAspectFlags aspectFlags, VkImageView view)
+            : Image(std::move(image)), aspectFlags(aspectFlags), view(view) {}
+
+    ImageView::~ImageView() {
+        vkDestroyImageView(device->device, view, nullptr);
+    }
+
+    VkImageView ImageView::createView() const {
         VkImageViewCreateInfo imageViewCreateInfo{};
         imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         imageViewCreateInfo.image = this->image;
-        imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        imageViewCreateInfo.viewType = getLayers() > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
         imageViewCreateInfo.format = format;
         imageViewCreateInfo.subresourceRange.aspectMask = aspectFlags;
         imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-        imageViewCreateInfo.subresourceRange.levelCount = 1;
+        imageViewCreateInfo.subresourceRange.levelCount = getMipLevels();
         imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
-        imageViewCreateInfo.subresourceRange.layerCount = 1;
+        imageViewCreateInfo.subresourceRange.layerCount = getLayers();
 
-        VK_CHECK_RESULT(vkCreateImageView(device->device, &imageViewCreateInfo, nullptr, &view))
-    }
-
-    ImageView::~ImageView() {
-        vkDestroyImageView(device->device, view, nullptr);
+        VkImageView imageView = VK_NULL_HANDLE;
+        VK_CHECK_RESULT(vkCreateImageView(device->device, &imageViewCreateInfo, nullptr, &imageView))
+        return imageView;
     }
 
     VkImageView ImageView::getView() const {
         return view;
     }
+
+    std::unique_ptr<ImageView> ImageView::relocate(CommandBuffer &commandBuffer) {
+        std::unique_ptr<ImageView> previous(new ImageView(Image::relocate(commandBuffer), aspectFlags, view));
+        view = createView();
+        return previous;
+    }
 }
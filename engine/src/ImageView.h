@@ -1,13 +1,23 @@
 #pragma once
 
+#include <memory>
 #include "Image.h"
 
 namespace Vixen {
     class ImageView : public Image {
         const Logger logger{"ImageView"};
 
+        VkImageAspectFlags aspectFlags;
+
         VkImageView view{};
 
+        /**
+         * Takes ownership of an existing view of the image
+         */
+        ImageView(Image &&image, VkImageAspectFlags aspectFlags, VkImageView view);
+
+        [[nodiscard]] VkImageView createView() const;
+
     public:
         ImageView(Image &&image, VkImageAspectFlags aspectFlags);
 
@@ -18,5 +28,14 @@ namespace Vixen {
         ~ImageView();
 
         [[nodiscard]] VkImageView getView() const;
+
+        /**
+         * Relocates the image like Image::relocate and recreates the view, descriptor sets referencing the view have
+         * to be updated afterwards
+         *
+         * @return The previous image and view, keep them alive until the copy and every command buffer using them have
+         * finished
+         */
+        std::unique_ptr<ImageView> relocate(CommandBuffer &commandBuffer);
     };
 }
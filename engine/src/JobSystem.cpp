@@ -0,0 +1,238 @@
+#include "JobSystem.h"
+#include <stdexcept>
+
+namespace Vixen {
+    struct JobHandle::State {
+        JobSystem *system;
+
+        const char *name;
+
+        std::function<void()> work;
+
+        /// Unfinished dependencies plus one until the job is scheduled, the job is queued once it drops to zero
+        std::atomic<uint32_t> pending = 1;
+
+        std::atomic<bool> done = false;
+
+        std::exception_ptr exception;
+
+        std::mutex mutex;
+
+        /// Jobs waiting for this one, guarded by the mutex
+        std::vector<std::shared_ptr<State>> continuations;
+    };
+
+    namespace {
+        /// The job system the calling thread works for and its worker index
+        thread_local const JobSystem *currentSystem = nullptr;
+
+        thread_local uint32_t currentWorker = 0;
+    }
+
+    JobHandle::JobHandle(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+    bool JobHandle::isDone() const {
+        return !state || state->done;
+    }
+
+    void JobHandle::resume(std::coroutine_handle<> coroutine) const {
+        state->system->schedule("Resume coroutine", [coroutine]() {
+            coroutine.resume();
+        }, {*this});
+    }
+
+    void JobHandle::rethrow() const {
+        if (state && state->exception)
+            std::rethrow_exception(state->exception);
+    }
+
+    JobSystem::JobSystem(uint32_t threadCount) {
+        for (uint32_t i = 0; i <= threadCount; i++)
+            queues.push_back(std::make_unique<Queue>());
+
+        workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++)
+            workers.emplace_back(&JobSystem::work, this, i);
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::scoped_lock lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (auto &worker : workers)
+            worker.join();
+
+        /// Workers only leave once every queue is empty, jobs are left over when there are no workers at all
+        const auto queue = static_cast<uint32_t>(workers.size());
+        while (const auto job = take(queue))
+            run(job, queue);
+    }
+
+    void JobSystem::work(uint32_t worker) {
+        currentSystem = this;
+        currentWorker = worker;
+        while (true) {
+            if (const auto job = take(worker)) {
+                run(job, worker);
+                continue;
+            }
+
+            std::unique_lock lock(sleepMutex);
+            wake.wait(lock, [this]() { return stopping || queued > 0; });
+            if (stopping && queued == 0)
+                return;
+        }
+    }
+
+    uint32_t JobSystem::getQueue() const {
+        return currentSystem == this ? currentWorker : static_cast<uint32_t>(workers.size());
+    }
+
+    void JobSystem::push(std::shared_ptr<JobHandle::State> job) {
+        auto &queue = *queues[getQueue()];
+        {
+            /// Counted under the lock the job is taken with, so a thief never decrements the count below zero
+            std::scoped_lock lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+            queued++;
+        }
+
+        /// Taking the lock orders the count before the check of a worker about to sleep, so the wake up is not lost
+        { std::scoped_lock lock(sleepMutex); }
+        wake.notify_one();
+    }
+
+    std::shared_ptr<JobHandle::State> JobSystem::take(uint32_t queue) {
+        if (queued == 0)
+            return nullptr;
+
+        {
+            auto &own = *queues[queue];
+            std::scoped_lock lock(own.mutex);
+            if (!own.jobs.empty()) {
+                auto job = std::move(own.jobs.back());
+                own.jobs.pop_back();
+                queued--;
+                return job;
+            }
+        }
+
+        for (size_t i = 1; i < queues.size(); i++) {
+            auto &victim = *queues[(queue + i) % queues.size()];
+            std::scoped_lock lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                auto job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                queued--;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void JobSystem::run(const std::shared_ptr<JobHandle::State> &job, uint32_t queue) {
+        const bool timed = profiling;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            job->work();
+        } catch (...) {
+            job->exception = std::current_exception();
+        }
+        if (timed) {
+            auto &timings = *queues[queue];
+            std::scoped_lock lock(timings.timingMutex);
+            timings.timings.push_back({job->name, queue, start, std::chrono::steady_clock::now() - start});
+        }
+        /// Releases whatever the job captured before anyone waiting for it continues
+        job->work = nullptr;
+
+        std::vector<std::shared_ptr<JobHandle::State>> continuations;
+        {
+            std::scoped_lock lock(job->mutex);
+            job->done = true;
+            continuations.swap(job->continuations);
+        }
+        for (auto &continuation : continuations)
+            if (--continuation->pending == 0)
+                push(std::move(continuation));
+    }
+
+    bool JobSystem::depend(const std::shared_ptr<JobHandle::State> &job, const JobHandle &dependency) {
+        if (!dependency.state)
+            return false;
+
+        std::scoped_lock lock(dependency.state->mutex);
+        if (dependency.state->done)
+            return false;
+        dependency.state->continuations.push_back(job);
+        return true;
+    }
+
+    JobHandle JobSystem::schedule(const char *name, std::function<void()> work,
+                                  const std::vector<JobHandle> &dependencies) {
+        auto job = std::make_shared<JobHandle::State>();
+        job->system = this;
+        job->name = name;
+        job->work = std::move(work);
+        for (const auto &dependency : dependencies) {
+            if (dependency.state && dependency.state->system != this)
+                throw std::runtime_error("Jobs can only depend on jobs of the same job system");
+            /// Counted before it is registered, the dependency may finish right after
+            job->pending++;
+            if (!depend(job, dependency))
+                job->pending--;
+        }
+
+        if (--job->pending == 0)
+            push(job);
+        return JobHandle(std::move(job));
+    }
+
+    void JobSystem::help(const JobHandle &job) {
+        const uint32_t queue = getQueue();
+        while (!job.isDone()) {
+            if (const auto other = take(queue))
+                run(other, queue);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::wait(const JobHandle &job) {
+        help(job);
+        job.rethrow();
+    }
+
+    void JobSystem::wait(const std::vector<JobHandle> &jobs) {
+        for (const auto &job : jobs)
+            help(job);
+        for (const auto &job : jobs)
+            job.rethrow();
+    }
+
+    void JobSystem::setProfiling(bool enabled) {
+        profiling = enabled;
+    }
+
+    std::vector<JobTiming> JobSystem::collectTimings() {
+        std::vector<JobTiming> timings;
+        for (const auto &queue : queues) {
+            std::scoped_lock lock(queue->timingMutex);
+            timings.insert(timings.end(), queue->timings.begin(), queue->timings.end());
+            queue->timings.clear();
+        }
+        return timings;
+    }
+
+    uint32_t JobSystem::getThreadCount() const {
+        return static_cast<uint32_t>(workers.size());
+    }
+
+    uint32_t JobSystem::defaultThreadCount() {
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Vixen {
+    class JobSystem;
+
+    /**
+     * How long a job ran and on which thread, recorded while profiling is enabled
+     */
+    struct JobTiming {
+        /// The name the job was scheduled with
+        const char *name;
+
+        /// The worker that ran the job, threads outside of the job system share the index after the last worker
+        uint32_t worker;
+
+        std::chrono::steady_clock::time_point start;
+
+        std::chrono::nanoseconds duration;
+    };
+
+    /**
+     * A handle to a scheduled job. Awaiting it from a coroutine suspends the coroutine until the job finished and
+     * resumes it on a worker as a continuation of the job.
+     */
+    class JobHandle {
+        struct State;
+
+        std::shared_ptr<State> state;
+
+        explicit JobHandle(std::shared_ptr<State> state);
+
+        friend class JobSystem;
+
+    public:
+        JobHandle() = default;
+
+        /**
+         * Whether the job finished, a default constructed handle counts as finished
+         */
+        [[nodiscard]] bool isDone() const;
+
+        auto operator co_await() const {
+            struct Awaiter {
+                const JobHandle &handle;
+
+                [[nodiscard]] bool await_ready() const {
+                    return handle.isDone();
+                }
+
+                void await_suspend(std::coroutine_handle<> coroutine) const {
+                    handle.resume(coroutine);
+                }
+
+                void await_resume() const {
+                    handle.rethrow();
+                }
+            };
+            return Awaiter{*this};
+        }
+
+    private:
+        void resume(std::coroutine_handle<> coroutine) const;
+
+        void rethrow() const;
+    };
+
+    /**
+     * A work stealing job scheduler. Every worker owns a deque of jobs, it runs the newest job it pushed first while
+     * idle workers steal the oldest jobs of the others. Threads outside of the job system push their jobs into a shared
+     * deque the workers steal from as well.
+     *
+     * Jobs may depend on other jobs and only start once all of their dependencies finished, which builds dependency
+     * graphs and continuations. Waiting for a job runs other jobs in the meantime, so jobs can wait on the jobs they
+     * scheduled without running out of workers.
+     */
+    class JobSystem {
+        struct alignas(64) Queue {
+            std::mutex mutex;
+
+            std::deque<std::shared_ptr<JobHandle::State>> jobs;
+
+            std::mutex timingMutex;
+
+            std::vector<JobTiming> timings;
+        };
+
+        /// One queue for every worker followed by the queue shared by all other threads
+        std::vector<std::unique_ptr<Queue>> queues;
+
+        std::vector<std::thread> workers;
+
+        /// The amount of jobs in all queues, idle workers sleep while it is zero
+        std::atomic<size_t> queued = 0;
+
+        std::mutex sleepMutex;
+
+        std::condition_variable wake;
+
+        bool stopping = false;
+
+        std::atomic<bool> profiling = false;
+
+        void work(uint32_t worker);
+
+        /**
+         * The queue of the calling thread
+         */
+        [[nodiscard]] uint32_t getQueue() const;
+
+        void push(std::shared_ptr<JobHandle::State> job);
+
+        /**
+         * Takes the newest job of a queue or steals the oldest job of another queue
+         */
+        std::shared_ptr<JobHandle::State> take(uint32_t queue);
+
+        void run(const std::shared_ptr<JobHandle::State> &job, uint32_t queue);
+
+        /**
+         * Makes a job wait for a dependency, returns false when the dependency finished already
+         */
+        static bool depend(const std::shared_ptr<JobHandle::State> &job, const JobHandle &dependency);
+
+        /**
+         * Runs other jobs until a job finished
+         */
+        void help(const JobHandle &job);
+
+        friend class JobHandle;
+
+    public:
+        /**
+         * @param[in] threadCount The amount of worker threads, defaults to one less than the amount of hardware
+         * threads so the calling thread keeps a core to itself
+         */
+        explicit JobSystem(uint32_t threadCount = defaultThreadCount());
+
+        JobSystem(const JobSystem &) = delete;
+
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        /**
+         * Finishes every scheduled job and joins the workers
+         */
+        ~JobSystem();
+
+        /**
+         * Schedules a job to run once all of its dependencies finished, dependencies that threw count as finished
+         *
+         * @param[in] name Shows up in the timings, must outlive the job system
+         */
+        JobHandle schedule(const char *name, std::function<void()> work,
+                           const std::vector<JobHandle> &dependencies = {});
+
+        /**
+         * Runs other jobs until a job finished, rethrowing the exception the job threw
+         */
+        void wait(const JobHandle &job);
+
+        /**
+         * Waits for every job before rethrowing the first exception one of them threw
+         */
+        void wait(const std::vector<JobHandle> &jobs);
+
+        /**
+         * Calls a function with consecutive ranges of [0, count) on the workers and the calling thread, returning once
+         * every range is done
+         *
+         * @param[in] grain The size of every range but the last, ranges are the unit of stealing
+         */
+        template<typename F>
+        void parallelFor(const char *name, size_t count, size_t grain, F &&function) {
+            grain = std::max<size_t>(grain, 1);
+            const size_t ranges = (count + grain - 1) / grain;
+            if (ranges <= 1 || workers.empty()) {
+                if (count > 0)
+                    function(size_t{0}, count);
+                return;
+            }
+
+            std::vector<JobHandle> jobs;
+            jobs.reserve(ranges - 1);
+            for (size_t range = ranges - 1; range > 0; range--) {
+                const size_t begin = range * grain;
+                jobs.push_back(schedule(name, [&function, begin, end = std::min(count, begin + grain)]() {
+                    function(begin, end);
+                }));
+            }
+
+            /// The ranges reference the function, every one of them must be done before an exception leaves
+            std::exception_ptr exception;
+            try {
+                function(size_t{0}, grain);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            wait(jobs);
+            if (exception)
+                std::rethrow_exception(exception);
+        }
+
+        /**
+         * Records the timings of every job from now on
+         */
+        void setProfiling(bool enabled);
+
+        /**
+         * Returns the timings recorded since the last call, ordered by worker
+         */
+        std::vector<JobTiming> collectTimings();
+
+        [[nodiscard]] uint32_t getThreadCount() const;
+
+        static uint32_t defaultThreadCount();
+    };
+}
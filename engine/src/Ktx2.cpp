@@ -0,0 +1,173 @@
+#include "Ktx2.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Vixen {
+    namespace {
+        template<typename T>
+        T readValue(std::istream &stream) {
+            T value{};
+            stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        void writeValue(std::ostream &stream, T value) {
+            stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        /**
+         * Builds a basic data format descriptor for the block compressed formats the writer supports
+         */
+        std::vector<uint32_t> dataFormatDescriptor(VkFormat format) {
+            /// Channel ids and color models from the Khronos data format specification
+            struct Sample {
+                uint32_t offset;
+                uint32_t channel;
+            };
+
+            uint32_t model;
+            uint32_t blockBytes;
+            uint32_t transfer;
+            std::vector<Sample> samples;
+            switch (format) {
+                case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                    model = 128;
+                    blockBytes = 8;
+                    transfer = format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ? 2 : 1;
+                    samples = {{0, 0}};
+                    break;
+                case VK_FORMAT_BC3_SRGB_BLOCK:
+                case VK_FORMAT_BC3_UNORM_BLOCK:
+                    model = 130;
+                    blockBytes = 16;
+                    transfer = format == VK_FORMAT_BC3_SRGB_BLOCK ? 2 : 1;
+                    samples = {{0, 15}, {64, 0}};
+                    break;
+                case VK_FORMAT_BC5_UNORM_BLOCK:
+                    model = 132;
+                    blockBytes = 16;
+                    transfer = 1;
+                    samples = {{0, 0}, {64, 1}};
+                    break;
+                default:
+                    throw std::runtime_error("Unsupported KTX2 output format");
+            }
+
+            const auto blockSize = static_cast<uint32_t>(24 + 16 * samples.size());
+            std::vector<uint32_t> words{
+                    4 + blockSize,
+                    0,
+                    2 | blockSize << 16,
+                    model | 1 << 8 | transfer << 16,
+                    3 | 3 << 8,
+                    blockBytes,
+                    0
+            };
+            for (const auto &sample : samples) {
+                words.push_back(sample.offset | 63 << 16 | sample.channel << 24);
+                words.push_back(0);
+                words.push_back(0);
+                words.push_back(0xFFFFFFFF);
+            }
+            return words;
+        }
+    }
+
+    Ktx2 Ktx2::read(std::istream &stream) {
+        std::array<uint8_t, 12> fileIdentifier{};
+        stream.read(reinterpret_cast<char *>(fileIdentifier.data()), fileIdentifier.size());
+        if (!stream || fileIdentifier != identifier)
+            throw std::runtime_error("Not a KTX2 file");
+
+        Ktx2 ktx{};
+        ktx.format = static_cast<VkFormat>(readValue<uint32_t>(stream));
+        readValue<uint32_t>(stream); /// typeSize
+        ktx.width = readValue<uint32_t>(stream);
+        ktx.height = readValue<uint32_t>(stream);
+        const auto depth = readValue<uint32_t>(stream);
+        const auto layerCount = readValue<uint32_t>(stream);
+        const auto faceCount = readValue<uint32_t>(stream);
+        const auto levelCount = std::max(readValue<uint32_t>(stream), 1u);
+        const auto supercompression = readValue<uint32_t>(stream);
+        /// Skip the data format descriptor, key/value data and supercompression global data indices
+        stream.seekg(32, std::ios::cur);
+
+        if (!stream)
+            throw std::runtime_error("Truncated KTX2 header");
+        if (ktx.format == VK_FORMAT_UNDEFINED)
+            throw std::runtime_error("Basis Universal KTX2 textures are not supported");
+        if (supercompression != 0)
+            throw std::runtime_error("Supercompressed KTX2 textures are not supported");
+        if (depth > 1 || layerCount > 1 || faceCount != 1)
+            throw std::runtime_error("Only 2D KTX2 textures are supported");
+
+        ktx.levels.resize(levelCount);
+        for (auto &level : ktx.levels) {
+            level.offset = readValue<uint64_t>(stream);
+            level.length = readValue<uint64_t>(stream);
+            readValue<uint64_t>(stream); /// uncompressedByteLength
+        }
+        if (!stream)
+            throw std::runtime_error("Truncated KTX2 level index");
+
+        return ktx;
+    }
+
+    void Ktx2::write(std::ostream &stream, VkFormat format, uint32_t width, uint32_t height,
+                     const std::vector<std::vector<uint8_t>> &levels) {
+        const auto descriptor = dataFormatDescriptor(format);
+        const auto levelCount = static_cast<uint32_t>(levels.size());
+        const uint32_t descriptorOffset = 80 + 24 * levelCount;
+        const auto descriptorLength = static_cast<uint32_t>(descriptor.size() * sizeof(uint32_t));
+
+        /// Level data is stored from the smallest to the largest level, aligned to 16 bytes which satisfies every
+        /// block size
+        std::vector<uint64_t> offsets(levels.size());
+        uint64_t offset = descriptorOffset + descriptorLength;
+        for (size_t i = levels.size(); i-- > 0;) {
+            offset = (offset + 15) / 16 * 16;
+            offsets[i] = offset;
+            offset += levels[i].size();
+        }
+
+        stream.write(reinterpret_cast<const char *>(identifier.data()), identifier.size());
+        writeValue<uint32_t>(stream, format);
+        writeValue<uint32_t>(stream, 1);
+        writeValue<uint32_t>(stream, width);
+        writeValue<uint32_t>(stream, height);
+        writeValue<uint32_t>(stream, 0);
+        writeValue<uint32_t>(stream, 0);
+        writeValue<uint32_t>(stream, 1);
+        writeValue<uint32_t>(stream, levelCount);
+        writeValue<uint32_t>(stream, 0);
+
+        writeValue<uint32_t>(stream, descriptorOffset);
+        writeValue<uint32_t>(stream, descriptorLength);
+        writeValue<uint32_t>(stream, 0);
+        writeValue<uint32_t>(stream, 0);
+        writeValue<uint64_t>(stream, 0);
+        writeValue<uint64_t>(stream, 0);
+
+        for (size_t i = 0; i < levels.size(); i++) {
+            writeValue<uint64_t>(stream, offsets[i]);
+            writeValue<uint64_t>(stream, levels[i].size());
+            writeValue<uint64_t>(stream, levels[i].size());
+        }
+
+        stream.write(reinterpret_cast<const char *>(descriptor.data()), descriptorLength);
+
+        uint64_t position = descriptorOffset + descriptorLength;
+        for (size_t i = levels.size(); i-- > 0;) {
+            for (; position < offsets[i]; position++)
+                stream.put(0);
+            stream.write(reinterpret_cast<const char *>(levels[i].data()),
+                         static_cast<std::streamsize>(levels[i].size()));
+            position += levels[i].size();
+        }
+
+        if (!stream)
+            throw std::runtime_error("Failed to write KTX2 file");
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include "Vulkan.h"
+
+namespace Vixen {
+    /**
+     * The header and level index of a KTX2 texture container. Only containers without supercompression are supported,
+     * the level data is read directly from the stream by the caller.
+     */
+    struct Ktx2 {
+        struct Level {
+            /// The offset of the level data from the start of the file
+            uint64_t offset;
+
+            uint64_t length;
+        };
+
+        static constexpr std::array<uint8_t, 12> identifier{
+                0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+        };
+
+        VkFormat format = VK_FORMAT_UNDEFINED;
+
+        uint32_t width = 0;
+
+        uint32_t height = 0;
+
+        /// The level index, level 0 is the full resolution image
+        std::vector<Level> levels;
+
+        /**
+         * Reads the header and level index of a KTX2 container
+         *
+         * @throws std::runtime_error When the stream is not a KTX2 container or uses features that are not supported
+         */
+        static Ktx2 read(std::istream &stream);
+
+        /**
+         * Writes a 2D KTX2 container for a block compressed format with a basic data format descriptor
+         *
+         * @param[in] levels The data of every mip level, level 0 is the full resolution image
+         * @throws std::runtime_error When the format is not one of the formats the writer supports
+         */
+        static void write(std::ostream &stream, VkFormat format, uint32_t width, uint32_t height,
+                          const std::vector<std::vector<uint8_t>> &levels);
+    };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Vixen {
+    /**
+     * A point light, laid out to match the std430 light storage buffer read by the shaders
+     */
+    struct PointLight {
+        glm::vec3 position;
+        float radius;
+        glm::vec3 color;
+        float intensity;
+
+        explicit PointLight(const glm::vec3 &position = {}, float radius = 1.0f,
+                            const glm::vec3 &color = {1.0f, 1.0f, 1.0f}, float intensity = 1.0f)
+                : position(position), radius(radius), color(color), intensity(intensity) {}
+    };
+
+    static_assert(sizeof(PointLight) == 32, "PointLight must match the std430 layout of the light buffer");
+
+    /**
+     * A light infinitely far away that lights the whole scene from one direction, such as the sun
+     */
+    struct DirectionalLight {
+        /// The direction the light travels in, does not need to be normalized
+        glm::vec3 direction;
+        glm::vec3 color;
+        float intensity;
+
+        explicit DirectionalLight(const glm::vec3 &direction = {-0.4f, -1.0f, -0.3f},
+                                  const glm::vec3 &color = {1.0f, 1.0f, 1.0f}, float intensity = 1.0f)
+                : direction(direction), color(color), intensity(intensity) {}
+    };
+}
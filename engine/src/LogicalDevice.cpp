@@ -1,5 +1,6 @@
 #define VMA_IMPLEMENTATION
 
+#include <algorithm>
 #include "LogicalDevice.h"
 
 namespace Vixen {
@@ -9,7 +10,7 @@ namespace Vixen {
                                                                                                   physicalDevice),
                                                                                           window(window) {
         std::set<uint32_t> queueFamilies = {physicalDevice->graphicsFamilyIndex, physicalDevice->presentFamilyIndex,
-                                            physicalDevice->transferFamilyIndex};
+                                            physicalDevice->transferFamilyIndex, physicalDevice->computeFamilyIndex};
         /// Create all the queue create info structs specified in queueFamilies
         float queuePriority = 1.0f;
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
@@ -27,8 +28,12 @@ namespace Vixen {
         deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
         deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
         deviceCreateInfo.pEnabledFeatures = &physicalDevice->deviceFeatures;
-        deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(physicalDevice->enabledExtensions.size());
-        deviceCreateInfo.ppEnabledExtensionNames = physicalDevice->enabledExtensions.data();
+        std::vector<const char *> extensions = physicalDevice->enabledExtensions;
+        memoryBudget = physicalDevice->supportsExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        if (memoryBudget)
+            extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+        deviceCreateInfo.ppEnabledExtensionNames = extensions.data();
 
         if (vkCreateDevice(physicalDevice->device, &deviceCreateInfo, nullptr, &device) != VK_SUCCESS)
             logger.critical("Failed to create logical device");
@@ -45,6 +50,12 @@ namespace Vixen {
         vkGetDeviceQueue(device, physicalDevice->transferFamilyIndex, 0, &transferQueue);
         logger.trace("Successfully created memory transfer queue interface");
 
+        vkGetDeviceQueue(device, physicalDevice->computeFamilyIndex, 0, &computeQueue);
+        if (physicalDevice->hasAsyncCompute())
+            logger.trace("Successfully created async compute queue interface");
+        else
+            logger.trace("No separate compute queue family available, compute work shares the graphics queue");
+
         SwapChainSupportDetails details = physicalDevice->querySwapChainSupportDetails();
         imageCount = details.capabilities.minImageCount + 1;
         if (details.capabilities.maxImageCount > 0 && imageCount > details.capabilities.maxImageCount)
@@ -54,55 +65,162 @@ namespace Vixen {
 
         createImageViews();
 
-        VkCommandPoolCreateInfo poolCreateInfo = {};
-        poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolCreateInfo.queueFamilyIndex = physicalDevice->graphicsFamilyIndex;
-        poolCreateInfo.flags = 0;
-
-        if (vkCreateCommandPool(device, &poolCreateInfo, nullptr, &commandPool) != VK_SUCCESS)
-            logger.critical("Failed to create command pool");
-        logger.trace("Successfully created command pool");
-
-        VkCommandPoolCreateInfo transferCommandPoolCreateInfo = {};
-        transferCommandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        transferCommandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-        transferCommandPoolCreateInfo.queueFamilyIndex = physicalDevice->transferFamilyIndex;
-
-        if (vkCreateCommandPool(device, &transferCommandPoolCreateInfo, nullptr, &transferCommandPool) !=
-            VK_SUCCESS)
-            logger.critical("Failed to create memory transfer command pool");
-        logger.trace("Successfully created memory transfer command pool");
-
-        VkFenceCreateInfo fenceCreateInfo = {};
-        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-        if (vkCreateFence(device, &fenceCreateInfo, nullptr, &transferFence) != VK_SUCCESS)
-            logger.critical("Failed to create memory transfer fence");
+        commandPool = createCommandPool(QueueType::GRAPHICS);
+        transferCommandPool = createCommandPool(QueueType::TRANSFER);
+        computeCommandPool = createCommandPool(QueueType::COMPUTE);
+        logger.trace("Successfully created command pools");
 
         /// Create the VMA allocator
         VmaAllocatorCreateInfo allocatorCreateInfo = {};
         allocatorCreateInfo.device = device;
         allocatorCreateInfo.physicalDevice = physicalDevice->device;
         allocatorCreateInfo.instance = instance->getInstance();
+        /// Vulkan 1.1 is enough for the allocator to query budgets through vkGetPhysicalDeviceMemoryProperties2
+        allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_1;
+        if (memoryBudget)
+            allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
 
         if (vmaCreateAllocator(&allocatorCreateInfo, &allocator) != VK_SUCCESS)
             logger.critical("Failed to create VMA allocator");
+        if (memoryBudget)
+            logger.trace("Tracking memory heap budgets through VK_EXT_memory_budget");
+
+        /// Without Resizable BAR only a small window of device memory, usually 256 MiB, is visible to the host
+        const VkPhysicalDeviceMemoryProperties *memoryProperties = nullptr;
+        vmaGetMemoryProperties(allocator, &memoryProperties);
+        VkDeviceSize deviceHeap = 0;
+        VkDeviceSize mappableHeap = 0;
+        for (uint32_t i = 0; i < memoryProperties->memoryTypeCount; i++) {
+            const auto &type = memoryProperties->memoryTypes[i];
+            if (!(type.propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+                continue;
+
+            const VkDeviceSize heapSize = memoryProperties->memoryHeaps[type.heapIndex].size;
+            deviceHeap = std::max(deviceHeap, heapSize);
+            if (type.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+                mappableHeap = std::max(mappableHeap, heapSize);
+        }
+        hostVisibleDeviceMemory = mappableHeap > 0;
+        mappableDeviceMemory = hostVisibleDeviceMemory && mappableHeap == deviceHeap;
+        if (mappableDeviceMemory)
+            logger.trace("All {} MiB of device memory are host visible", deviceHeap / (1024 * 1024));
+        else if (hostVisibleDeviceMemory)
+            logger.trace("{} MiB of device memory are host visible", mappableHeap / (1024 * 1024));
+        else
+            logger.trace("No device memory is host visible, dynamic data is read from host memory");
     }
 
     LogicalDevice::~LogicalDevice() {
-        vkDeviceWaitIdle(device);
-
-        vkDestroyFence(device, transferFence, nullptr);
+        waitIdle();
 
         vkDestroyCommandPool(device, commandPool, nullptr);
         vkDestroyCommandPool(device, transferCommandPool, nullptr);
+        vkDestroyCommandPool(device, computeCommandPool, nullptr);
+        for (const auto &[thread, pools] : threadCommandPools)
+            for (const auto pool : pools)
+                vkDestroyCommandPool(device, pool, nullptr);
         vmaDestroyAllocator(allocator);
 
         destroySwapchain();
         vkDestroyDevice(device, nullptr);
     }
 
+    VkQueue LogicalDevice::getQueue(QueueType type) const {
+        switch (type) {
+            case QueueType::COMPUTE:
+                return computeQueue;
+            case QueueType::TRANSFER:
+                return transferQueue;
+            default:
+                return graphicsQueue;
+        }
+    }
+
+    VkCommandPool LogicalDevice::getCommandPool(QueueType type) const {
+        if (std::this_thread::get_id() == owner) {
+            switch (type) {
+                case QueueType::COMPUTE:
+                    return computeCommandPool;
+                case QueueType::TRANSFER:
+                    return transferCommandPool;
+                default:
+                    return commandPool;
+            }
+        }
+
+        std::scoped_lock lock(threadCommandPoolMutex);
+        auto &pool = threadCommandPools[std::this_thread::get_id()][static_cast<size_t>(type)];
+        if (pool == VK_NULL_HANDLE) {
+            pool = createCommandPool(type);
+            logger.trace("Created a command pool for another thread");
+        }
+        return pool;
+    }
+
+    VkCommandPool LogicalDevice::createCommandPool(QueueType type) const {
+        VkCommandPoolCreateInfo createInfo = {};
+        createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        createInfo.queueFamilyIndex = getQueueFamilyIndex(type);
+        /// Transfer command buffers are recorded once and freed, the others are reset and recorded again
+        createInfo.flags = type == QueueType::TRANSFER ? VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+                                                       : VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        VkCommandPool pool = VK_NULL_HANDLE;
+        VK_CHECK_RESULT(vkCreateCommandPool(device, &createInfo, nullptr, &pool))
+        return pool;
+    }
+
+    uint32_t LogicalDevice::getQueueFamilyIndex(QueueType type) const {
+        switch (type) {
+            case QueueType::COMPUTE:
+                return physicalDevice->computeFamilyIndex;
+            case QueueType::TRANSFER:
+                return physicalDevice->transferFamilyIndex;
+            default:
+                return physicalDevice->graphicsFamilyIndex;
+        }
+    }
+
+    void LogicalDevice::waitIdle() {
+        std::scoped_lock lock(queueMutex);
+        vkDeviceWaitIdle(device);
+    }
+
+    std::vector<HeapBudget> LogicalDevice::getHeapBudgets() const {
+        const VkPhysicalDeviceMemoryProperties *properties = nullptr;
+        vmaGetMemoryProperties(allocator, &properties);
+
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS]{};
+        vmaGetBudget(allocator, budgets);
+
+        std::vector<HeapBudget> heaps(properties->memoryHeapCount);
+        for (uint32_t i = 0; i < properties->memoryHeapCount; i++) {
+            const auto &heap = properties->memoryHeaps[i];
+            heaps[i] = {i, (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0, heap.size, budgets[i].usage,
+                        budgets[i].budget, budgets[i].blockBytes, budgets[i].allocationBytes};
+        }
+        return heaps;
+    }
+
+    std::string LogicalDevice::dumpMemoryStatistics(bool detailed) const {
+        std::string json = "{\"Categories\": " + memoryStatistics.toJson() + ", \"Budgets\": [";
+        const auto heaps = getHeapBudgets();
+        for (size_t i = 0; i < heaps.size(); i++) {
+            const auto &heap = heaps[i];
+            json += fmt::format("{}{{\"Heap\": {}, \"DeviceLocal\": {}, \"Size\": {}, \"Usage\": {}, "
+                                "\"Budget\": {}, \"BlockBytes\": {}, \"AllocationBytes\": {}}}", i == 0 ? "" : ", ",
+                                heap.heap, heap.deviceLocal, heap.size, heap.usage, heap.budget, heap.blockBytes,
+                                heap.allocationBytes);
+        }
+
+        char *statistics = nullptr;
+        vmaBuildStatsString(allocator, &statistics, detailed ? VK_TRUE : VK_FALSE);
+        json += "], \"Allocator\": ";
+        json += statistics;
+        vmaFreeStatsString(allocator, statistics);
+        return json + "}";
+    }
+
     void LogicalDevice::chooseSwapSurfaceFormat() {
         SwapChainSupportDetails details = physicalDevice->querySwapChainSupportDetails();
 
@@ -132,13 +250,7 @@ namespace Vixen {
             std::numeric_limits<uint32_t>::max()) {
             extent = details.capabilities.currentExtent;
         } else {
-            int width, height;
-            glfwGetFramebufferSize(window->window, &width, &height);
-
-            VkExtent2D actualExtent = {
-                    static_cast<uint32_t>(width),
-                    static_cast<uint32_t>(height)
-            };
+            VkExtent2D actualExtent = window->getFramebufferSize();
 
             actualExtent.width = std::max(details.capabilities.minImageExtent.width,
                                           std::min(
@@ -225,13 +337,7 @@ namespace Vixen {
     }
 
     void LogicalDevice::destroySwapchain() {
-        int width = 0, height = 0;
-        while (width == 0 || height == 0) {
-            glfwGetFramebufferSize(window->window, &width, &height);
-            glfwWaitEvents();
-        }
-
-        vkDeviceWaitIdle(device);
+        waitIdle();
 
         for (const auto &imageView : imageViews)
             vkDestroyImageView(device, imageView, nullptr);
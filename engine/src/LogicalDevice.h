@@ -2,14 +2,44 @@
 
 #include <cstdio>
 #include <vk_mem_alloc.h>
+#include <array>
 #include <set>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "Logger.h"
+#include "MemoryStatistics.h"
 #include "Vulkan.h"
 #include "PhysicalDevice.h"
 
 namespace Vixen {
+    /**
+     * The kinds of queues work can be submitted to
+     */
+    enum class QueueType {
+        GRAPHICS,
+        COMPUTE,
+        TRANSFER
+    };
+
     class LogicalDevice {
+        /**
+         * The thread that created the device, it uses the command pools below
+         */
+        const std::thread::id owner = std::this_thread::get_id();
+
+        mutable std::mutex threadCommandPoolMutex;
+
+        /**
+         * The command pools of every other thread that recorded commands, indexed by queue type
+         */
+        mutable std::unordered_map<std::thread::id, std::array<VkCommandPool, 3>> threadCommandPools;
+
+        [[nodiscard]] VkCommandPool createCommandPool(QueueType type) const;
+
     public:
         Logger logger{"LogicalDevice"};
 
@@ -21,19 +51,46 @@ namespace Vixen {
         VmaAllocator allocator = VK_NULL_HANDLE;
 
         /**
-         * The command pool used by this renderer
+         * Whether VK_EXT_memory_budget is enabled, heap budgets are estimated by the allocator without it
+         */
+        bool memoryBudget = false;
+
+        /**
+         * Every buffer and image allocation, by what it is used for
+         */
+        MemoryStatistics memoryStatistics;
+
+        /**
+         * Whether some device local memory can be mapped by the host, dynamic buffers are placed there
+         */
+        bool hostVisibleDeviceMemory = false;
+
+        /**
+         * Whether all of device local memory can be mapped by the host, through Resizable BAR or because the device
+         * shares its memory with the host. Device buffers are then mapped and small uploads skip the staging copy.
+         */
+        bool mappableDeviceMemory = false;
+
+        /**
+         * The command pool used by this renderer on the thread that created the device
          */
         VkCommandPool commandPool = VK_NULL_HANDLE;
 
         /**
-         * The command pool used for memory transfer operations
+         * The command pool used for memory transfer operations on the thread that created the device
          */
         VkCommandPool transferCommandPool = VK_NULL_HANDLE;
 
         /**
-         * The memory transfer fence
+         * The command pool used for work on the compute queue on the thread that created the device
          */
-        VkFence transferFence = VK_NULL_HANDLE;
+        VkCommandPool computeCommandPool = VK_NULL_HANDLE;
+
+        /**
+         * Guards every submission to and presentation on the queues, Vulkan requires queues to be externally
+         * synchronized and the render thread submits alongside the asset uploads
+         */
+        std::mutex queueMutex;
 
         /**
          * The Vulkan swap chain
@@ -55,6 +112,11 @@ namespace Vixen {
          */
         VkQueue transferQueue = {};
 
+        /**
+         * The compute queue, this is the graphics queue when the device has no separate compute family
+         */
+        VkQueue computeQueue = {};
+
         /**
          * The extent currently being used by this Vulkan physical device
          */
@@ -111,6 +173,33 @@ namespace Vixen {
 
         ~LogicalDevice();
 
+        [[nodiscard]] VkQueue getQueue(QueueType type) const;
+
+        /**
+         * The command pool of the calling thread for a queue, command pools must not be used by two threads at once so
+         * every thread gets pools of its own the first time it asks for one
+         */
+        [[nodiscard]] VkCommandPool getCommandPool(QueueType type) const;
+
+        [[nodiscard]] uint32_t getQueueFamilyIndex(QueueType type) const;
+
+        /**
+         * Waits until the device is idle, holding the queue lock so no other thread submits in the meantime
+         */
+        void waitIdle();
+
+        /**
+         * The budget and usage of every memory heap, refreshed once per frame
+         */
+        [[nodiscard]] std::vector<HeapBudget> getHeapBudgets() const;
+
+        /**
+         * Dumps the allocations of every category, the heap budgets and the allocator's own statistics as JSON
+         *
+         * @param[in] detailed Whether to include every memory block and allocation of the allocator
+         */
+        [[nodiscard]] std::string dumpMemoryStatistics(bool detailed = false) const;
+
         /**
          * Pick the best surface format from the available formats
          */
@@ -0,0 +1,56 @@
+#include "MainLoop.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Vixen {
+    MainLoop::MainLoop(double timestep, uint32_t maxTicks) : timestep(timestep), maxTicks(maxTicks) {
+        if (timestep <= 0.0)
+            throw std::runtime_error("The timestep of the main loop must be positive");
+        if (maxTicks == 0)
+            throw std::runtime_error("The main loop must run at least one tick per frame");
+    }
+
+    uint32_t MainLoop::advance() {
+        const auto now = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> elapsed = now - lastFrame;
+        lastFrame = now;
+        return advance(elapsed.count());
+    }
+
+    uint32_t MainLoop::advance(double elapsed) {
+        elapsed = std::max(elapsed, 0.0);
+        frameTime = std::min(elapsed, maxTicks * timestep);
+
+        accumulator += elapsed;
+        auto ticks = static_cast<uint64_t>(accumulator / timestep);
+        if (ticks > maxTicks) {
+            droppedTime += static_cast<double>(ticks - maxTicks) * timestep;
+            accumulator -= static_cast<double>(ticks - maxTicks) * timestep;
+            ticks = maxTicks;
+        }
+        /// Rounding may take the accumulator a hair below zero
+        accumulator = std::max(accumulator - static_cast<double>(ticks) * timestep, 0.0);
+        tickCount += ticks;
+        return static_cast<uint32_t>(ticks);
+    }
+
+    float MainLoop::getAlpha() const {
+        return static_cast<float>(std::min(accumulator / timestep, 1.0));
+    }
+
+    double MainLoop::getTimestep() const {
+        return timestep;
+    }
+
+    double MainLoop::getFrameTime() const {
+        return frameTime;
+    }
+
+    uint64_t MainLoop::getTickCount() const {
+        return tickCount;
+    }
+
+    double MainLoop::getDroppedTime() const {
+        return droppedTime;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace Vixen {
+    /**
+     * Runs a simulation at a fixed tick rate, independent of the frame rate. Every frame the elapsed time is added to
+     * an accumulator and as many whole ticks are simulated as fit into it. The remainder carries over into the next
+     * frame and tells rendering how far to interpolate between the last two ticks.
+     *
+     * If ticks take longer to simulate than the time they cover, the accumulator would grow every frame. A frame
+     * therefore runs at most a fixed amount of ticks and drops the time beyond them, so the simulation slows down
+     * instead of stalling.
+     */
+    class MainLoop {
+        const double timestep;
+
+        const uint32_t maxTicks;
+
+        std::chrono::steady_clock::time_point lastFrame = std::chrono::steady_clock::now();
+
+        /// The time that has passed but was not simulated yet, less than one tick after every frame
+        double accumulator = 0.0;
+
+        double frameTime = 0.0;
+
+        uint64_t tickCount = 0;
+
+        double droppedTime = 0.0;
+
+    public:
+        /**
+         * @param[in] timestep The seconds simulated by every tick
+         * @param[in] maxTicks The most ticks a single frame runs
+         */
+        explicit MainLoop(double timestep = 1.0 / 60.0, uint32_t maxTicks = 5);
+
+        /**
+         * Measures the time since the previous frame and returns how many ticks to simulate in this one
+         */
+        uint32_t advance();
+
+        /**
+         * Advances by a given amount of seconds instead of measuring it, for headless runs and replays
+         */
+        uint32_t advance(double elapsed);
+
+        /**
+         * Advances the clock and calls a function with the timestep for every tick of the frame
+         *
+         * @return The interpolation factor to render the frame with
+         */
+        template<typename F>
+        float frame(F &&tick) {
+            for (uint32_t i = advance(); i > 0; i--)
+                tick(timestep);
+            return getAlpha();
+        }
+
+        /**
+         * How far the clock is past the last tick as a fraction of a tick. Rendering blends the last two ticks with it,
+         * which shows the simulation one tick late but without any stutter.
+         */
+        [[nodiscard]] float getAlpha() const;
+
+        [[nodiscard]] double getTimestep() const;
+
+        /**
+         * The seconds the last frame took, capped to the time of the most ticks a frame runs
+         */
+        [[nodiscard]] double getFrameTime() const;
+
+        /**
+         * The amount of ticks simulated so far
+         */
+        [[nodiscard]] uint64_t getTickCount() const;
+
+        /**
+         * The seconds dropped so far because frames fell too far behind
+         */
+        [[nodiscard]] double getDroppedTime() const;
+    };
+}
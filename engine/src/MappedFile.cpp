@@ -0,0 +1,95 @@
+#include "MappedFile.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Vixen {
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+        file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Failed to open file for mapping");
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to query file size");
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        /// Empty files can not be mapped
+        if (size == 0)
+            return;
+
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map file");
+        }
+
+        data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map file");
+        }
+    }
+
+    MappedFile::~MappedFile() {
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+    }
+#else
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+        const int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor == -1)
+            throw std::runtime_error("Failed to open file for mapping");
+
+        struct stat status{};
+        if (fstat(descriptor, &status) == -1) {
+            close(descriptor);
+            throw std::runtime_error("Failed to query file size");
+        }
+        size = static_cast<size_t>(status.st_size);
+        /// Empty files can not be mapped
+        if (size == 0) {
+            close(descriptor);
+            return;
+        }
+
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        /// The mapping keeps its own reference to the file
+        close(descriptor);
+        if (mapped == MAP_FAILED)
+            throw std::runtime_error("Failed to map file");
+
+        /// The contents are read front to back and copied into staging memory once
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const uint8_t *>(mapped);
+    }
+
+    MappedFile::~MappedFile() {
+        if (data)
+            munmap(const_cast<uint8_t *>(data), size);
+    }
+#endif
+
+    const uint8_t *MappedFile::getData() const {
+        return data;
+    }
+
+    size_t MappedFile::getSize() const {
+        return size;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace Vixen {
+    /**
+     * A read only view of a whole file mapped into memory, pages are only read from disk when they are touched
+     */
+    class MappedFile {
+        const uint8_t *data = nullptr;
+
+        size_t size = 0;
+
+#ifdef _WIN32
+        void *file = nullptr;
+
+        void *mapping = nullptr;
+#endif
+
+    public:
+        /**
+         * @throws std::runtime_error When the file can not be opened or mapped
+         */
+        explicit MappedFile(const std::filesystem::path &path);
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile();
+
+        [[nodiscard]] const uint8_t *getData() const;
+
+        [[nodiscard]] size_t getSize() const;
+    };
+}
@@ -0,0 +1,82 @@
+#include "MemoryStatistics.h"
+#include <fmt/format.h>
+
+namespace Vixen {
+    const char *MemoryStatistics::getName(MemoryCategory category) {
+        switch (category) {
+            case MemoryCategory::MESH:
+                return "Meshes";
+            case MemoryCategory::TEXTURE:
+                return "Textures";
+            case MemoryCategory::RENDER_TARGET:
+                return "RenderTargets";
+            case MemoryCategory::STAGING:
+                return "Staging";
+            default:
+                return "Other";
+        }
+    }
+
+    MemoryCategory MemoryStatistics::categorizeBuffer(VkBufferUsageFlags usage) {
+        if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT))
+            return MemoryCategory::MESH;
+        if (usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+            return MemoryCategory::STAGING;
+        return MemoryCategory::OTHER;
+    }
+
+    MemoryCategory MemoryStatistics::categorizeImage(VkImageUsageFlags usage) {
+        if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))
+            return MemoryCategory::RENDER_TARGET;
+        if (usage & VK_IMAGE_USAGE_SAMPLED_BIT)
+            return MemoryCategory::TEXTURE;
+        return MemoryCategory::OTHER;
+    }
+
+    void MemoryStatistics::track(VmaAllocation allocation, MemoryCategory category, const VmaAllocationInfo &info) {
+        std::scoped_lock lock(mutex);
+        records[allocation] = {category, info.size, info.deviceMemory};
+        auto &usage = categories[static_cast<size_t>(category)];
+        usage.bytes += info.size;
+        usage.allocations++;
+        blocks[info.deviceMemory] += info.size;
+    }
+
+    void MemoryStatistics::untrack(VmaAllocation allocation) {
+        std::scoped_lock lock(mutex);
+        const auto record = records.find(allocation);
+        if (record == records.end())
+            return;
+
+        auto &usage = categories[static_cast<size_t>(record->second.category)];
+        usage.bytes -= record->second.size;
+        usage.allocations--;
+        if (const auto block = blocks.find(record->second.memory); block != blocks.end()) {
+            block->second -= record->second.size;
+            if (block->second == 0)
+                blocks.erase(block);
+        }
+        records.erase(record);
+    }
+
+    MemoryStatistics::Usage MemoryStatistics::getUsage(MemoryCategory category) const {
+        std::scoped_lock lock(mutex);
+        return categories[static_cast<size_t>(category)];
+    }
+
+    VkDeviceSize MemoryStatistics::getBlockUsage(VkDeviceMemory memory) const {
+        std::scoped_lock lock(mutex);
+        const auto block = blocks.find(memory);
+        return block == blocks.end() ? 0 : block->second;
+    }
+
+    std::string MemoryStatistics::toJson() const {
+        std::scoped_lock lock(mutex);
+        std::string json = "{";
+        for (size_t i = 0; i < categoryCount; i++)
+            json += fmt::format("{}\"{}\": {{\"Bytes\": {}, \"Allocations\": {}}}", i == 0 ? "" : ", ",
+                                getName(static_cast<MemoryCategory>(i)), categories[i].bytes,
+                                categories[i].allocations);
+        return json + "}";
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vk_mem_alloc.h>
+
+namespace Vixen {
+    /**
+     * What an allocation is used for, derived from the usage it was created with
+     */
+    enum class MemoryCategory : uint8_t {
+        /// Vertex and index buffers
+        MESH,
+        /// Sampled images that are not rendered to
+        TEXTURE,
+        /// Color and depth attachments
+        RENDER_TARGET,
+        /// Buffers that are only ever copied from
+        STAGING,
+        /// Uniform and storage buffers
+        OTHER
+    };
+
+    /**
+     * The usage of a memory heap as reported by the driver, estimated by the allocator when VK_EXT_memory_budget is not
+     * supported
+     */
+    struct HeapBudget {
+        uint32_t heap;
+
+        bool deviceLocal;
+
+        VkDeviceSize size;
+
+        /// The bytes in use by this process, including memory not allocated through the allocator
+        VkDeviceSize usage;
+
+        /// The bytes this process can use before allocations start to fail or degrade performance
+        VkDeviceSize budget;
+
+        /// The bytes of the memory blocks the allocator holds in this heap
+        VkDeviceSize blockBytes;
+
+        /// The bytes of the allocations made from those blocks
+        VkDeviceSize allocationBytes;
+    };
+
+    /**
+     * Accounts every buffer and image allocation by category and by the memory block it was placed in. Thread safe.
+     */
+    class MemoryStatistics {
+    public:
+        static constexpr size_t categoryCount = 5;
+
+        struct Usage {
+            VkDeviceSize bytes = 0;
+
+            uint32_t allocations = 0;
+        };
+
+    private:
+        struct Record {
+            MemoryCategory category;
+
+            VkDeviceSize size;
+
+            VkDeviceMemory memory;
+        };
+
+        mutable std::mutex mutex;
+
+        std::unordered_map<VmaAllocation, Record> records;
+
+        std::array<Usage, categoryCount> categories{};
+
+        /// The bytes allocated from every memory block
+        std::unordered_map<VkDeviceMemory, VkDeviceSize> blocks;
+
+    public:
+        static const char *getName(MemoryCategory category);
+
+        static MemoryCategory categorizeBuffer(VkBufferUsageFlags usage);
+
+        static MemoryCategory categorizeImage(VkImageUsageFlags usage);
+
+        void track(VmaAllocation allocation, MemoryCategory category, const VmaAllocationInfo &info);
+
+        void untrack(VmaAllocation allocation);
+
+        [[nodiscard]] Usage getUsage(MemoryCategory category) const;
+
+        /**
+         * The bytes of tracked allocations placed in a memory block
+         */
+        [[nodiscard]] VkDeviceSize getBlockUsage(VkDeviceMemory memory) const;
+
+        /**
+         * The usage of every category as a JSON object
+         */
+        [[nodiscard]] std::string toJson() const;
+    };
+}
@@ -1,39 +1,142 @@
 #include "Mesh.h"
+#include <limits>
 
 namespace Vixen {
-    Mesh::Mesh(const std::shared_ptr<LogicalDevice> &logicalDevice, const std::shared_ptr<ImageView> &texture,
-               const std::vector<glm::vec3> &vertices, const std::vector<uint32_t> &indices,
-               const std::vector<glm::vec2> &uvs, const std::vector<glm::vec4> &colors)
-            : logicalDevice(logicalDevice), vertexCount(vertices.size()), indexCount(indices.size()),
-              texture(texture) {
-        if (vertices.size() != uvs.size())
-            throw std::runtime_error("Vertex count must be equal to UV count");
-        if (vertices.size() != colors.size())
-            throw std::runtime_error("Vertex count must be equal to color count");
-
-        VkDeviceSize vertexBufferSize = sizeof(glm::vec3) * vertices.size();
-        VkDeviceSize uvBufferSize = sizeof(glm::vec2) * vertices.size();
-        VkDeviceSize colorBufferSize = sizeof(glm::vec4) * vertices.size();
-        VkDeviceSize indexBufferSize = sizeof(uint32_t) * indices.size();
-        VkDeviceSize size = vertexBufferSize + uvBufferSize + colorBufferSize + indexBufferSize;
-        auto staging = Buffer(logicalDevice, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                    VMA_MEMORY_USAGE_CPU_ONLY);
-        void* data = staging.map();
-        memcpy(data, vertices.data(), vertexBufferSize);
-        memcpy(static_cast<char *>(data) + vertexBufferSize, uvs.data(), uvBufferSize);
-        memcpy(static_cast<char *>(data) + vertexBufferSize + uvBufferSize, colors.data(), colorBufferSize);
-        memcpy(static_cast<char *>(data) + vertexBufferSize + uvBufferSize + colorBufferSize, indices.data(),
-               indexBufferSize);
-        staging.unmap();
-
-        buffer = std::make_unique<Buffer>(logicalDevice, size,
-                                          VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
-                                          VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-        buffer->copyFrom(staging);
-    }
-
-    const std::unique_ptr<Buffer> &Mesh::getBuffer() const {
-        return buffer;
+    namespace {
+        /// Validates the streams before anything is staged, the bounds are needed to pick the layout
+        std::pair<glm::vec3, glm::vec3> bounds(const std::vector<glm::vec3> &vertices, const std::vector<glm::vec2> &uvs,
+                                               const std::vector<glm::vec4> &colors,
+                                               const std::vector<glm::vec3> &normals) {
+            if (vertices.size() != uvs.size())
+                throw std::runtime_error("Vertex count must be equal to UV count");
+            if (vertices.size() != colors.size())
+                throw std::runtime_error("Vertex count must be equal to color count");
+            if (vertices.size() != normals.size())
+                throw std::runtime_error("Vertex count must be equal to normal count");
+
+            if (vertices.empty())
+                return {};
+
+            glm::vec3 minimum = vertices[0];
+            glm::vec3 maximum = vertices[0];
+            for (const auto &vertex : vertices) {
+                minimum = glm::min(minimum, vertex);
+                maximum = glm::max(maximum, vertex);
+            }
+            return {minimum, maximum};
+        }
+
+        VkDeviceSize indexSize(uint32_t vertexCount) {
+            return Mesh::indexType(vertexCount) == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        }
+    }
+
+    Mesh::Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+               const std::shared_ptr<ImageView> &texture, const std::vector<glm::vec3> &vertices,
+               const std::vector<uint32_t> &indices, const std::vector<glm::vec2> &uvs,
+               const std::vector<glm::vec4> &colors, const std::vector<glm::vec3> &normals)
+            : Mesh(uploader, arena, texture, vertices, indices, uvs, colors, normals,
+                   bounds(vertices, uvs, colors, normals)) {}
+
+    Mesh::Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+               const std::shared_ptr<ImageView> &texture, const std::vector<glm::vec3> &vertices,
+               const std::vector<uint32_t> &indices, const std::vector<glm::vec2> &uvs,
+               const std::vector<glm::vec4> &colors, const std::vector<glm::vec3> &normals,
+               const std::pair<glm::vec3, glm::vec3> &bounds)
+            : Mesh(uploader, arena, texture, VertexLayout::choose(vertices, uvs, colors, bounds.first, bounds.second),
+                   vertices.size(), indices.size(), bounds.first, bounds.second,
+                   [&, packedVertices = false](void *destination, VkDeviceSize) mutable {
+                       if (packedVertices)
+                           packIndices(destination, indices, vertexCount);
+                       else
+                           layout.pack(destination, vertices, uvs, colors, normals, minimum, maximum);
+                       packedVertices = true;
+                   }) {}
+
+    Mesh::Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+               const std::shared_ptr<ImageView> &texture, const VertexLayout &layout, const void *data,
+               uint32_t vertexCount, uint32_t indexCount, const glm::vec3 &minimum, const glm::vec3 &maximum)
+            : Mesh(uploader, arena, texture, layout, vertexCount, indexCount, minimum, maximum,
+                   [source = static_cast<const char *>(data)](void *destination, VkDeviceSize size) mutable {
+                       memcpy(destination, source, size);
+                       source += size;
+                   }) {}
+
+    Mesh::Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+               const std::shared_ptr<ImageView> &texture, const VertexLayout &layout, uint32_t vertexCount,
+               uint32_t indexCount, const glm::vec3 &minimum, const glm::vec3 &maximum,
+               const std::function<void(void *, VkDeviceSize)> &fill)
+            : arena(arena), vertexCount(vertexCount), indexCount(indexCount), layout(layout), texture(texture),
+              minimum(minimum), maximum(maximum) {
+        const VkDeviceSize vertexSize = static_cast<VkDeviceSize>(vertexCount) * layout.getStride();
+        const VkDeviceSize indexBytes = static_cast<VkDeviceSize>(indexCount) * indexSize(vertexCount);
+        vertexRange = arena->allocateVertices(vertexSize, layout.getStride());
+        try {
+            indexRange = arena->allocateIndices(indexBytes, indexSize(vertexCount));
+            if (vertexSize > 0)
+                fill(uploader.stage(*vertexRange.buffer, vertexSize, vertexRange.offset), vertexSize);
+            if (indexBytes > 0)
+                fill(uploader.stage(*indexRange.buffer, indexBytes, indexRange.offset), indexBytes);
+        } catch (...) {
+            arena->freeVertices(vertexRange);
+            arena->freeIndices(indexRange);
+            throw;
+        }
+    }
+
+    Mesh::~Mesh() {
+        arena->freeVertices(vertexRange);
+        arena->freeIndices(indexRange);
+    }
+
+    VkBuffer Mesh::getVertexBuffer() const {
+        return vertexRange.buffer ? vertexRange.buffer->getBuffer() : VK_NULL_HANDLE;
+    }
+
+    VkBuffer Mesh::getIndexBuffer() const {
+        return indexRange.buffer ? indexRange.buffer->getBuffer() : VK_NULL_HANDLE;
+    }
+
+    int32_t Mesh::getVertexOffset() const {
+        return static_cast<int32_t>(vertexRange.offset / layout.getStride());
+    }
+
+    uint32_t Mesh::getFirstIndex() const {
+        return static_cast<uint32_t>(indexRange.offset / indexSize(vertexCount));
+    }
+
+    const GeometryArena::Range &Mesh::getVertexRange() const {
+        return vertexRange;
+    }
+
+    const GeometryArena::Range &Mesh::getIndexRange() const {
+        return indexRange;
+    }
+
+    std::pair<GeometryArena::Range, GeometryArena::Range> Mesh::relocate(CommandBuffer &commandBuffer) {
+        const auto move = [&](GeometryArena::Range &range, bool vertices) -> GeometryArena::Range {
+            const auto moved = vertices ? arena->allocateVertices(range.size, layout.getStride())
+                                        : arena->allocateIndices(range.size, indexSize(vertexCount));
+            /// First fit finds the lowest free range, when that lies after the current one the mesh is already compact
+            if (moved.block > range.block || (moved.block == range.block && moved.offset > range.offset)) {
+                vertices ? arena->freeVertices(moved) : arena->freeIndices(moved);
+                return {};
+            }
+
+            VkBufferCopy region{};
+            region.srcOffset = range.offset;
+            region.dstOffset = moved.offset;
+            region.size = range.size;
+            commandBuffer.cmdCopyBuffer(range.buffer->getBuffer(), moved.buffer->getBuffer(), {region});
+            return std::exchange(range, moved);
+        };
+
+        std::pair<GeometryArena::Range, GeometryArena::Range> previous;
+        if (vertexRange.size > 0)
+            previous.first = move(vertexRange, true);
+        if (indexRange.size > 0)
+            previous.second = move(indexRange, false);
+        return previous;
     }
 
     uint32_t Mesh::getVertexCount() const {
@@ -44,7 +147,53 @@ namespace Vixen {
         return indexCount;
     }
 
+    VkIndexType Mesh::getIndexType() const {
+        return indexType(vertexCount);
+    }
+
+    const VertexLayout &Mesh::getLayout() const {
+        return layout;
+    }
+
+    glm::mat4 Mesh::getDequantization() const {
+        return layout.getDequantization(minimum, maximum);
+    }
+
     const std::shared_ptr<const ImageView> &Mesh::getTexture() const {
         return texture;
     }
-}
\ No newline at end of file
+
+    void Mesh::setTexture(const std::shared_ptr<const ImageView> &texture) {
+        this->texture = texture;
+    }
+
+    const glm::vec3 &Mesh::getMinimum() const {
+        return minimum;
+    }
+
+    const glm::vec3 &Mesh::getMaximum() const {
+        return maximum;
+    }
+
+    VkDeviceSize Mesh::packedSize(const VertexLayout &layout, uint32_t vertexCount, uint32_t indexCount) {
+        return static_cast<VkDeviceSize>(vertexCount) * layout.getStride() +
+               static_cast<VkDeviceSize>(indexCount) * indexSize(vertexCount);
+    }
+
+    VkIndexType Mesh::indexType(uint32_t vertexCount) {
+        return vertexCount <= std::numeric_limits<uint16_t>::max() + 1u ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
+
+    void Mesh::packIndices(void *destination, const std::vector<uint32_t> &indices, uint32_t vertexCount) {
+        if (indexType(vertexCount) == VK_INDEX_TYPE_UINT32) {
+            memcpy(destination, indices.data(), indices.size() * sizeof(uint32_t));
+            return;
+        }
+
+        auto packed = static_cast<uint8_t *>(destination);
+        for (size_t i = 0; i < indices.size(); i++) {
+            const auto index = static_cast<uint16_t>(indices[i]);
+            memcpy(packed + i * sizeof(uint16_t), &index, sizeof(index));
+        }
+    }
+}
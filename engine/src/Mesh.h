@@ -1,40 +1,163 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <utility>
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 #include "LogicalDevice.h"
-#include "Buffer.h"
+#include "GeometryArena.h"
 #include "ImageView.h"
+#include "UploadManager.h"
+#include "VertexLayout.h"
 
 namespace Vixen {
     class Mesh {
-        const std::shared_ptr<LogicalDevice> logicalDevice;
+        const std::shared_ptr<GeometryArena> arena;
 
-        std::unique_ptr<Buffer> buffer;
+        GeometryArena::Range vertexRange;
+
+        GeometryArena::Range indexRange;
 
         const uint32_t vertexCount;
 
         const uint32_t indexCount;
 
-        const std::shared_ptr<const ImageView> texture;
+        const VertexLayout layout;
+
+        std::shared_ptr<const ImageView> texture;
+
+        glm::vec3 minimum{};
+
+        glm::vec3 maximum{};
+
+        Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+             const std::shared_ptr<ImageView> &texture, const std::vector<glm::vec3> &vertices,
+             const std::vector<uint32_t> &indices, const std::vector<glm::vec2> &uvs,
+             const std::vector<glm::vec4> &colors, const std::vector<glm::vec3> &normals,
+             const std::pair<glm::vec3, glm::vec3> &bounds);
 
     public:
-        Mesh(const std::shared_ptr<LogicalDevice> &logicalDevice, const std::shared_ptr<ImageView> &texture,
-             const std::vector<glm::vec3> &vertices, const std::vector<uint32_t> &indices,
-             const std::vector<glm::vec2> &uvs, const std::vector<glm::vec4> &colors);
+        /**
+         * Allocates the mesh from the arena and queues its upload, the mesh can be drawn by graphics work submitted
+         * after the uploader's next flush. The vertices are packed in the most compact layout that keeps the default
+         * precision.
+         */
+        Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+             const std::shared_ptr<ImageView> &texture, const std::vector<glm::vec3> &vertices,
+             const std::vector<uint32_t> &indices, const std::vector<glm::vec2> &uvs,
+             const std::vector<glm::vec4> &colors, const std::vector<glm::vec3> &normals);
+
+        /**
+         * Allocates the mesh from the arena and queues the upload of data already in the uploaded layout
+         *
+         * @param[in] data packedSize(layout, vertexCount, indexCount) bytes, the packed vertices followed by the
+         * indices
+         * @param[in] minimum The bounds the positions were quantized against
+         */
+        Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+             const std::shared_ptr<ImageView> &texture, const VertexLayout &layout, const void *data,
+             uint32_t vertexCount, uint32_t indexCount, const glm::vec3 &minimum, const glm::vec3 &maximum);
+
+        /**
+         * Allocates the mesh from the arena and lets the caller write the packed data straight into staging memory
+         *
+         * @param[in] fill Called twice in the order of the packed data, first with the staging memory of the vertices
+         * and then with that of the indices
+         */
+        Mesh(UploadManager &uploader, const std::shared_ptr<GeometryArena> &arena,
+             const std::shared_ptr<ImageView> &texture, const VertexLayout &layout, uint32_t vertexCount,
+             uint32_t indexCount, const glm::vec3 &minimum, const glm::vec3 &maximum,
+             const std::function<void(void *destination, VkDeviceSize size)> &fill);
 
         Mesh(const Mesh &) = delete;
 
         Mesh &operator=(const Mesh &) = delete;
 
-        [[nodiscard]] const std::unique_ptr<Buffer> &getBuffer() const;
+        /**
+         * Returns the ranges to the arena, the mesh must no longer be used by pending GPU work
+         */
+        ~Mesh();
+
+        /**
+         * The arena buffer holding the vertices, shared with other meshes
+         */
+        [[nodiscard]] VkBuffer getVertexBuffer() const;
+
+        /**
+         * The arena buffer holding the indices, shared with other meshes
+         */
+        [[nodiscard]] VkBuffer getIndexBuffer() const;
+
+        /**
+         * The first vertex of this mesh in the vertex buffer, added to every index when drawing
+         */
+        [[nodiscard]] int32_t getVertexOffset() const;
+
+        /**
+         * The first index of this mesh in the index buffer
+         */
+        [[nodiscard]] uint32_t getFirstIndex() const;
+
+        [[nodiscard]] const GeometryArena::Range &getVertexRange() const;
+
+        [[nodiscard]] const GeometryArena::Range &getIndexRange() const;
+
+        /**
+         * Records copying the vertices and indices to the lowest free ranges of the arena when those lie before the
+         * current ones, which compacts the arena. Afterwards the mesh draws from the copies, command buffers drawing it
+         * have to be recorded again.
+         *
+         * @return The previous vertex and index ranges, free them once the copies and every command buffer drawing from
+         * them have finished. Ranges that did not move are empty.
+         */
+        std::pair<GeometryArena::Range, GeometryArena::Range> relocate(CommandBuffer &commandBuffer);
 
         [[nodiscard]] uint32_t getVertexCount() const;
 
         [[nodiscard]] uint32_t getIndexCount() const;
 
+        [[nodiscard]] VkIndexType getIndexType() const;
+
+        [[nodiscard]] const VertexLayout &getLayout() const;
+
+        /**
+         * Maps the positions fetched from the vertex buffer to model space, the identity unless they are quantized
+         */
+        [[nodiscard]] glm::mat4 getDequantization() const;
+
         [[nodiscard]] const std::shared_ptr<const ImageView> &getTexture() const;
+
+        /**
+         * Replaces the texture, used to swap in a texture that finished loading after the mesh. Command buffers that
+         * already reference the old texture are not affected until they are recorded again.
+         */
+        void setTexture(const std::shared_ptr<const ImageView> &texture);
+
+        /**
+         * The minimum corner of the axis aligned bounding box of this mesh in model space
+         */
+        [[nodiscard]] const glm::vec3 &getMinimum() const;
+
+        /**
+         * The maximum corner of the axis aligned bounding box of this mesh in model space
+         */
+        [[nodiscard]] const glm::vec3 &getMaximum() const;
+
+        /**
+         * The size of the packed data of a mesh, the interleaved vertices followed by the indices
+         */
+        static VkDeviceSize packedSize(const VertexLayout &layout, uint32_t vertexCount, uint32_t indexCount);
+
+        /**
+         * Meshes whose vertices can all be addressed with 16 bit indices use them, halving the index data
+         */
+        static VkIndexType indexType(uint32_t vertexCount);
+
+        /**
+         * Writes the indices in the index type of a mesh with the given amount of vertices
+         */
+        static void packIndices(void *destination, const std::vector<uint32_t> &indices, uint32_t vertexCount);
     };
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "MeshCache.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "AssetCache.h"
+
+namespace Vixen {
+    namespace {
+        constexpr std::array<char, 4> magic{'V', 'X', 'M', 'C'};
+
+        constexpr uint64_t alignment = 16;
+
+        struct Header {
+            std::array<char, 4> magic;
+            uint32_t version;
+            uint64_t sourceSize;
+            int64_t sourceModified;
+            uint32_t importFlags;
+            uint32_t meshCount;
+            /// The offset of the first packed mesh from the start of the file
+            uint64_t dataOffset;
+        };
+
+        struct Record {
+            uint32_t vertexCount;
+            uint32_t indexCount;
+            float minimum[3];
+            float maximum[3];
+            /// The offset of the packed mesh data from the start of the file
+            uint64_t offset;
+            /// The offset of the texture reference from the start of the file, its length is zero when untextured
+            uint32_t textureOffset;
+            uint32_t textureLength;
+            /// See VertexLayout::encode
+            uint32_t layout;
+            uint32_t reserved;
+        };
+
+        static_assert(sizeof(Header) == MeshCache::headerSize && sizeof(Record) == 56);
+
+        uint64_t align(uint64_t offset) {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        /**
+         * Packs every mesh into its own buffer and describes it as an entry pointing into that buffer
+         */
+        std::vector<MeshCache::Entry> pack(const std::vector<MeshData> &meshes,
+                                           std::vector<std::vector<uint8_t>> &packed) {
+            packed.resize(meshes.size());
+            std::vector<MeshCache::Entry> entries;
+            entries.reserve(meshes.size());
+            for (size_t i = 0; i < meshes.size(); i++) {
+                packed[i].resize(Mesh::packedSize(meshes[i].layout, meshes[i].vertices.size(),
+                                                  meshes[i].indices.size()));
+                MeshImporter::pack(meshes[i], packed[i].data());
+                entries.push_back(MeshCache::describe(meshes[i], packed[i].data()));
+            }
+            return entries;
+        }
+    }
+
+    MeshCache::Source MeshCache::Source::of(const std::filesystem::path &model, uint32_t importFlags) {
+        return {
+                std::filesystem::file_size(model),
+                static_cast<int64_t>(std::filesystem::last_write_time(model).time_since_epoch().count()),
+                importFlags
+        };
+    }
+
+    MeshCache::MeshCache(const std::filesystem::path &path, const Source &source)
+            : file(std::make_unique<MappedFile>(path)),
+              entries(parse(file->getData(), file->getSize(), source)) {
+        for (const auto &entry : entries)
+            if (!entry.data)
+                throw std::runtime_error("Mesh cache is truncated");
+    }
+
+    const std::vector<MeshCache::Entry> &MeshCache::getEntries() const {
+        return entries;
+    }
+
+    std::vector<MeshCache::Entry> MeshCache::parse(const uint8_t *data, size_t size,
+                                                   const std::optional<Source> &source) {
+        if (size < sizeof(Header))
+            throw std::runtime_error("Mesh cache is truncated");
+        Header header{};
+        memcpy(&header, data, sizeof(header));
+        if (header.magic != magic)
+            throw std::runtime_error("File is not a mesh cache");
+        if (header.version != version)
+            throw std::runtime_error("Mesh cache was written by another version");
+        if (source && Source{header.sourceSize, header.sourceModified, header.importFlags} != *source)
+            throw std::runtime_error("Mesh cache is out of date");
+        if (header.dataOffset > size ||
+            sizeof(Header) + static_cast<uint64_t>(header.meshCount) * sizeof(Record) > header.dataOffset)
+            throw std::runtime_error("Mesh cache is truncated");
+
+        std::vector<Entry> entries;
+        entries.reserve(header.meshCount);
+        for (uint32_t i = 0; i < header.meshCount; i++) {
+            Record record{};
+            memcpy(&record, data + sizeof(Header) + i * sizeof(Record), sizeof(record));
+
+            if (static_cast<uint64_t>(record.textureOffset) + record.textureLength > header.dataOffset)
+                throw std::runtime_error("Mesh cache is truncated");
+            const auto layout = VertexLayout::decode(record.layout);
+            const uint64_t length = Mesh::packedSize(layout, record.vertexCount, record.indexCount);
+            const bool present = record.offset <= size && length <= size - record.offset;
+
+            entries.push_back({
+                    record.vertexCount,
+                    record.indexCount,
+                    {record.minimum[0], record.minimum[1], record.minimum[2]},
+                    {record.maximum[0], record.maximum[1], record.maximum[2]},
+                    layout,
+                    std::string(reinterpret_cast<const char *>(data + record.textureOffset), record.textureLength),
+                    record.offset,
+                    present ? data + record.offset : nullptr
+            });
+        }
+        return entries;
+    }
+
+    uint64_t MeshCache::getDataOffset(const uint8_t *header) {
+        Header contents{};
+        memcpy(&contents, header, sizeof(contents));
+        if (contents.magic != magic)
+            throw std::runtime_error("File is not a mesh cache");
+        if (contents.version != version)
+            throw std::runtime_error("Mesh cache was written by another version");
+        return contents.dataOffset;
+    }
+
+    void MeshCache::write(const std::filesystem::path &path, const Source &source, const std::vector<Entry> &meshes) {
+        std::filesystem::create_directories(path.parent_path());
+        auto temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+            if (!stream)
+                throw std::runtime_error("Failed to create mesh cache");
+
+            write(stream, source, meshes);
+        }
+        std::filesystem::rename(temporary, path);
+    }
+
+    void MeshCache::write(std::ostream &stream, const Source &source, const std::vector<Entry> &meshes) {
+        std::vector<Record> records(meshes.size());
+        uint64_t offset = sizeof(Header) + meshes.size() * sizeof(Record);
+        for (size_t i = 0; i < meshes.size(); i++) {
+            records[i].textureOffset = static_cast<uint32_t>(offset);
+            records[i].textureLength = static_cast<uint32_t>(meshes[i].texture.size());
+            offset += meshes[i].texture.size();
+        }
+
+        const uint64_t dataOffset = align(offset);
+        offset = dataOffset;
+        for (size_t i = 0; i < meshes.size(); i++) {
+            const auto &mesh = meshes[i];
+            auto &record = records[i];
+            record.vertexCount = mesh.vertexCount;
+            record.indexCount = mesh.indexCount;
+            memcpy(record.minimum, &mesh.minimum, sizeof(record.minimum));
+            memcpy(record.maximum, &mesh.maximum, sizeof(record.maximum));
+            record.layout = mesh.layout.encode();
+            record.offset = align(offset);
+            offset = record.offset + Mesh::packedSize(mesh.layout, record.vertexCount, record.indexCount);
+        }
+
+        const Header header{magic, version, source.size, source.modified, source.importFlags,
+                            static_cast<uint32_t>(meshes.size()), dataOffset};
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char *>(records.data()),
+                     static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        uint64_t position = sizeof(Header) + records.size() * sizeof(Record);
+        for (const auto &mesh : meshes) {
+            stream.write(mesh.texture.data(), static_cast<std::streamsize>(mesh.texture.size()));
+            position += mesh.texture.size();
+        }
+
+        static constexpr std::array<char, alignment> padding{};
+        for (size_t i = 0; i < meshes.size(); i++) {
+            stream.write(padding.data(), static_cast<std::streamsize>(records[i].offset - position));
+            position = records[i].offset;
+
+            const uint64_t size = Mesh::packedSize(meshes[i].layout, records[i].vertexCount, records[i].indexCount);
+            stream.write(reinterpret_cast<const char *>(meshes[i].data), static_cast<std::streamsize>(size));
+            position += size;
+        }
+        /// A model without meshes still ends at its data offset
+        if (position < dataOffset)
+            stream.write(padding.data(), static_cast<std::streamsize>(dataOffset - position));
+
+        if (!stream)
+            throw std::runtime_error("Failed to write mesh cache");
+    }
+
+    void MeshCache::write(const std::filesystem::path &path, const Source &source,
+                          const std::vector<MeshData> &meshes) {
+        std::vector<std::vector<uint8_t>> packed;
+        write(path, source, pack(meshes, packed));
+    }
+
+    void MeshCache::write(std::ostream &stream, const Source &source, const std::vector<MeshData> &meshes) {
+        std::vector<std::vector<uint8_t>> packed;
+        write(stream, source, pack(meshes, packed));
+    }
+
+    MeshCache::Entry MeshCache::describe(const MeshData &mesh, const uint8_t *packed) {
+        return {
+                static_cast<uint32_t>(mesh.vertices.size()),
+                static_cast<uint32_t>(mesh.indices.size()),
+                mesh.minimum,
+                mesh.maximum,
+                mesh.layout,
+                mesh.texture,
+                0,
+                packed
+        };
+    }
+
+    std::filesystem::path MeshCache::locate(const std::filesystem::path &directory,
+                                            const std::filesystem::path &model) {
+        const auto canonical = std::filesystem::canonical(model).string();
+        return directory / fmt::format("{:016x}.vxmesh", AssetCache::hash(canonical.data(), canonical.size()));
+    }
+}
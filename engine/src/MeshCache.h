@@ -0,0 +1,124 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "MeshImporter.h"
+#include "MappedFile.h"
+
+namespace Vixen {
+    /**
+     * A model converted into the exact layout the mesh buffers use, so later loads skip Assimp and copy every mesh from
+     * the mapped file into staging memory in one go. The file stores the size and modification time of the source
+     * model and the import flags, it is rejected when either changed or when it was written by another version.
+     *
+     * Layout, little endian: a header, one record per mesh, the texture references and finally the packed mesh data
+     * starting at the data offset, every mesh starting at a 16 byte boundary.
+     */
+    class MeshCache {
+    public:
+        static constexpr uint32_t version = 4;
+
+        /**
+         * The size of the header, which holds the data offset
+         */
+        static constexpr size_t headerSize = 40;
+
+        struct Source {
+            uint64_t size;
+
+            int64_t modified;
+
+            uint32_t importFlags;
+
+            /**
+             * @throws std::filesystem::filesystem_error When the model does not exist
+             */
+            static Source of(const std::filesystem::path &model, uint32_t importFlags);
+
+            bool operator==(const Source &) const = default;
+        };
+
+        struct Entry {
+            uint32_t vertexCount;
+
+            uint32_t indexCount;
+
+            glm::vec3 minimum;
+
+            glm::vec3 maximum;
+
+            VertexLayout layout;
+
+            /// The diffuse texture relative to the model file, empty when the mesh is untextured
+            std::string texture;
+
+            /// The offset of the packed data from the start of the file
+            uint64_t offset;
+
+            /// Mesh::packedSize(layout, vertexCount, indexCount) bytes of packed data, null when it was not part of the
+            /// parsed memory
+            const uint8_t *data;
+        };
+
+        /**
+         * Maps a cache file and validates it against its source
+         *
+         * @throws std::runtime_error When the file is missing, truncated, of another version or out of date
+         */
+        MeshCache(const std::filesystem::path &path, const Source &source);
+
+        [[nodiscard]] const std::vector<Entry> &getEntries() const;
+
+        /**
+         * Parses the records of a cache file held in memory, at least everything before the data offset must be present
+         *
+         * @param[in] source The source the file must have been written for, any source is accepted when empty
+         * @throws std::runtime_error When the contents are truncated, of another version or out of date
+         */
+        static std::vector<Entry> parse(const uint8_t *data, size_t size, const std::optional<Source> &source);
+
+        /**
+         * Reads the offset of the packed mesh data from the first headerSize bytes of a cache file
+         */
+        static uint64_t getDataOffset(const uint8_t *header);
+
+        /**
+         * Writes a cache file, the file is written under a temporary name first so readers never see a partial file
+         *
+         * @param[in] meshes Meshes that are packed already, the data of every entry is written as it is and its offset
+         * is ignored
+         */
+        static void write(const std::filesystem::path &path, const Source &source, const std::vector<Entry> &meshes);
+
+        static void write(std::ostream &stream, const Source &source, const std::vector<Entry> &meshes);
+
+        /**
+         * Packs freshly imported meshes and writes them as a cache file
+         */
+        static void write(const std::filesystem::path &path, const Source &source, const std::vector<MeshData> &meshes);
+
+        static void write(std::ostream &stream, const Source &source, const std::vector<MeshData> &meshes);
+
+        /**
+         * Describes a packed mesh as an entry, the entry points at the packed data and has no offset
+         *
+         * @param[in] packed Mesh::packedSize(mesh.layout, vertexCount, indexCount) bytes packed by MeshImporter::pack
+         */
+        static Entry describe(const MeshData &mesh, const uint8_t *packed);
+
+        /**
+         * The cache file of a model inside a cache directory, named after the hash of the model's canonical path
+         */
+        static std::filesystem::path locate(const std::filesystem::path &directory, const std::filesystem::path &model);
+
+    private:
+        std::unique_ptr<MappedFile> file;
+
+        std::vector<Entry> entries;
+    };
+}
@@ -0,0 +1,109 @@
+#include "MeshImporter.h"
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include "Logger.h"
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+
+namespace Vixen {
+    MeshData MeshImporter::convert(const aiScene *aiScene, const aiMesh *aiMesh,
+                                   const VertexLayout::Precision &precision) {
+        static const Logger logger{"MeshImporter"};
+        MeshData data;
+
+        data.vertices.reserve(aiMesh->mNumVertices);
+        data.uvs.reserve(aiMesh->mNumVertices);
+        data.colors.reserve(aiMesh->mNumVertices);
+        data.normals.reserve(aiMesh->mNumVertices);
+        for (unsigned int j = 0; j < aiMesh->mNumVertices; j++) {
+            const auto &vertex = aiMesh->mVertices[j];
+            data.vertices.emplace_back(vertex.x, vertex.y, vertex.z);
+
+            if (aiMesh->HasTextureCoords(0)) {
+                const auto &uv = aiMesh->mTextureCoords[0][j];
+                data.uvs.emplace_back(uv.x, uv.y);
+            } else {
+                data.uvs.emplace_back(0.0f, 0.0f);
+            }
+
+            if (aiMesh->HasVertexColors(0)) {
+                const auto &color = aiMesh->mColors[0][j];
+                data.colors.emplace_back(color.r, color.g, color.b, color.a);
+            } else {
+                data.colors.emplace_back(1.0f, 1.0f, 1.0f, 1.0f);
+            }
+
+            if (aiMesh->HasNormals()) {
+                const auto &normal = aiMesh->mNormals[j];
+                data.normals.emplace_back(normal.x, normal.y, normal.z);
+            } else {
+                data.normals.emplace_back(0.0f, 0.0f, 1.0f);
+            }
+        }
+
+        if (!data.vertices.empty()) {
+            data.minimum = data.vertices[0];
+            data.maximum = data.vertices[0];
+            for (const auto &vertex : data.vertices) {
+                data.minimum = glm::min(data.minimum, vertex);
+                data.maximum = glm::max(data.maximum, vertex);
+            }
+        }
+        data.layout = VertexLayout::choose(data.vertices, data.uvs, data.colors, data.minimum, data.maximum, precision);
+
+        data.indices.reserve(aiMesh->mNumFaces * 3);
+        for (unsigned int x = 0; x < aiMesh->mNumFaces; x++) {
+            const auto &face = aiMesh->mFaces[x];
+            if (face.mNumIndices != 3) {
+                logger.warning("Skipping non-triangulated face");
+                continue;
+            }
+
+            data.indices.push_back(face.mIndices[0]);
+            data.indices.push_back(face.mIndices[1]);
+            data.indices.push_back(face.mIndices[2]);
+        }
+
+        if (aiMesh->mMaterialIndex < aiScene->mNumMaterials) {
+            const auto &material = aiScene->mMaterials[aiMesh->mMaterialIndex];
+            /// The last diffuse texture wins, matching the previous importer
+            const unsigned int count = material->GetTextureCount(aiTextureType_DIFFUSE);
+            if (count > 0) {
+                aiString str;
+                material->GetTexture(aiTextureType_DIFFUSE, count - 1, &str);
+                data.texture = str.C_Str();
+                std::replace(data.texture.begin(), data.texture.end(), '\\', '/');
+            }
+        }
+
+        const auto [before, after] = MeshOptimizer::optimize(data);
+        logger.trace("Optimized mesh \"{}\", ACMR {:.3f} -> {:.3f}, overfetch {:.3f} -> {:.3f}",
+                     aiMesh->mName.C_Str(), before.acmr, after.acmr, before.overfetch, after.overfetch);
+
+        return data;
+    }
+
+    std::vector<MeshData> MeshImporter::import(const std::string &path) {
+        Assimp::Importer importer;
+        const auto aiScene = importer.ReadFile(path, importFlags);
+        if (!aiScene)
+            throw std::runtime_error(importer.GetErrorString());
+
+        std::vector<MeshData> meshes;
+        meshes.reserve(aiScene->mNumMeshes);
+        for (uint32_t i = 0; i < aiScene->mNumMeshes; i++)
+            meshes.push_back(convert(aiScene, aiScene->mMeshes[i]));
+        return meshes;
+    }
+
+    void MeshImporter::pack(const MeshData &mesh, void *destination) {
+        mesh.layout.pack(destination, mesh.vertices, mesh.uvs, mesh.colors, mesh.normals, mesh.minimum, mesh.maximum);
+        Mesh::packIndices(static_cast<uint8_t *>(destination) + mesh.vertices.size() * mesh.layout.getStride(),
+                          mesh.indices, mesh.vertices.size());
+    }
+
+    std::string MeshImporter::resolve(const std::string &model, const std::string &texture) {
+        return std::filesystem::path(model).remove_filename().append(texture).lexically_normal().string();
+    }
+}
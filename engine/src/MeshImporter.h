@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include "VertexLayout.h"
+
+namespace Vixen {
+    /**
+     * The CPU side contents of an imported mesh, the streams are interleaved in the layout when uploaded
+     */
+    struct MeshData {
+        std::vector<glm::vec3> vertices;
+        std::vector<glm::vec2> uvs;
+        std::vector<glm::vec4> colors;
+        std::vector<glm::vec3> normals;
+        std::vector<uint32_t> indices;
+        glm::vec3 minimum{};
+        glm::vec3 maximum{};
+        VertexLayout layout;
+        /// The diffuse texture relative to the model file, empty when the mesh is untextured
+        std::string texture;
+    };
+
+    /**
+     * Converts Assimp meshes into the streams the engine uploads. Conversion does not touch the device so it can run on
+     * any thread.
+     */
+    struct MeshImporter {
+        /**
+         * The post-processing every model is imported with, part of the mesh cache key
+         */
+        static constexpr unsigned int importFlags = aiProcess_CalcTangentSpace | aiProcess_Triangulate |
+                                                    aiProcess_JoinIdenticalVertices | aiProcess_SortByPType |
+                                                    aiProcess_FlipUVs | aiProcess_GenSmoothNormals;
+
+        /**
+         * Converts a mesh, optimizes it for the GPU and picks its vertex layout
+         */
+        static MeshData convert(const aiScene *aiScene, const aiMesh *aiMesh,
+                                const VertexLayout::Precision &precision = {});
+
+        /**
+         * Reads and converts every mesh of a model on the calling thread
+         *
+         * @throws std::runtime_error When Assimp can not read the model
+         */
+        static std::vector<MeshData> import(const std::string &path);
+
+        /**
+         * Writes a mesh the way the mesh buffer lays it out, the interleaved vertices followed by the indices
+         *
+         * @param[out] destination Mesh::packedSize(mesh.layout, vertexCount, indexCount) bytes
+         */
+        static void pack(const MeshData &mesh, void *destination);
+
+        /**
+         * Resolves a texture reference of a mesh against the directory of its model
+         */
+        static std::string resolve(const std::string &model, const std::string &texture);
+    };
+}
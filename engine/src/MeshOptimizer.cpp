@@ -0,0 +1,49 @@
+#include "MeshOptimizer.h"
+#include <utility>
+#include <meshoptimizer.h>
+
+namespace Vixen {
+    namespace {
+        template<typename T>
+        void remap(std::vector<T> &stream, const std::vector<unsigned int> &remap, size_t vertexCount) {
+            std::vector<T> remapped(vertexCount);
+            meshopt_remapVertexBuffer(remapped.data(), stream.data(), stream.size(), sizeof(T), remap.data());
+            stream = std::move(remapped);
+        }
+    }
+
+    std::pair<MeshOptimizer::Statistics, MeshOptimizer::Statistics> MeshOptimizer::optimize(MeshData &mesh) {
+        const auto before = analyze(mesh);
+        if (mesh.indices.empty() || mesh.vertices.empty())
+            return {before, before};
+
+        const size_t vertexCount = mesh.vertices.size();
+        std::vector<unsigned int> indices(mesh.indices.size());
+        meshopt_optimizeVertexCache(indices.data(), mesh.indices.data(), mesh.indices.size(), vertexCount);
+        meshopt_optimizeOverdraw(mesh.indices.data(), indices.data(), indices.size(), &mesh.vertices[0].x,
+                                 vertexCount, sizeof(glm::vec3), overdrawThreshold);
+
+        /// Vertices no triangle references are dropped
+        std::vector<unsigned int> order(vertexCount);
+        const size_t usedCount = meshopt_optimizeVertexFetchRemap(order.data(), mesh.indices.data(),
+                                                                  mesh.indices.size(), vertexCount);
+        meshopt_remapIndexBuffer(mesh.indices.data(), mesh.indices.data(), mesh.indices.size(), order.data());
+        remap(mesh.vertices, order, usedCount);
+        remap(mesh.uvs, order, usedCount);
+        remap(mesh.colors, order, usedCount);
+        remap(mesh.normals, order, usedCount);
+
+        return {before, analyze(mesh)};
+    }
+
+    MeshOptimizer::Statistics MeshOptimizer::analyze(const MeshData &mesh) {
+        if (mesh.indices.empty() || mesh.vertices.empty())
+            return {0.0f, 0.0f};
+
+        const auto cache = meshopt_analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(),
+                                                      cacheSize, 0, 0);
+        const auto fetch = meshopt_analyzeVertexFetch(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(),
+                                                      mesh.layout.getStride());
+        return {cache.acmr, fetch.overfetch};
+    }
+}
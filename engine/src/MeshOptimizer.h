@@ -0,0 +1,41 @@
+#pragma once
+
+#include <utility>
+#include "MeshImporter.h"
+
+namespace Vixen {
+    /**
+     * Reorders imported meshes for the GPU, the result draws the same triangles. Runs on the thread that converted the
+     * mesh.
+     */
+    struct MeshOptimizer {
+        /**
+         * How far overdraw optimization may worsen the vertex cache efficiency, as a factor of the optimized ACMR
+         */
+        static constexpr float overdrawThreshold = 1.05f;
+
+        /**
+         * The post-transform cache modelled when reporting statistics, roughly what current GPUs reuse
+         */
+        static constexpr unsigned int cacheSize = 16;
+
+        struct Statistics {
+            /// The average amount of vertex shader invocations per triangle
+            float acmr;
+
+            /// The amount of vertex data fetched relative to the size of the vertex buffer
+            float overfetch;
+        };
+
+        /**
+         * Optimizes the index order for the post-transform vertex cache, then reorders clusters of triangles front to
+         * back where that does not cost much cache efficiency, and finally orders the vertices by first use so vertex
+         * fetch walks the buffer linearly
+         *
+         * @return The statistics before and after optimizing
+         */
+        static std::pair<Statistics, Statistics> optimize(MeshData &mesh);
+
+        static Statistics analyze(const MeshData &mesh);
+    };
+}
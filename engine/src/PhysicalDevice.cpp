@@ -33,6 +33,11 @@ namespace Vixen {
         vkGetPhysicalDeviceFeatures(device, &deviceFeatures);
         vkGetPhysicalDeviceProperties(device, &deviceProperties);
 
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        availableExtensions.resize(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
         driverProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DRIVER_PROPERTIES_KHR;
         driverProperties.pNext = nullptr;
 
@@ -67,10 +72,9 @@ namespace Vixen {
 
             score += physicalDeviceProperties.limits.maxImageDimension2D;
 
-            std::tuple<std::optional<uint32_t>, std::optional<uint32_t>, std::optional<uint32_t>> tuple =
-                    findQueueFamilies(physicalDevice);
+            const QueueFamilies families = findQueueFamilies(physicalDevice);
             /// If there are any queue families missing, this device is not suitable
-            if (!std::get<0>(tuple).has_value() || !std::get<1>(tuple).has_value() || !std::get<2>(tuple).has_value())
+            if (!families.isComplete())
                 continue;
 
             uint32_t extensionCount;
@@ -96,20 +100,20 @@ namespace Vixen {
             if (score > 0 && score > currentScore) {
                 currentScore = score;
                 currentDevice = physicalDevice;
-                graphicsFamilyIndex = std::get<0>(tuple).value();
-                presentFamilyIndex = std::get<1>(tuple).value();
-                transferFamilyIndex = std::get<2>(tuple).value();
+                graphicsFamilyIndex = families.graphics.value();
+                presentFamilyIndex = families.present.value();
+                transferFamilyIndex = families.transfer.value();
+                computeFamilyIndex = families.compute.value();
             }
         }
 
         return currentDevice;
     }
 
-    std::tuple<std::optional<uint32_t>, std::optional<uint32_t>, std::optional<uint32_t>>
-    PhysicalDevice::findQueueFamilies(const VkPhysicalDevice &physicalDevice) {
-        std::optional<uint32_t> graphicsIndex;
-        std::optional<uint32_t> presentIndex;
-        std::optional<uint32_t> transferIndex;
+    QueueFamilies PhysicalDevice::findQueueFamilies(const VkPhysicalDevice &physicalDevice) {
+        QueueFamilies families{};
+        std::optional<uint32_t> dedicatedComputeIndex;
+        std::optional<uint32_t> dedicatedTransferIndex;
 
         /// Get a list of all the queue families on this physical device
         uint32_t queueFamilyCount = 0;
@@ -122,20 +126,41 @@ namespace Vixen {
         uint32_t i = 0;
         for (const auto &properties : queueFamilyProperties) {
             if (properties.queueCount > 0 && properties.queueFlags & VK_QUEUE_GRAPHICS_BIT)
-                graphicsIndex = i;
+                families.graphics = i;
+
+            if (properties.queueCount > 0 && properties.queueFlags & VK_QUEUE_TRANSFER_BIT) {
+                if (!(properties.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) &&
+                    !dedicatedTransferIndex.has_value())
+                    dedicatedTransferIndex = i;
+                families.transfer = i;
+            }
 
-            if (properties.queueCount > 0 && properties.queueFlags & VK_QUEUE_TRANSFER_BIT)
-                transferIndex = i;
+            if (properties.queueCount > 0 && properties.queueFlags & VK_QUEUE_COMPUTE_BIT) {
+                if (!(properties.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !dedicatedComputeIndex.has_value())
+                    dedicatedComputeIndex = i;
+                if (!families.compute.has_value())
+                    families.compute = i;
+            }
 
             VkBool32 presentSupport = VK_FALSE;
             vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, instance->getSurface(), &presentSupport);
             if (presentSupport)
-                presentIndex = i;
+                families.present = i;
 
             i++;
         }
 
-        return std::tuple{graphicsIndex, presentIndex, transferIndex};
+        /// Prefer a compute family without graphics support, its queues run alongside the graphics queue
+        if (dedicatedComputeIndex.has_value())
+            families.compute = dedicatedComputeIndex;
+        /// Likewise a transfer only family is usually backed by the copy engines and does not compete with rendering
+        if (dedicatedTransferIndex.has_value())
+            families.transfer = dedicatedTransferIndex;
+        /// Graphics queues always support transfers even when the family does not report it
+        else if (!families.transfer.has_value())
+            families.transfer = families.graphics;
+
+        return families;
     }
 
     SwapChainSupportDetails PhysicalDevice::querySwapChainSupportDetails(VkPhysicalDevice physicalDevice) const {
@@ -163,6 +188,17 @@ namespace Vixen {
         return details;
     }
 
+    bool PhysicalDevice::hasAsyncCompute() const {
+        return computeFamilyIndex != graphicsFamilyIndex;
+    }
+
+    bool PhysicalDevice::supportsExtension(const std::string &name) const {
+        for (const auto &extension : availableExtensions)
+            if (name == extension.extensionName)
+                return true;
+        return false;
+    }
+
     SwapChainSupportDetails PhysicalDevice::querySwapChainSupportDetails() const {
         return querySwapChainSupportDetails(device);
     }
@@ -15,6 +15,17 @@ namespace Vixen {
         std::vector<VkPresentModeKHR> presentModes;
     };
 
+    struct QueueFamilies {
+        std::optional<uint32_t> graphics;
+        std::optional<uint32_t> present;
+        std::optional<uint32_t> transfer;
+        std::optional<uint32_t> compute;
+
+        [[nodiscard]] bool isComplete() const {
+            return graphics.has_value() && present.has_value() && transfer.has_value() && compute.has_value();
+        }
+    };
+
     class PhysicalDevice {
         Logger logger{"PhysicalDevice"};
 
@@ -30,12 +41,12 @@ namespace Vixen {
         pickDevice(const std::vector<VkPhysicalDevice> &devices, const std::vector<const char *> &extensions);
 
         /**
-         * Automatically find and set the required graphics queue families for a Vulkan physical device
+         * Automatically find and set the required queue families for a Vulkan physical device, a compute family
+         * without graphics support is preferred so compute work can run asynchronously
          *
          * @param[in] physicalDevice The physical device to find the queue families for
          */
-        std::tuple<std::optional<uint32_t>, std::optional<uint32_t>, std::optional<uint32_t>>
-        findQueueFamilies(const VkPhysicalDevice &physicalDevice);
+        QueueFamilies findQueueFamilies(const VkPhysicalDevice &physicalDevice);
 
         SwapChainSupportDetails querySwapChainSupportDetails(VkPhysicalDevice physicalDevice) const;
 
@@ -76,6 +87,18 @@ namespace Vixen {
 
         uint32_t transferFamilyIndex = 0;
 
+        uint32_t computeFamilyIndex = 0;
+
+        /**
+         * Whether compute work runs on a different queue family than graphics work and can overlap with it
+         */
+        [[nodiscard]] bool hasAsyncCompute() const;
+
+        /**
+         * Whether an optional device extension can be enabled on this device
+         */
+        [[nodiscard]] bool supportsExtension(const std::string &name) const;
+
         const std::shared_ptr<const Instance> instance;
 
         [[nodiscard]] VkFormat findSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
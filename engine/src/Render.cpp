@@ -1,11 +1,13 @@
+#include <chrono>
+#include <thread>
 #include "Render.h"
 
 namespace Vixen {
     Render::Render(std::shared_ptr<LogicalDevice> device, std::shared_ptr<PhysicalDevice> physicalDevice,
-                   const Scene &scene, std::shared_ptr<const Shader> shader, BufferType bufferType)
+                   const Camera &camera, std::shared_ptr<const Shader> shader, BufferType bufferType)
             : logicalDevice(std::move(device)), physicalDevice(std::move(physicalDevice)),
               framesInFlight(static_cast<const int>(bufferType)),
-              shader(std::move(shader)), scene(scene) {
+              shader(std::move(shader)), camera(camera) {
         create();
     }
 
@@ -13,8 +15,21 @@ namespace Vixen {
         destroy();
     }
 
-    void Render::render(const Camera &camera) {
+    void Render::render(const RenderSnapshot &snapshot) {
+        /// The resources only come with the first snapshot of a revision, so they are taken even if nothing is drawn
+        camera = snapshot.camera;
+        if (snapshot.revision != sceneRevision)
+            refreshScene(snapshot);
+
+        /// Nothing can be presented while minimized, waiting a little keeps the game thread from racing ahead
+        if (const auto size = logicalDevice->window->getFramebufferSize(); size.width == 0 || size.height == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            lastPresent = {};
+            return;
+        }
+
         commandBuffers[currentFrame]->wait();
+        vmaSetCurrentFrameIndex(logicalDevice->allocator, ++frameIndex);
         double currentTime = glfwGetTime();
         deltaTime = currentTime - lastTime;
         lastTime = currentTime;
@@ -29,11 +44,33 @@ namespace Vixen {
         } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
             logger.critical("Failed to acquire image {}", errorString(result));
         }
-        updateUniformBuffer(camera, scene.entities[0], imageIndex);
+        commandBuffers[imageIndex]->wait();
+        collectTiming(imageIndex);
+        const auto recordStart = std::chrono::steady_clock::now();
+        /// The frame uniforms and the model and normal matrix of every draw, reserved up front so recording never
+        /// runs out
+        const VkDeviceSize drawBytes = frameAllocator->getUniformFootprint(2 * sizeof(glm::mat4));
+        const VkDeviceSize uniformBytes = frameAllocator->getUniformFootprint(2 * sizeof(glm::mat4)) +
+                                          snapshot.draws.size() * drawBytes;
+        if (frameAllocator->reset(imageIndex, uniformBytes) && imageIndex < descriptorSet.size())
+            writeDescriptorSets(imageIndex, descriptorSet[imageIndex]);
+        lighting->update(imageIndex, camera, snapshot.lights);
+        const uint32_t shadowDraws = shadows->render(imageIndex, camera,
+                                                     static_cast<float>(logicalDevice->extent.width) /
+                                                     static_cast<float>(logicalDevice->extent.height), snapshot,
+                                                     timestampPool, 2 * imageIndex);
+        recordCommandBuffer(imageIndex, snapshot);
+        frameAllocator->flush();
+
+        std::vector<VkSemaphore> waitSemaphores{imageAvailableSemaphores[currentFrame]};
+        std::vector<VkPipelineStageFlags> waitStages{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        if (const VkSemaphore culling = lighting->submitCulling(imageIndex); culling != VK_NULL_HANDLE) {
+            waitSemaphores.push_back(culling);
+            waitStages.push_back(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        }
 
-        commandBuffers[imageIndex]->submit({imageAvailableSemaphores[currentFrame]},
-                                           {renderFinishedSemaphores[currentFrame]},
-                                           {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT});
+        commandBuffers[imageIndex]->submit(waitSemaphores, {renderFinishedSemaphores[currentFrame]}, waitStages);
+        const auto submitted = std::chrono::steady_clock::now();
 
         VkPresentInfoKHR presentInfo = {};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -44,24 +81,72 @@ namespace Vixen {
         presentInfo.pImageIndices = &imageIndex;
         presentInfo.pResults = nullptr;
 
-        vkQueuePresentKHR(logicalDevice->presentQueue, &presentInfo);
+        {
+            std::scoped_lock lock(logicalDevice->queueMutex);
+            vkQueuePresentKHR(logicalDevice->presentQueue, &presentInfo);
+        }
+        const auto presented = std::chrono::steady_clock::now();
+
+        /// The GPU time is only known once the image comes around again, until then the timing waits with the image
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+        pendingTimings[imageIndex] = FrameTiming{
+                Milliseconds(submitted - recordStart).count(),
+                std::numeric_limits<double>::quiet_NaN(),
+                lastPresent == std::chrono::steady_clock::time_point{} ? std::numeric_limits<double>::quiet_NaN()
+                                                                       : Milliseconds(presented - lastPresent).count(),
+                shadowDraws + static_cast<uint32_t>(snapshot.draws.size())
+        };
+        lastPresent = presented;
         currentFrame = (currentFrame + 1) % framesInFlight;
     }
 
-    void Render::updateUniformBuffer(const Camera &camera, const Entity &entity, uint32_t imageIndex) {
-        void *data = uniformBuffers[imageIndex].map();
+    void Render::collectTiming(uint32_t imageIndex) {
+        auto &pending = pendingTimings[imageIndex];
+        if (!pending.has_value())
+            return;
 
-        glm::mat4 model = entity.getModelMatrix();
-        glm::mat4 view = camera.getView();
-        glm::mat4 projection = camera.getProjection(static_cast<float>(logicalDevice->extent.width)
-                                                     / static_cast<float>(logicalDevice->extent.height));
-        projection[1][1] *= -1.0f;
+        FrameTiming timing = *pending;
+        pending.reset();
+        /// The fence of the image was waited on, so both timestamps are available
+        std::array<uint64_t, 2> ticks{};
+        if (timestampPool != VK_NULL_HANDLE &&
+            vkGetQueryPoolResults(logicalDevice->device, timestampPool, 2 * imageIndex, 2, sizeof(ticks),
+                                  ticks.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+            timing.gpu = static_cast<double>((ticks[1] - ticks[0]) & timestampMask) * timestampPeriod / 1e6;
+        statistics->record(timing);
+    }
+
+    void Render::createTimestamps() {
+        pendingTimings.assign(logicalDevice->imageViews.size(), std::nullopt);
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice->device, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice->device, &familyCount, families.data());
+
+        const uint32_t validBits = families[physicalDevice->graphicsFamilyIndex].timestampValidBits;
+        timestampPeriod = physicalDevice->deviceProperties.limits.timestampPeriod;
+        if (validBits == 0 || timestampPeriod <= 0.0) {
+            logger.warning("The graphics queue does not support timestamps, GPU frame times are not measured");
+            return;
+        }
+        timestampMask = validBits >= 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t{1} << validBits) - 1;
 
-        memcpy(data, &model, sizeof(glm::mat4));
-        memcpy((glm::mat4 *) data + 1, &view, sizeof(glm::mat4));
-        memcpy((glm::mat4 *) data + 2, &projection, sizeof(glm::mat4));
+        /// A query before the shadow pass and one after the scene pass of every swap chain image
+        VkQueryPoolCreateInfo queryPoolCreateInfo{};
+        queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolCreateInfo.queryCount = 2 * static_cast<uint32_t>(logicalDevice->imageViews.size());
+
+        VK_CHECK_RESULT(vkCreateQueryPool(logicalDevice->device, &queryPoolCreateInfo, nullptr, &timestampPool))
+        logger.trace("Successfully created timestamp queries");
+    }
 
-        uniformBuffers[imageIndex].unmap();
+    void Render::destroyTimestamps() {
+        vkDestroyQueryPool(logicalDevice->device, timestampPool, nullptr);
+        timestampPool = VK_NULL_HANDLE;
+        pendingTimings.clear();
+        logger.trace("Destroyed timestamp queries");
     }
 
     void Render::destroyFramebuffers() {
@@ -105,51 +190,89 @@ namespace Vixen {
                                                                  logicalDevice->extent.width,
                                                                  logicalDevice->extent.height));
             commandBuffers.push_back(std::make_shared<CommandBuffer>(logicalDevice));
-            auto &commandBuffer = commandBuffers[i];
-            commandBuffer->recordSimultaneous();
-
-            VkRenderPassBeginInfo renderPassBeginInfo = {};
-            renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderPassBeginInfo.renderPass = renderPass;
-            renderPassBeginInfo.framebuffer = framebuffers[i]->getFramebuffer();
-            renderPassBeginInfo.renderArea.offset = {0, 0};
-            renderPassBeginInfo.renderArea.extent = logicalDevice->extent;
-
-            std::array<VkClearValue, 2> clearColors{};
-            //clearColors[0].color = {{34.0f, 59.0f, 84.0f, 1.0f}};
-            clearColors[0].color = {{0.13f, 0.23f, 0.33f, 1.0f}};
-            clearColors[1].depthStencil = {1.0f, 0};
-
-            renderPassBeginInfo.clearValueCount = clearColors.size();
-            renderPassBeginInfo.pClearValues = clearColors.data();
-
-            commandBuffer->cmdBeginRenderPass(renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-            commandBuffer->cmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-
-            for (size_t j = 0; j < scene.entities.size(); j++) {
-                const auto &entity = scene.entities[j];
-                const auto &mesh = entity.mesh;
-
-                commandBuffer->cmdBindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0,
-                                                     {descriptorSet[i][j]}, {});
-
-                const std::vector<VkBuffer> buffers(3, mesh->getBuffer()->getBuffer());
-                std::vector<VkDeviceSize> offsets{0, mesh->getVertexCount() * sizeof(glm::vec3),
-                                                  mesh->getVertexCount() * sizeof(glm::vec3) +
-                                                  mesh->getVertexCount() * sizeof(glm::vec2)};
-                commandBuffer->cmdBindVertexBuffers(0, buffers, offsets);
-                commandBuffer->cmdBindIndexBuffer(mesh->getBuffer()->getBuffer(),
-                                                  mesh->getVertexCount() * sizeof(glm::vec3) +
-                                                  mesh->getVertexCount() * sizeof(glm::vec2) +
-                                                  mesh->getVertexCount() * sizeof(glm::vec4), VK_INDEX_TYPE_UINT32);
-
-                commandBuffer->cmdDrawIndexed(mesh->getIndexCount(), 1, 0, 0, 0);
+        }
+        logger.trace("Successfully created command buffers");
+    }
+
+    void Render::recordCommandBuffer(uint32_t imageIndex, const RenderSnapshot &snapshot) {
+        const Camera &camera = snapshot.camera;
+        glm::mat4 view = camera.getView();
+        glm::mat4 projection = camera.getProjection(static_cast<float>(logicalDevice->extent.width)
+                                                     / static_cast<float>(logicalDevice->extent.height));
+        projection[1][1] *= -1.0f;
+
+        auto &commandBuffer = commandBuffers[imageIndex];
+        commandBuffer->recordSingleUsage();
+        if (timestampPool != VK_NULL_HANDLE)
+            commandBuffer->cmdResetQueryPool(timestampPool, 2 * imageIndex + 1, 1);
+        lighting->recordCulling(*commandBuffer, imageIndex);
+
+        VkRenderPassBeginInfo renderPassBeginInfo = {};
+        renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassBeginInfo.renderPass = renderPass;
+        renderPassBeginInfo.framebuffer = framebuffers[imageIndex]->getFramebuffer();
+        renderPassBeginInfo.renderArea.offset = {0, 0};
+        renderPassBeginInfo.renderArea.extent = logicalDevice->extent;
+
+        std::array<VkClearValue, 2> clearColors{};
+        //clearColors[0].color = {{34.0f, 59.0f, 84.0f, 1.0f}};
+        clearColors[0].color = {{0.13f, 0.23f, 0.33f, 1.0f}};
+        clearColors[1].depthStencil = {1.0f, 0};
+
+        renderPassBeginInfo.clearValueCount = clearColors.size();
+        renderPassBeginInfo.pClearValues = clearColors.data();
+
+        commandBuffer->cmdBeginRenderPass(renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        /// Every pipeline shares the layout, so the descriptor sets stay bound when switching between them
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        /// Meshes share the arena buffers, so the bindings only change when crossing into another block
+        VkBuffer boundVertices = VK_NULL_HANDLE;
+        VkBuffer boundIndices = VK_NULL_HANDLE;
+        VkIndexType boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
+        /// View and projection are shared by every draw, only the model and normal matrix are allocated per draw
+        const auto frameUniforms = frameAllocator->allocateUniform(2 * sizeof(glm::mat4));
+        memcpy(frameUniforms.data, &view, sizeof(glm::mat4));
+        memcpy(static_cast<glm::mat4 *>(frameUniforms.data) + 1, &projection, sizeof(glm::mat4));
+        commandBuffer->cmdBindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1,
+                                             {lighting->getDescriptorSet(imageIndex),
+                                              shadows->getDescriptorSet(imageIndex)}, {});
+
+        for (const auto &draw : snapshot.draws) {
+            if (const VkPipeline pipeline = getPipeline(draw.layout); pipeline != boundPipeline) {
+                commandBuffer->cmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                boundPipeline = pipeline;
+            }
+
+            /// Dynamic offsets follow the binding order, the draw uniforms at binding 0 come before the frame's
+            /// The inverse transpose keeps normals perpendicular to the surface under non-uniform scale
+            const glm::mat4 normal = glm::transpose(glm::inverse(glm::mat3(draw.model)));
+            const auto uniforms = frameAllocator->allocateUniform(2 * sizeof(glm::mat4));
+            memcpy(uniforms.data, &draw.model, sizeof(glm::mat4));
+            memcpy(static_cast<glm::mat4 *>(uniforms.data) + 1, &normal, sizeof(glm::mat4));
+            commandBuffer->cmdBindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0,
+                                                 {descriptorSet[imageIndex][draw.resource]},
+                                                 {static_cast<uint32_t>(uniforms.offset),
+                                                  static_cast<uint32_t>(frameUniforms.offset)});
+
+            commandBuffer->cmdPushConstants(pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4),
+                                            &draw.dequantization);
+            if (draw.vertexBuffer != boundVertices) {
+                boundVertices = draw.vertexBuffer;
+                commandBuffer->cmdBindVertexBuffers(0, {boundVertices}, {0});
+            }
+            if (draw.indexBuffer != boundIndices || draw.indexType != boundIndexType) {
+                boundIndices = draw.indexBuffer;
+                boundIndexType = draw.indexType;
+                commandBuffer->cmdBindIndexBuffer(boundIndices, 0, boundIndexType);
             }
 
-            commandBuffer->cmdEndRenderPass();
-            commandBuffer->stop();
+            commandBuffer->cmdDrawIndexed(draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
         }
-        logger.trace("Successfully created command buffers");
+
+        commandBuffer->cmdEndRenderPass();
+        if (timestampPool != VK_NULL_HANDLE)
+            commandBuffer->cmdWriteTimestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool, 2 * imageIndex + 1);
+        commandBuffer->stop();
     }
 
     void Render::createRenderPass() {
@@ -216,7 +339,14 @@ namespace Vixen {
         logger.trace("Destroyed render pass");
     }
 
-    void Render::createPipeline() {
+    VkPipeline Render::getPipeline(const VertexLayout &layout) {
+        auto &pipeline = pipelines[layout.encode()];
+        if (pipeline == VK_NULL_HANDLE)
+            pipeline = createPipeline(layout);
+        return pipeline;
+    }
+
+    VkPipeline Render::createPipeline(const VertexLayout &layout) {
         /// Create graphics pipeline
         std::vector<VkPipelineShaderStageCreateInfo> s{};
 
@@ -231,12 +361,14 @@ namespace Vixen {
             s.push_back(createInfo);
         }
 
+        const auto binding = layout.getBinding();
+        const auto attributes = layout.getAttributes();
         VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo = {};
         vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputCreateInfo.vertexBindingDescriptionCount = shader->getBindings().size();
-        vertexInputCreateInfo.pVertexBindingDescriptions = shader->getBindings().data();
-        vertexInputCreateInfo.vertexAttributeDescriptionCount = shader->getAttributes().size();
-        vertexInputCreateInfo.pVertexAttributeDescriptions = shader->getAttributes().data();
+        vertexInputCreateInfo.vertexBindingDescriptionCount = 1;
+        vertexInputCreateInfo.pVertexBindingDescriptions = &binding;
+        vertexInputCreateInfo.vertexAttributeDescriptionCount = attributes.size();
+        vertexInputCreateInfo.pVertexAttributeDescriptions = attributes.data();
 
         VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo = {};
         inputAssemblyCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -335,27 +467,39 @@ namespace Vixen {
         pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
         pipelineCreateInfo.basePipelineIndex = -1;
 
+        VkPipeline pipeline;
         VK_CHECK_RESULT(
                 vkCreateGraphicsPipelines(logicalDevice->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr,
                                           &pipeline))
-        logger.trace("Successfully created a graphics pipeline");
+        logger.trace("Successfully created a graphics pipeline for vertex layout {:06x}", layout.encode());
+        return pipeline;
     }
 
-    void Render::destroyPipeline() {
-        vkDestroyPipeline(logicalDevice->device, pipeline, nullptr);
-        logger.trace("Destroyed pipeline");
+    void Render::destroyPipelines() {
+        for (const auto &[layout, pipeline] : pipelines)
+            vkDestroyPipeline(logicalDevice->device, pipeline, nullptr);
+        pipelines.clear();
+        logger.trace("Destroyed pipelines");
     }
 
     void Render::createPipelineLayout() {
-        auto layout = descriptorSetLayout->getDescriptorSetLayout();
+        std::array<VkDescriptorSetLayout, 3> layouts = {descriptorSetLayout->getDescriptorSetLayout(),
+                                                        lighting->getDescriptorSetLayout(),
+                                                        shadows->getDescriptorSetLayout()};
+
+        /// The dequantization of the mesh being drawn
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(glm::mat4);
 
         /// Create graphics pipeline layout
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {};
         pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutCreateInfo.setLayoutCount = 1;
-        pipelineLayoutCreateInfo.pSetLayouts = &layout;
-        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+        pipelineLayoutCreateInfo.setLayoutCount = layouts.size();
+        pipelineLayoutCreateInfo.pSetLayouts = layouts.data();
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
 
         VK_CHECK_RESULT(
                 vkCreatePipelineLayout(logicalDevice->device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout))
@@ -368,83 +512,122 @@ namespace Vixen {
     }
 
     std::vector<std::vector<VkDescriptorSet>> Render::createDescriptorSets() {
-        std::vector<VkDescriptorSetLayout> layouts(scene.entities.size(),
+        std::vector<VkDescriptorSetLayout> layouts(sceneResources.size(),
                                                    descriptorSetLayout->getDescriptorSetLayout());
 
         auto sets = std::vector<std::vector<VkDescriptorSet>>(logicalDevice->imageViews.size());
-        for (size_t i = 0; i < sets.size(); i++) {
-            sets[i] = descriptorPool->createSets(layouts);
-            for (size_t j = 0; j < sets[i].size(); j++) {
-                std::vector<VkWriteDescriptorSet> writes{};
-                for (const auto &descriptor : shader->getDescriptors()) {
-                    VkWriteDescriptorSet write{};
-                    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    write.dstSet = sets[i][j];
-                    write.dstBinding = descriptor.getBinding();
-                    write.dstArrayElement = 0;
-                    write.descriptorType = descriptor.getType();
-                    write.descriptorCount = 1;
-
-                    switch (descriptor.getType()) {
-                        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: {
-                            VkDescriptorBufferInfo buffer{};
-                            buffer.buffer = uniformBuffers[i].getBuffer();
-                            buffer.offset = 0;
-                            buffer.range = descriptor.getSize();
-
-                            write.pBufferInfo = &buffer;
-                        }
-                        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
-                            const auto &texture = scene.entities[j].mesh->getTexture();
-                            VkDescriptorImageInfo image{};
-                            image.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                            image.imageView = texture != nullptr ? texture->getView() : nullptr;
-                            image.sampler = textureSampler->getSampler();
-
-                            write.pImageInfo = &image;
-                        }
-                        default:
-                            break;
-                    }
+        for (uint32_t i = 0; i < sets.size(); i++) {
+            if (layouts.empty())
+                continue;
 
-                    writes.insert(writes.begin(), write);
-                }
-                vkUpdateDescriptorSets(logicalDevice->device, writes.size(), writes.data(), 0, nullptr);
-            }
+            sets[i] = descriptorPool->createSets(layouts);
+            writeDescriptorSets(i, sets[i]);
         }
         logger.trace("Successfully updated descriptor sets");
 
         return sets;
     }
 
+    void Render::writeDescriptorSets(uint32_t imageIndex, const std::vector<VkDescriptorSet> &sets) {
+        const auto &descriptors = shader->getDescriptors();
+        for (size_t j = 0; j < sets.size(); j++) {
+            std::vector<VkWriteDescriptorSet> writes{};
+            /// The writes point into these until the update, reserving keeps them from moving
+            std::vector<VkDescriptorBufferInfo> buffers{};
+            std::vector<VkDescriptorImageInfo> images{};
+            writes.reserve(descriptors.size());
+            buffers.reserve(descriptors.size());
+            images.reserve(descriptors.size());
+            for (const auto &descriptor : descriptors) {
+                VkWriteDescriptorSet write{};
+                write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                write.dstSet = sets[j];
+                write.dstBinding = descriptor.getBinding();
+                write.dstArrayElement = 0;
+                write.descriptorType = descriptor.getType();
+                write.descriptorCount = 1;
+
+                switch (descriptor.getType()) {
+                    case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC: {
+                        /// The offset into the frame allocator is supplied when binding the set
+                        VkDescriptorBufferInfo &buffer = buffers.emplace_back();
+                        buffer.buffer = frameAllocator->getBuffer(imageIndex);
+                        buffer.offset = 0;
+                        buffer.range = descriptor.getSize();
+
+                        write.pBufferInfo = &buffer;
+                        break;
+                    }
+                    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
+                        const auto &texture = sceneResources[j].texture;
+                        VkDescriptorImageInfo &image = images.emplace_back();
+                        image.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                        image.imageView = texture != nullptr ? texture->getView() : nullptr;
+                        image.sampler = textureSampler->getSampler();
+
+                        write.pImageInfo = &image;
+                        break;
+                    }
+                    default:
+                        break;
+                }
+
+                writes.push_back(write);
+            }
+            vkUpdateDescriptorSets(logicalDevice->device, writes.size(), writes.data(), 0, nullptr);
+        }
+    }
+
     void Render::create() {
         createDepthImage();
         createSyncObjects();
         descriptorSetLayout = std::make_unique<DescriptorSetLayout>(logicalDevice, *shader);
-        for (uint32_t i = 0; i < logicalDevice->imageCount; i++)
-            for (const auto &descriptor : shader->getDescriptors())
-                if (descriptor.getType() == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)
-                    uniformBuffers.emplace_back(logicalDevice, descriptor.getSize(), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                                VMA_MEMORY_USAGE_CPU_ONLY);
-        textureSampler = std::make_unique<ImageSampler>(logicalDevice);
-        descriptorPool = std::make_unique<DescriptorPool>(logicalDevice, shader.get(),
-                                                          logicalDevice->imageViews.size() * scene.entities.size());
-        descriptorSet = createDescriptorSets();
+        frameAllocator = std::make_unique<FrameAllocator>(logicalDevice, logicalDevice->imageViews.size());
+        createSceneResources();
+        lighting = std::make_unique<ClusteredLighting>(logicalDevice, camera, logicalDevice->imageViews.size());
+        shadows = std::make_unique<ShadowCascades>(logicalDevice, logicalDevice->imageViews.size());
         createRenderPass();
         createPipelineLayout();
-        createPipeline();
         createCommandBuffers();
+        createTimestamps();
+    }
+
+    void Render::createSceneResources() {
+        uint32_t mipLevels = 1;
+        for (const auto &resource : sceneResources)
+            if (resource.texture)
+                mipLevels = std::max(mipLevels, resource.texture->getMipLevels());
+        textureSampler = std::make_unique<ImageSampler>(logicalDevice, mipLevels);
+        /// A pool must allow at least one set, even while the scene is still empty
+        descriptorPool = std::make_unique<DescriptorPool>(logicalDevice, shader.get(),
+                                                          logicalDevice->imageViews.size() *
+                                                          std::max<size_t>(sceneResources.size(), 1));
+        descriptorSet = createDescriptorSets();
+    }
+
+    void Render::refreshScene(const RenderSnapshot &snapshot) {
+        logicalDevice->waitIdle();
+
+        descriptorSet.clear();
+        descriptorPool = nullptr;
+        sceneResources = snapshot.resources;
+        sceneRevision = snapshot.revision;
+        createSceneResources();
+        logger.trace("Refreshed scene revision {}", sceneRevision);
     }
 
     void Render::destroy() {
-        vkDeviceWaitIdle(logicalDevice->device);
+        logicalDevice->waitIdle();
 
         destroyDepthImage();
         destroyFramebuffers();
         destroyRenderPass();
         destroyPipelineLayout();
-        destroyPipeline();
+        destroyPipelines();
         destroySyncObjects();
+        destroyTimestamps();
+        lighting = nullptr;
+        shadows = nullptr;
     }
 
     /// TODO: Redo this shit, it sucks
@@ -456,6 +639,8 @@ namespace Vixen {
         logicalDevice->createSwapchain();
         logicalDevice->createImageViews();
         create();
+        /// Recreating the swap chain is a stall of its own, it is not counted as the interval to the next present
+        lastPresent = {};
         logger.trace("Invalidation took {}ms", glfwGetTime() - oldTime);
     }
 
@@ -478,4 +663,8 @@ namespace Vixen {
     double Render::getDeltaTime() const {
         return deltaTime;
     }
+
+    std::shared_ptr<FrameStatistics> Render::getStatistics() const {
+        return statistics;
+    }
 }
\ No newline at end of file
@@ -1,15 +1,23 @@
 #pragma once
 
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include "Vulkan.h"
 #include "Shader.h"
 #include "Mesh.h"
-#include "Scene.h"
+#include "RenderSnapshot.h"
 #include "Camera.h"
 #include "Framebuffer.h"
 #include "DescriptorSetLayout.h"
 #include "DescriptorPool.h"
 #include "ImageSampler.h"
+#include "ClusteredLighting.h"
+#include "ShadowCascades.h"
+#include "FrameAllocator.h"
+#include "FrameStatistics.h"
 
 namespace Vixen {
     enum class BufferType {
@@ -49,9 +57,9 @@ namespace Vixen {
         VkRenderPass renderPass = VK_NULL_HANDLE;
 
         /**
-         * The graphics pipeline
+         * A graphics pipeline for every vertex layout drawn so far, keyed by the encoded layout
          */
-        VkPipeline pipeline = VK_NULL_HANDLE;
+        std::unordered_map<uint32_t, VkPipeline> pipelines;
 
         /**
          * A list of frame buffers used by this graphics pipeline
@@ -59,7 +67,7 @@ namespace Vixen {
         std::vector<std::shared_ptr<Framebuffer>> framebuffers = {};
 
         /**
-         * A list of command buffers associated with the corresponding framebuffer
+         * A list of command buffers associated with the corresponding framebuffer, recorded again every frame
          */
         std::vector<std::shared_ptr<CommandBuffer>> commandBuffers = {};
 
@@ -77,14 +85,30 @@ namespace Vixen {
 
         std::unique_ptr<DescriptorSetLayout> descriptorSetLayout = nullptr;
 
-        std::vector<Buffer> uniformBuffers;
+        /**
+         * The per draw uniforms of every frame, with a region for each swap chain image
+         */
+        std::unique_ptr<FrameAllocator> frameAllocator;
 
+        /**
+         * A descriptor set for every scene resource and swap chain image, entities drawing the same mesh share its set
+         */
         std::vector<std::vector<VkDescriptorSet>> descriptorSet;
 
+        /**
+         * Every mesh drawn by the scene and its texture, kept alive until the scene changes and the GPU is done with
+         * them
+         */
+        std::vector<RenderSnapshot::Resource> sceneResources;
+
         std::unique_ptr<ImageSampler> textureSampler;
 
         std::unique_ptr<ImageView> depthImage{};
 
+        std::unique_ptr<ClusteredLighting> lighting{};
+
+        std::unique_ptr<ShadowCascades> shadows{};
+
         /**
          * The maximum number of frames in flight, also known as concurrently rendered frames
          * ensuring that the GPU is always being utilized
@@ -93,7 +117,15 @@ namespace Vixen {
 
         const std::shared_ptr<const Shader> shader;
 
-        const Scene &scene;
+        /**
+         * The camera of the latest snapshot, the light clusters are built for its projection
+         */
+        Camera camera;
+
+        /**
+         * The scene revision the descriptor sets were created for, none until the first snapshot is rendered
+         */
+        uint64_t sceneRevision = std::numeric_limits<uint64_t>::max();
 
         double lastTime = glfwGetTime();
 
@@ -104,6 +136,33 @@ namespace Vixen {
          */
         uint32_t currentFrame = 0;
 
+        /**
+         * The amount of frames rendered so far, the allocator refreshes its heap budgets when it changes
+         */
+        uint32_t frameIndex = 0;
+
+        /**
+         * Two timestamp queries for every swap chain image, written before its shadow pass and after its scene pass.
+         * None if the graphics queue does not support timestamps.
+         */
+        VkQueryPool timestampPool = VK_NULL_HANDLE;
+
+        /// The nanoseconds a timestamp tick takes
+        double timestampPeriod = 0.0;
+
+        /// The bits of a timestamp that are valid, the difference of two timestamps wraps around within them
+        uint64_t timestampMask = 0;
+
+        /**
+         * The timing of the last frame rendered to every swap chain image, recorded once its GPU time can be read
+         */
+        std::vector<std::optional<FrameTiming>> pendingTimings;
+
+        /// The time of the last present, none after a frame was skipped or the swap chain was recreated
+        std::chrono::steady_clock::time_point lastPresent{};
+
+        const std::shared_ptr<FrameStatistics> statistics = std::make_shared<FrameStatistics>();
+
         void createDepthImage();
 
         void destroyDepthImage();
@@ -120,44 +179,82 @@ namespace Vixen {
 
         void destroyRenderPass();
 
-        void createPipeline();
+        /**
+         * Returns the pipeline for meshes of a vertex layout, creating it the first time the layout is drawn
+         */
+        VkPipeline getPipeline(const VertexLayout &layout);
+
+        VkPipeline createPipeline(const VertexLayout &layout);
 
-        void destroyPipeline();
+        void destroyPipelines();
 
         void createPipelineLayout();
 
         void destroyPipelineLayout();
 
+        void createTimestamps();
+
+        void destroyTimestamps();
+
+        /**
+         * Records the timing of the frame last rendered to a swap chain image, its command buffer must have finished
+         */
+        void collectTiming(uint32_t imageIndex);
+
         std::vector<std::vector<VkDescriptorSet>> createDescriptorSets();
 
+        /**
+         * Writes the descriptors of the sets of a swap chain image, again whenever its frame allocator region is
+         * replaced
+         */
+        void writeDescriptorSets(uint32_t imageIndex, const std::vector<VkDescriptorSet> &sets);
+
+        void createSceneResources();
+
+        /**
+         * Takes the resources of a snapshot of a changed scene and creates the descriptor sets again, the swap chain is
+         * kept
+         */
+        void refreshScene(const RenderSnapshot &snapshot);
+
         void invalidate();
 
         void create();
 
         void destroy();
 
-        void updateUniformBuffer(const Camera &camera, const Entity &entity, uint32_t imageIndex);
+        /**
+         * Records the draws of the scene, the uniforms of every entity are allocated from the frame allocator and bound
+         * through a dynamic offset
+         */
+        void recordCommandBuffer(uint32_t imageIndex, const RenderSnapshot &snapshot);
 
     public:
         /**
          * Construct a new render pipeline
          *
          * @param[in] device The device to create the pipeline for
+         * @param[in] camera The camera the light clusters are built for until the first snapshot is rendered
          * @param[in] vertex The vertex shader this pipeline will use
          * @param[in] fragment The fragment shader this pipeline will use
          * @param[in] framesInFlight The maximum frames in flight to be used by this renderer
          */
         Render(std::shared_ptr<LogicalDevice> device, std::shared_ptr<PhysicalDevice> physicalDevice,
-               const Scene &scene, std::shared_ptr<const Shader> shader,
+               const Camera &camera, std::shared_ptr<const Shader> shader,
                BufferType bufferType = BufferType::DOUBLE_BUFFER);
 
         ~Render();
 
         /**
-         * Renders the current scene
+         * Renders a snapshot of the scene, the frame is skipped while the window is minimized
          */
-        void render(const Camera &camera);
+        void render(const RenderSnapshot &snapshot);
 
         [[nodiscard]] double getDeltaTime() const;
+
+        /**
+         * The timings of the rendered frames, a frame is recorded once the GPU finished it
+         */
+        [[nodiscard]] std::shared_ptr<FrameStatistics> getStatistics() const;
     };
 }
\ No newline at end of file
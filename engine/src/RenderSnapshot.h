@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Camera.h"
+#include "ImageView.h"
+#include "Light.h"
+#include "Mesh.h"
+#include "VertexLayout.h"
+
+namespace Vixen {
+    /**
+     * Everything the renderer reads of a scene for one frame. The game thread captures it from the scene and the render
+     * thread draws from it, so the scene can change while an earlier frame is still being recorded.
+     */
+    struct RenderSnapshot {
+        /**
+         * A mesh drawn by the scene and the texture it samples, the renderer keeps both alive until the scene changes
+         */
+        struct Resource {
+            std::shared_ptr<Mesh> mesh;
+
+            std::shared_ptr<const ImageView> texture;
+        };
+
+        /**
+         * An entity drawing a mesh. The draw parameters of the mesh are copied, relocating the mesh on the game thread
+         * would race the render thread otherwise.
+         */
+        struct Draw {
+            glm::mat4 model;
+
+            glm::mat4 dequantization;
+
+            glm::vec3 minimum;
+
+            glm::vec3 maximum;
+
+            VertexLayout layout;
+
+            VkBuffer vertexBuffer;
+
+            VkBuffer indexBuffer;
+
+            VkIndexType indexType;
+
+            uint32_t indexCount;
+
+            uint32_t firstIndex;
+
+            int32_t vertexOffset;
+
+            /// The index of the mesh in the resources of the scene revision
+            uint32_t resource;
+
+            /// Whether the entity is static and drawn into the cached shadow cascades
+            bool isStatic;
+        };
+
+        Camera camera{};
+
+        std::vector<PointLight> lights;
+
+        DirectionalLight sun{};
+
+        std::vector<Draw> draws;
+
+        /**
+         * Every mesh drawn by the scene, only filled in when the revision differs from the one of the previous snapshot
+         */
+        std::vector<Resource> resources;
+
+        uint64_t revision = 0;
+
+        uint64_t staticRevision = 0;
+    };
+}
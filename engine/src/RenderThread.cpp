@@ -0,0 +1,129 @@
+#include "RenderThread.h"
+#include <future>
+
+namespace Vixen {
+    RenderThread::RenderThread(const std::shared_ptr<LogicalDevice> &device,
+                               const std::shared_ptr<PhysicalDevice> &physicalDevice, const Camera &camera,
+                               const std::shared_ptr<const Shader> &shader, BufferType bufferType) {
+        std::promise<void> ready;
+        auto created = ready.get_future();
+        thread = std::thread([this, device, physicalDevice, camera, shader, bufferType,
+                                     ready = std::move(ready)]() mutable {
+            std::unique_ptr<Render> render;
+            try {
+                render = std::make_unique<Render>(device, physicalDevice, camera, shader, bufferType);
+            } catch (...) {
+                ready.set_exception(std::current_exception());
+                return;
+            }
+            statistics = render->getStatistics();
+            ready.set_value();
+            run(*render);
+        });
+
+        try {
+            created.get();
+        } catch (...) {
+            thread.join();
+            throw;
+        }
+        logger.trace("Started the render thread");
+    }
+
+    RenderThread::~RenderThread() {
+        stopping = true;
+        /// Changing the count wakes the render thread if it waits for a snapshot
+        published++;
+        published.notify_one();
+        thread.join();
+        logger.trace("Stopped the render thread");
+    }
+
+    void RenderThread::run(Render &render) {
+        try {
+            uint64_t frame = 0;
+            while (true) {
+                while (published.load(std::memory_order_acquire) == frame)
+                    published.wait(frame, std::memory_order_acquire);
+                if (stopping)
+                    return;
+
+                render.render(snapshots[frame % snapshots.size()]);
+                consumed.store(++frame, std::memory_order_release);
+                consumed.notify_one();
+            }
+        } catch (...) {
+            exception = std::current_exception();
+            logger.error("The renderer threw, the render thread stopped");
+            failed = true;
+            /// Changing the count wakes the game thread if it waits for a snapshot to be drawn
+            consumed++;
+            consumed.notify_all();
+        }
+    }
+
+    void RenderThread::waitForConsumed(uint64_t count) {
+        uint64_t done = consumed.load(std::memory_order_acquire);
+        while (done < count && !failed) {
+            consumed.wait(done, std::memory_order_acquire);
+            done = consumed.load(std::memory_order_acquire);
+        }
+        if (failed)
+            std::rethrow_exception(exception);
+    }
+
+    void RenderThread::submit(const Scene &scene, float alpha) {
+        const uint64_t frame = published.load(std::memory_order_relaxed);
+        /// The slot was last captured into by the snapshot before the previous one
+        waitForConsumed(frame >= snapshots.size() ? frame - snapshots.size() + 1 : 0);
+
+        capture(scene, alpha, snapshots[frame % snapshots.size()]);
+        published.store(frame + 1, std::memory_order_release);
+        published.notify_one();
+    }
+
+    void RenderThread::synchronize() {
+        waitForConsumed(published.load(std::memory_order_relaxed));
+    }
+
+    std::shared_ptr<FrameStatistics> RenderThread::getStatistics() const {
+        return statistics;
+    }
+
+    void RenderThread::capture(const Scene &scene, float alpha, RenderSnapshot &snapshot) {
+        snapshot.camera = scene.camera;
+        snapshot.lights = scene.lights;
+        snapshot.sun = scene.sun;
+        snapshot.revision = scene.revision;
+        snapshot.staticRevision = scene.staticRevision;
+
+        /// The render thread sees every snapshot, so the resources only need to come with the first of a revision
+        snapshot.resources.clear();
+        if (scene.revision != capturedRevision) {
+            resourceIndices.clear();
+            scene.world.query<const MeshRenderer>().each([&](const MeshRenderer &renderer) {
+                const auto index = static_cast<uint32_t>(snapshot.resources.size());
+                if (resourceIndices.emplace(renderer.mesh.get(), index).second)
+                    snapshot.resources.push_back({renderer.mesh, renderer.mesh->getTexture()});
+            });
+            capturedRevision = scene.revision;
+        }
+
+        snapshot.draws.clear();
+        const auto draw = [&](bool isStatic) {
+            return [&, isStatic](const Transform &transform, const MeshRenderer &renderer) {
+                if (!scene.transforms.isComposed(transform.node))
+                    return;
+
+                const auto &mesh = *renderer.mesh;
+                snapshot.draws.push_back({scene.transforms.getInterpolatedMatrix(transform.node, alpha),
+                                          mesh.getDequantization(), mesh.getMinimum(), mesh.getMaximum(),
+                                          mesh.getLayout(), mesh.getVertexBuffer(), mesh.getIndexBuffer(),
+                                          mesh.getIndexType(), mesh.getIndexCount(), mesh.getFirstIndex(),
+                                          mesh.getVertexOffset(), resourceIndices.at(&mesh), isStatic});
+            };
+        };
+        scene.world.query<const Transform, const MeshRenderer>().without<Static>().each(draw(false));
+        scene.world.query<const Transform, const MeshRenderer>().with<Static>().each(draw(true));
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include "Render.h"
+#include "RenderSnapshot.h"
+#include "Scene.h"
+
+namespace Vixen {
+    /**
+     * Renders on a thread of its own. The game thread captures a snapshot of the scene every frame and hands it over,
+     * then simulates the next frame while the render thread records and submits the previous one.
+     *
+     * There are two snapshots the threads take turns on. Handing one over only publishes a counter, and capturing
+     * reuses the memory of the snapshot from two frames ago, so neither side locks or allocates once the scene stopped
+     * growing. The game thread only waits when the render thread is still drawing that older snapshot.
+     */
+    class RenderThread {
+        const Logger logger{"RenderThread"};
+
+        std::array<RenderSnapshot, 2> snapshots;
+
+        /// The amount of snapshots handed to the render thread
+        std::atomic<uint64_t> published = 0;
+
+        /// The amount of snapshots the render thread is done with, their slots may be captured into again
+        std::atomic<uint64_t> consumed = 0;
+
+        std::atomic<bool> stopping = false;
+
+        /// Set once the renderer threw, the exception is rethrown on the game thread
+        std::atomic<bool> failed = false;
+
+        std::exception_ptr exception;
+
+        /// The statistics of the renderer, they outlive it when the render thread stops
+        std::shared_ptr<FrameStatistics> statistics;
+
+        /// The scene revision of the last captured snapshot, the resources are captured again when it changes
+        uint64_t capturedRevision = std::numeric_limits<uint64_t>::max();
+
+        /// The resource index of every mesh of the captured revision
+        std::unordered_map<const Mesh *, uint32_t> resourceIndices;
+
+        std::thread thread;
+
+        void run(Render &render);
+
+        void capture(const Scene &scene, float alpha, RenderSnapshot &snapshot);
+
+        /**
+         * Waits until the render thread is done with a number of snapshots, rethrows if the renderer threw
+         */
+        void waitForConsumed(uint64_t count);
+
+    public:
+        /**
+         * Starts the render thread and creates the renderer on it, its command buffers belong to that thread
+         *
+         * @param[in] camera The camera the light clusters are built for until the first snapshot is rendered
+         */
+        RenderThread(const std::shared_ptr<LogicalDevice> &device,
+                     const std::shared_ptr<PhysicalDevice> &physicalDevice, const Camera &camera,
+                     const std::shared_ptr<const Shader> &shader, BufferType bufferType = BufferType::DOUBLE_BUFFER);
+
+        RenderThread(const RenderThread &) = delete;
+
+        RenderThread &operator=(const RenderThread &) = delete;
+
+        /**
+         * Stops the render thread after the snapshot it is drawing and destroys the renderer on it
+         */
+        ~RenderThread();
+
+        /**
+         * Captures a snapshot of the scene and hands it to the render thread, the scene is free to change once this
+         * returns. Rethrows the exception the renderer threw, if any.
+         *
+         * @param[in] alpha How far to blend the transforms from the update before the last towards the last update,
+         * nodes that were never updated are left out
+         */
+        void submit(const Scene &scene, float alpha = 1.0f);
+
+        /**
+         * Waits until every submitted snapshot was recorded and submitted to the GPU. Resources that earlier snapshots
+         * reference, such as geometry that is about to be relocated, are only used by GPU work from then on.
+         */
+        void synchronize();
+
+        /**
+         * The timings of the frames drawn by the render thread, safe to read from any thread
+         */
+        [[nodiscard]] std::shared_ptr<FrameStatistics> getStatistics() const;
+    };
+}
@@ -3,12 +3,35 @@
 #include <memory>
 #include <vector>
 #include "Mesh.h"
-#include "Entity.h"
+#include "World.h"
+#include "Components.h"
+#include "TransformHierarchy.h"
 #include "Camera.h"
+#include "Light.h"
 
 namespace Vixen {
     struct Scene {
         Camera camera{};
-        std::vector<Entity> entities;
+        World world;
+
+        /**
+         * The transforms of the entities, update it once per simulation tick so rendering can blend between the last
+         * two ticks
+         */
+        TransformHierarchy transforms;
+
+        std::vector<PointLight> lights;
+        DirectionalLight sun{};
+
+        /**
+         * Must be incremented whenever a static entity is added, removed or moved so cached shadows are re-rendered
+         */
+        uint64_t staticRevision = 0;
+
+        /**
+         * Must be incremented whenever an entity is added or removed or the mesh or texture it draws changes so the
+         * descriptor sets are created again
+         */
+        uint64_t revision = 0;
     };
-}
\ No newline at end of file
+}
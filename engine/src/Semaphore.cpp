@@ -0,0 +1,18 @@
+#include "Semaphore.h"
+
+namespace Vixen {
+    Semaphore::Semaphore(std::shared_ptr<LogicalDevice> device) : device(std::move(device)) {
+        VkSemaphoreCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        VK_CHECK_RESULT(vkCreateSemaphore(this->device->device, &info, nullptr, &semaphore))
+    }
+
+    Semaphore::~Semaphore() {
+        vkDestroySemaphore(device->device, semaphore, nullptr);
+    }
+
+    VkSemaphore Semaphore::getSemaphore() const {
+        return semaphore;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "LogicalDevice.h"
+
+namespace Vixen {
+    /**
+     * A binary semaphore used to order submissions across queues
+     */
+    class Semaphore {
+        const std::shared_ptr<LogicalDevice> device;
+
+        VkSemaphore semaphore{};
+
+    public:
+        explicit Semaphore(std::shared_ptr<LogicalDevice> device);
+
+        Semaphore(const Semaphore &) = delete;
+
+        Semaphore &operator=(const Semaphore &) = delete;
+
+        ~Semaphore();
+
+        [[nodiscard]] VkSemaphore getSemaphore() const;
+    };
+}
@@ -0,0 +1,480 @@
+#include "ShadowCascades.h"
+
+namespace Vixen {
+    static_assert(ShadowCascades::cascadeCount == 4, "The cascade count must match the shaders and the cascade array");
+
+    ShadowCascades::ShadowCascades(const std::shared_ptr<LogicalDevice> &device, uint32_t imageCount,
+                                   float maxDistance) : device(device), imageCount(imageCount),
+                                                        maxDistance(maxDistance) {
+        createShadowMap();
+        createRenderPass();
+        createPipelineLayout();
+        createDescriptorSets();
+
+        commandBuffers.reserve(imageCount);
+        for (uint32_t i = 0; i < imageCount; i++)
+            commandBuffers.push_back(std::make_unique<CommandBuffer>(device));
+    }
+
+    ShadowCascades::~ShadowCascades() {
+        vkDestroySampler(device->device, sampler, nullptr);
+        for (const auto &[layout, pipeline] : pipelines)
+            vkDestroyPipeline(device->device, pipeline, nullptr);
+        vkDestroyPipelineLayout(device->device, pipelineLayout, nullptr);
+        framebuffers.clear();
+        vkDestroyRenderPass(device->device, renderPass, nullptr);
+        for (const auto &view : layerViews)
+            vkDestroyImageView(device->device, view, nullptr);
+    }
+
+    uint32_t ShadowCascades::render(uint32_t imageIndex, const Camera &camera, float aspectRatio,
+                                const RenderSnapshot &snapshot, VkQueryPool timestamps, uint32_t query) {
+        const glm::vec3 direction = glm::normalize(snapshot.sun.direction);
+        if (direction != lightDirection || snapshot.staticRevision != staticRevision) {
+            lightDirection = direction;
+            staticRevision = snapshot.staticRevision;
+            for (auto &cascade : cascades)
+                cascade.valid = false;
+        }
+
+        const glm::vec3 forward = glm::normalize(camera.rotation);
+        const glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+        const glm::vec3 up = glm::cross(right, forward);
+        const float tanHalfFov = std::tan(glm::radians(camera.fieldOfView) / 2.0f);
+
+        auto &commandBuffer = *commandBuffers[imageIndex];
+        commandBuffer.wait();
+        commandBuffer.recordSingleUsage();
+        if (timestamps != VK_NULL_HANDLE) {
+            commandBuffer.cmdResetQueryPool(timestamps, query, 1);
+            commandBuffer.cmdWriteTimestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestamps, query);
+        }
+
+        const auto splits = computeSplits(camera);
+        uint32_t draws = 0;
+        uint32_t budget = cachedUpdateBudget;
+        float begin = camera.nearPlane;
+        for (uint32_t i = 0; i < cascadeCount; i++) {
+            const float end = splits[i];
+
+            /// Bound the frustum slice between begin and end with a sphere, the radius is rounded so it stays
+            /// constant while the camera rotates
+            std::array<glm::vec3, 8> corners{};
+            for (uint32_t j = 0; j < corners.size(); j++) {
+                const float distance = j < 4 ? begin : end;
+                const float height = distance * tanHalfFov;
+                const float width = height * aspectRatio;
+                corners[j] = camera.position + forward * distance + right * (j & 1 ? width : -width) +
+                             up * (j & 2 ? height : -height);
+            }
+            glm::vec3 center{};
+            for (const auto &corner : corners)
+                center += corner / static_cast<float>(corners.size());
+            float radius = 0.0f;
+            for (const auto &corner : corners)
+                radius = std::max(radius, glm::distance(center, corner));
+            radius = std::ceil(radius * 16.0f) / 16.0f;
+            begin = end;
+
+            auto &cascade = cascades[i];
+            if (i < firstCachedCascade) {
+                cascade = {fit(center, radius), center, radius, true};
+                draws += recordCascade(commandBuffer, i, snapshot, false);
+                continue;
+            }
+
+            if (cascade.valid && glm::distance(center, cascade.center) + radius <= cascade.radius)
+                continue;
+
+            /// A cascade that was never rendered has undefined contents and ignores the budget
+            const bool rendered = cascade.radius > 0.0f;
+            if (rendered && budget == 0)
+                continue;
+            if (rendered)
+                budget--;
+
+            radius *= cacheMargin;
+            cascade = {fit(center, radius), center, radius, true};
+            draws += recordCascade(commandBuffer, i, snapshot, true);
+            logger.trace("Re-rendered cached shadow cascade {}", i);
+        }
+
+        commandBuffer.submit();
+
+        Parameters parameters{};
+        for (uint32_t i = 0; i < cascadeCount; i++)
+            parameters.cascades[i] = cascades[i].viewProjection;
+        parameters.direction = camera.getView() * glm::vec4(-lightDirection, 0.0f);
+        parameters.color = glm::vec4(snapshot.sun.color * snapshot.sun.intensity, 1.0f);
+        parameterBuffers[imageIndex].write(&parameters, sizeof(Parameters), 0);
+        return draws;
+    }
+
+    std::array<float, ShadowCascades::cascadeCount> ShadowCascades::computeSplits(const Camera &camera) const {
+        const float near = camera.nearPlane;
+        const float far = std::min(camera.farPlane, maxDistance);
+
+        std::array<float, cascadeCount> splits{};
+        for (uint32_t i = 0; i < cascadeCount; i++) {
+            const float p = static_cast<float>(i + 1) / cascadeCount;
+            const float logarithmic = near * std::pow(far / near, p);
+            const float uniform = near + (far - near) * p;
+            splits[i] = splitLambda * logarithmic + (1.0f - splitLambda) * uniform;
+        }
+
+        return splits;
+    }
+
+    VkDescriptorSetLayout ShadowCascades::getDescriptorSetLayout() const {
+        return descriptorSetLayout->getDescriptorSetLayout();
+    }
+
+    VkDescriptorSet ShadowCascades::getDescriptorSet(uint32_t imageIndex) const {
+        return descriptorSets[imageIndex];
+    }
+
+    glm::mat4 ShadowCascades::fit(const glm::vec3 &center, float radius) const {
+        const glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f)
+                                                                : glm::vec3(0.0f, 1.0f, 0.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+
+        glm::vec3 lightCenter = view * glm::vec4(center, 1.0f);
+        const float texel = 2.0f * radius / resolution;
+        lightCenter.x = std::floor(lightCenter.x / texel) * texel;
+        lightCenter.y = std::floor(lightCenter.y / texel) * texel;
+
+        /// The light looks down negative z, so casters between the cascade and the light have a larger z
+        const glm::mat4 projection = glm::orthoRH_ZO(lightCenter.x - radius, lightCenter.x + radius,
+                                                     lightCenter.y - radius, lightCenter.y + radius,
+                                                     -(lightCenter.z + radius + casterDistance),
+                                                     -(lightCenter.z - radius));
+        return projection * view;
+    }
+
+    uint32_t ShadowCascades::recordCascade(CommandBuffer &commandBuffer, uint32_t index,
+                                           const RenderSnapshot &snapshot, bool staticOnly) {
+        const auto &cascade = cascades[index];
+        const float depthRange = 2.0f * cascade.radius + casterDistance;
+
+        VkClearValue clear{};
+        clear.depthStencil = {1.0f, 0};
+
+        VkRenderPassBeginInfo renderPassBeginInfo{};
+        renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassBeginInfo.renderPass = renderPass;
+        renderPassBeginInfo.framebuffer = framebuffers[index]->getFramebuffer();
+        renderPassBeginInfo.renderArea.offset = {0, 0};
+        renderPassBeginInfo.renderArea.extent = {resolution, resolution};
+        renderPassBeginInfo.clearValueCount = 1;
+        renderPassBeginInfo.pClearValues = &clear;
+
+        commandBuffer.cmdBeginRenderPass(renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        VkBuffer boundVertices = VK_NULL_HANDLE;
+        VkBuffer boundIndices = VK_NULL_HANDLE;
+        VkIndexType boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
+        uint32_t draws = 0;
+
+        for (const auto &draw : snapshot.draws) {
+            if (staticOnly && !draw.isStatic)
+                continue;
+
+            /// Cull casters whose bounding sphere lies outside of the cascade or entirely beyond its far plane, the
+            /// sphere grows with the largest scale along any axis
+            const glm::mat4 &model = draw.model;
+            const float scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                                          glm::length(glm::vec3(model[2]))});
+            const glm::vec3 localCenter = (draw.minimum + draw.maximum) / 2.0f;
+            const float radius = glm::length(draw.maximum - draw.minimum) / 2.0f * scale;
+            const glm::vec4 clip = cascade.viewProjection * model * glm::vec4(localCenter, 1.0f);
+            const float extent = radius / cascade.radius;
+            if (std::abs(clip.x) > 1.0f + extent || std::abs(clip.y) > 1.0f + extent ||
+                clip.z - radius / depthRange > 1.0f)
+                continue;
+
+            if (const VkPipeline pipeline = getPipeline(draw.layout); pipeline != boundPipeline) {
+                commandBuffer.cmdBindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                boundPipeline = pipeline;
+            }
+
+            if (draw.vertexBuffer != boundVertices) {
+                boundVertices = draw.vertexBuffer;
+                commandBuffer.cmdBindVertexBuffers(0, {boundVertices}, {0});
+            }
+            if (draw.indexBuffer != boundIndices || draw.indexType != boundIndexType) {
+                boundIndices = draw.indexBuffer;
+                boundIndexType = draw.indexType;
+                commandBuffer.cmdBindIndexBuffer(boundIndices, 0, boundIndexType);
+            }
+
+            const glm::mat4 modelViewProjection = cascade.viewProjection * model * draw.dequantization;
+            commandBuffer.cmdPushConstants(pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4),
+                                           &modelViewProjection)
+                    .cmdDrawIndexed(draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+            draws++;
+        }
+
+        commandBuffer.cmdEndRenderPass();
+        return draws;
+    }
+
+    void ShadowCascades::createShadowMap() {
+        const auto format = device->physicalDevice->findSupportedFormat(
+                {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM}, VK_IMAGE_TILING_OPTIMAL,
+                VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+
+        shadowMap = std::make_unique<ImageView>(Image(device, resolution, resolution, format,
+                                                      VK_IMAGE_TILING_OPTIMAL,
+                                                      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                      VK_IMAGE_USAGE_SAMPLED_BIT, cascadeCount),
+                                                VK_IMAGE_ASPECT_DEPTH_BIT);
+
+        for (uint32_t i = 0; i < cascadeCount; i++) {
+            VkImageViewCreateInfo createInfo{};
+            createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            createInfo.image = shadowMap->getImage();
+            createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            createInfo.format = format;
+            createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+            createInfo.subresourceRange.baseMipLevel = 0;
+            createInfo.subresourceRange.levelCount = 1;
+            createInfo.subresourceRange.baseArrayLayer = i;
+            createInfo.subresourceRange.layerCount = 1;
+
+            VK_CHECK_RESULT(vkCreateImageView(device->device, &createInfo, nullptr, &layerViews[i]))
+        }
+
+        VkSamplerCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        info.magFilter = VK_FILTER_LINEAR;
+        info.minFilter = VK_FILTER_LINEAR;
+        info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+        info.anisotropyEnable = VK_FALSE;
+        info.maxAnisotropy = 1;
+        info.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+        info.unnormalizedCoordinates = VK_FALSE;
+        info.compareEnable = VK_TRUE;
+        info.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+        info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        info.mipLodBias = 0.0f;
+        info.minLod = 0.0f;
+        info.maxLod = 0.0f;
+
+        VK_CHECK_RESULT(vkCreateSampler(device->device, &info, nullptr, &sampler))
+    }
+
+    void ShadowCascades::createRenderPass() {
+        VkAttachmentDescription depthAttachment{};
+        depthAttachment.format = shadowMap->getFormat();
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+        VkAttachmentReference depthAttachmentReference{};
+        depthAttachmentReference.attachment = 0;
+        depthAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        VkSubpassDescription subpassDescription{};
+        subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpassDescription.colorAttachmentCount = 0;
+        subpassDescription.pDepthStencilAttachment = &depthAttachmentReference;
+
+        /// The previous frame may still be sampling the cascade, and the scene pass samples it afterwards
+        std::array<VkSubpassDependency, 2> dependencies{};
+        dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[0].dstSubpass = 0;
+        dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        dependencies[0].srcAccessMask = 0;
+        dependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        VkRenderPassCreateInfo renderPassCreateInfo{};
+        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassCreateInfo.attachmentCount = 1;
+        renderPassCreateInfo.pAttachments = &depthAttachment;
+        renderPassCreateInfo.subpassCount = 1;
+        renderPassCreateInfo.pSubpasses = &subpassDescription;
+        renderPassCreateInfo.dependencyCount = dependencies.size();
+        renderPassCreateInfo.pDependencies = dependencies.data();
+
+        VK_CHECK_RESULT(vkCreateRenderPass(device->device, &renderPassCreateInfo, nullptr, &renderPass))
+
+        framebuffers.reserve(cascadeCount);
+        for (const auto &view : layerViews)
+            framebuffers.push_back(std::make_unique<Framebuffer>(device, renderPass, std::vector<VkImageView>{view},
+                                                                 resolution, resolution));
+    }
+
+    void ShadowCascades::createPipelineLayout() {
+        vertexModule = ShaderModule::Builder(device)
+                .setShaderStage(VK_SHADER_STAGE_VERTEX_BIT)
+                .setBytecode("shadow.spv")
+                .build();
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(glm::mat4);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.setLayoutCount = 0;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+        VK_CHECK_RESULT(vkCreatePipelineLayout(device->device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout))
+    }
+
+    VkPipeline ShadowCascades::getPipeline(const VertexLayout &layout) {
+        auto &pipeline = pipelines[layout.encode()];
+        if (pipeline == VK_NULL_HANDLE)
+            pipeline = createPipeline(layout);
+        return pipeline;
+    }
+
+    VkPipeline ShadowCascades::createPipeline(const VertexLayout &layout) {
+        VkPipelineShaderStageCreateInfo stage{};
+        stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stage.stage = vertexModule->getStage();
+        stage.module = vertexModule->getModule();
+        stage.pName = vertexModule->getEntryPoint().c_str();
+
+        /// Only the position is read, the rest of each vertex is skipped by the stride
+        const auto binding = layout.getBinding();
+        const auto attribute = layout.getAttributes()[VertexLayout::positionLocation];
+
+        VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo{};
+        vertexInputCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInputCreateInfo.vertexBindingDescriptionCount = 1;
+        vertexInputCreateInfo.pVertexBindingDescriptions = &binding;
+        vertexInputCreateInfo.vertexAttributeDescriptionCount = 1;
+        vertexInputCreateInfo.pVertexAttributeDescriptions = &attribute;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssemblyCreateInfo{};
+        inputAssemblyCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssemblyCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssemblyCreateInfo.primitiveRestartEnable = VK_FALSE;
+
+        VkViewport viewport{0.0f, 0.0f, static_cast<float>(resolution), static_cast<float>(resolution), 0.0f, 1.0f};
+        VkRect2D scissor{{0, 0}, {resolution, resolution}};
+
+        VkPipelineViewportStateCreateInfo viewportStateCreateInfo{};
+        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportStateCreateInfo.viewportCount = 1;
+        viewportStateCreateInfo.pViewports = &viewport;
+        viewportStateCreateInfo.scissorCount = 1;
+        viewportStateCreateInfo.pScissors = &scissor;
+
+        /// Casters in front of the near plane are flattened onto it when depth clamping is available
+        VkPipelineRasterizationStateCreateInfo rasterizationStateCreateInfo{};
+        rasterizationStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizationStateCreateInfo.depthClampEnable = device->physicalDevice->deviceFeatures.depthClamp;
+        rasterizationStateCreateInfo.rasterizerDiscardEnable = VK_FALSE;
+        rasterizationStateCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterizationStateCreateInfo.lineWidth = 1.0f;
+        rasterizationStateCreateInfo.cullMode = VK_CULL_MODE_NONE;
+        rasterizationStateCreateInfo.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rasterizationStateCreateInfo.depthBiasEnable = VK_TRUE;
+        rasterizationStateCreateInfo.depthBiasConstantFactor = 1.25f;
+        rasterizationStateCreateInfo.depthBiasClamp = 0.0f;
+        rasterizationStateCreateInfo.depthBiasSlopeFactor = 1.75f;
+
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        multisampling.minSampleShading = 1.0f;
+
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = VK_TRUE;
+        depthStencil.depthWriteEnable = VK_TRUE;
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+        depthStencil.depthBoundsTestEnable = VK_FALSE;
+        depthStencil.minDepthBounds = 0.0f;
+        depthStencil.maxDepthBounds = 1.0f;
+        depthStencil.stencilTestEnable = VK_FALSE;
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.attachmentCount = 0;
+
+        VkGraphicsPipelineCreateInfo pipelineCreateInfo{};
+        pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineCreateInfo.stageCount = 1;
+        pipelineCreateInfo.pStages = &stage;
+        pipelineCreateInfo.pVertexInputState = &vertexInputCreateInfo;
+        pipelineCreateInfo.pInputAssemblyState = &inputAssemblyCreateInfo;
+        pipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+        pipelineCreateInfo.pRasterizationState = &rasterizationStateCreateInfo;
+        pipelineCreateInfo.pMultisampleState = &multisampling;
+        pipelineCreateInfo.pDepthStencilState = &depthStencil;
+        pipelineCreateInfo.pColorBlendState = &colorBlending;
+        pipelineCreateInfo.layout = pipelineLayout;
+        pipelineCreateInfo.renderPass = renderPass;
+        pipelineCreateInfo.subpass = 0;
+        pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineCreateInfo.basePipelineIndex = -1;
+
+        VkPipeline pipeline;
+        VK_CHECK_RESULT(vkCreateGraphicsPipelines(device->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr,
+                                                  &pipeline))
+        logger.trace("Successfully created shadow pipeline for vertex layout {:06x}", layout.encode());
+        return pipeline;
+    }
+
+    void ShadowCascades::createDescriptorSets() {
+        std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+        bindings[0].binding = 0;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        bindings[0].descriptorCount = 1;
+        bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        bindings[1].binding = 1;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        descriptorSetLayout = std::make_unique<DescriptorSetLayout>(
+                device, std::vector<VkDescriptorSetLayoutBinding>(bindings.begin(), bindings.end()));
+
+        descriptorPool = std::make_unique<DescriptorPool>(device, std::vector<VkDescriptorPoolSize>{
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, imageCount},
+                {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageCount}
+        }, imageCount);
+        descriptorSets = descriptorPool->createSets(std::vector<VkDescriptorSetLayout>(
+                imageCount, descriptorSetLayout->getDescriptorSetLayout()));
+
+        parameterBuffers.reserve(imageCount);
+        for (uint32_t i = 0; i < imageCount; i++) {
+            parameterBuffers.emplace_back(device, sizeof(Parameters), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                          VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+            VkDescriptorBufferInfo buffer{parameterBuffers[i].getBuffer(), 0, sizeof(Parameters)};
+            VkDescriptorImageInfo image{sampler, shadowMap->getView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+            std::array<VkWriteDescriptorSet, 2> writes{};
+            for (uint32_t j = 0; j < writes.size(); j++) {
+                writes[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[j].dstSet = descriptorSets[i];
+                writes[j].dstBinding = j;
+                writes[j].dstArrayElement = 0;
+                writes[j].descriptorType = bindings[j].descriptorType;
+                writes[j].descriptorCount = 1;
+            }
+            writes[0].pBufferInfo = &buffer;
+            writes[1].pImageInfo = &image;
+            vkUpdateDescriptorSets(device->device, writes.size(), writes.data(), 0, nullptr);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "LogicalDevice.h"
+#include "Buffer.h"
+#include "CommandBuffer.h"
+#include "DescriptorSetLayout.h"
+#include "DescriptorPool.h"
+#include "Framebuffer.h"
+#include "ImageView.h"
+#include "ShaderModule.h"
+#include "RenderSnapshot.h"
+
+namespace Vixen {
+    /**
+     * Cascaded shadow maps for the scene's directional light. The nearest cascades are re-rendered every frame, the
+     * distant cascades only contain static geometry and are cached until the light or the static geometry changes, or
+     * until the camera leaves the area they were rendered for.
+     */
+    class ShadowCascades {
+        const Logger logger{"ShadowCascades"};
+
+        struct Cascade {
+            /// The light space view projection the current shadow map contents were rendered with
+            glm::mat4 viewProjection{1.0f};
+            /// The world space sphere covered by the current shadow map contents
+            glm::vec3 center{};
+            float radius = 0.0f;
+            /// Whether the cascade holds usable contents for the current light and static geometry
+            bool valid = false;
+        };
+
+        /**
+         * The uniform block read by the fragment shader, std140 layout
+         */
+        struct Parameters {
+            std::array<glm::mat4, 4> cascades;
+            /// The view space direction towards the light
+            glm::vec4 direction;
+            /// The light color premultiplied with its intensity
+            glm::vec4 color;
+        };
+
+        const std::shared_ptr<LogicalDevice> device;
+
+        const uint32_t imageCount;
+
+        const float maxDistance;
+
+        std::array<Cascade, 4> cascades{};
+
+        glm::vec3 lightDirection{};
+
+        uint64_t staticRevision = 0;
+
+        std::unique_ptr<ImageView> shadowMap;
+
+        std::array<VkImageView, 4> layerViews{};
+
+        std::vector<std::unique_ptr<Framebuffer>> framebuffers;
+
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+        /// A pipeline for every vertex layout drawn so far, keyed by the encoded layout
+        std::unordered_map<uint32_t, VkPipeline> pipelines;
+
+        VkSampler sampler = VK_NULL_HANDLE;
+
+        std::shared_ptr<const ShaderModule> vertexModule;
+
+        std::unique_ptr<DescriptorSetLayout> descriptorSetLayout;
+
+        std::unique_ptr<DescriptorPool> descriptorPool;
+
+        std::vector<VkDescriptorSet> descriptorSets;
+
+        std::vector<Buffer> parameterBuffers;
+
+        std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
+
+        void createShadowMap();
+
+        void createRenderPass();
+
+        void createPipelineLayout();
+
+        /**
+         * Returns the pipeline for casters of a vertex layout, creating it the first time the layout is drawn
+         */
+        VkPipeline getPipeline(const VertexLayout &layout);
+
+        VkPipeline createPipeline(const VertexLayout &layout);
+
+        void createDescriptorSets();
+
+        /**
+         * Fits an orthographic light projection around a sphere, snapped to whole texels so the shadow map does not
+         * shimmer while the camera moves
+         */
+        [[nodiscard]] glm::mat4 fit(const glm::vec3 &center, float radius) const;
+
+        /**
+         * @return The amount of casters drawn into the cascade
+         */
+        uint32_t recordCascade(CommandBuffer &commandBuffer, uint32_t index, const RenderSnapshot &snapshot,
+                               bool staticOnly);
+
+    public:
+        static constexpr uint32_t cascadeCount = 4;
+
+        static constexpr uint32_t resolution = 2048;
+
+        /**
+         * Cascades from this index onwards are cached, cascades before it are rendered every frame
+         */
+        static constexpr uint32_t firstCachedCascade = 2;
+
+        /**
+         * The maximum amount of cached cascades re-rendered in a single frame, stale cascades beyond the budget keep
+         * their old contents and are updated in a later frame
+         */
+        static constexpr uint32_t cachedUpdateBudget = 1;
+
+        /**
+         * Cached cascades cover this much more than their slice so small camera movements do not invalidate them
+         */
+        static constexpr float cacheMargin = 1.5f;
+
+        /**
+         * How far behind a cascade casters are still rendered, in world units
+         */
+        static constexpr float casterDistance = 100.0f;
+
+        /**
+         * Weighs the split distribution between uniform (0) and logarithmic (1)
+         */
+        static constexpr float splitLambda = 0.8f;
+
+        /**
+         * @param[in] device The device to create the shadow resources on
+         * @param[in] imageCount The amount of swap chain images
+         * @param[in] maxDistance The furthest distance from the camera that receives shadows, the camera far plane is
+         * used when it is nearer
+         */
+        ShadowCascades(const std::shared_ptr<LogicalDevice> &device, uint32_t imageCount, float maxDistance = 200.0f);
+
+        ShadowCascades(const ShadowCascades &) = delete;
+
+        ShadowCascades &operator=(const ShadowCascades &) = delete;
+
+        ~ShadowCascades();
+
+        /**
+         * Updates the cascades for the current camera and submits the shadow pass for a swap chain image, this must be
+         * called before the scene is rendered to that image
+         *
+         * @param[in] timestamps A query pool to write a timestamp into before the shadow pass starts, if any
+         * @param[in] query The query of the pool to reset and write
+         * @return The amount of draw calls recorded into the shadow pass
+         */
+        uint32_t render(uint32_t imageIndex, const Camera &camera, float aspectRatio, const RenderSnapshot &snapshot,
+                    VkQueryPool timestamps = VK_NULL_HANDLE, uint32_t query = 0);
+
+        /**
+         * Computes the far distance of every cascade using the practical split scheme
+         */
+        [[nodiscard]] std::array<float, cascadeCount> computeSplits(const Camera &camera) const;
+
+        [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayout() const;
+
+        [[nodiscard]] VkDescriptorSet getDescriptorSet(uint32_t imageIndex) const;
+    };
+}
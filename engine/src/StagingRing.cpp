@@ -0,0 +1,72 @@
+#include "StagingRing.h"
+
+namespace Vixen {
+    StagingRing::StagingRing(const std::shared_ptr<LogicalDevice> &device, VkDeviceSize capacity)
+            : buffer(device, capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY),
+              data(static_cast<char *>(buffer.map())), capacity(capacity) {}
+
+    StagingRing::~StagingRing() {
+        buffer.unmap();
+    }
+
+    std::optional<VkDeviceSize> StagingRing::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+        if (size > capacity)
+            return std::nullopt;
+
+        /// Start over at the beginning whenever the ring drains to keep large allocations from having to wrap
+        if (used == 0)
+            head = tail = 0;
+        else if (head == tail)
+            return std::nullopt;
+
+        VkDeviceSize offset = (head + alignment - 1) / alignment * alignment;
+        if (head > tail || used == 0) {
+            if (offset + size > capacity) {
+                /// Skip the remainder of the ring and wrap around to the start
+                if (size > tail)
+                    return std::nullopt;
+                offset = 0;
+            }
+        } else if (offset + size > tail) {
+            return std::nullopt;
+        }
+
+        const VkDeviceSize consumed = offset >= head ? offset + size - head : capacity - head + size;
+        head = offset + size;
+        used += consumed;
+        pendingBytes += consumed;
+        return offset;
+    }
+
+    void StagingRing::retire(uint64_t ticket) {
+        if (pendingBytes == 0)
+            return;
+
+        regions.push_back({ticket, head, pendingBytes});
+        pendingBytes = 0;
+    }
+
+    void StagingRing::reclaim(uint64_t completedTicket) {
+        while (!regions.empty() && regions.front().ticket <= completedTicket) {
+            tail = regions.front().end;
+            used -= regions.front().bytes;
+            regions.pop_front();
+        }
+    }
+
+    VkBuffer StagingRing::getBuffer() const {
+        return buffer.getBuffer();
+    }
+
+    char *StagingRing::getData() const {
+        return data;
+    }
+
+    VkDeviceSize StagingRing::getCapacity() const {
+        return capacity;
+    }
+
+    VkDeviceSize StagingRing::getUsed() const {
+        return used;
+    }
+}
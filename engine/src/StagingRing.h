@@ -0,0 +1,74 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include "LogicalDevice.h"
+#include "Buffer.h"
+
+namespace Vixen {
+    /**
+     * A persistently mapped host visible buffer that staging memory is suballocated from in FIFO order. Allocations are
+     * grouped by the upload batch that consumes them and are reclaimed together once that batch has completed.
+     */
+    class StagingRing {
+        struct Region {
+            uint64_t ticket;
+            /// The head of the ring after the last allocation of the batch
+            VkDeviceSize end;
+            /// The bytes consumed by the batch, including padding skipped when wrapping around
+            VkDeviceSize bytes;
+        };
+
+        Buffer buffer;
+
+        char *data;
+
+        const VkDeviceSize capacity;
+
+        VkDeviceSize head = 0;
+
+        VkDeviceSize tail = 0;
+
+        VkDeviceSize used = 0;
+
+        /// The bytes allocated since the last call to retire
+        VkDeviceSize pendingBytes = 0;
+
+        std::deque<Region> regions;
+
+    public:
+        StagingRing(const std::shared_ptr<LogicalDevice> &device, VkDeviceSize capacity);
+
+        StagingRing(const StagingRing &) = delete;
+
+        StagingRing &operator=(const StagingRing &) = delete;
+
+        ~StagingRing();
+
+        /**
+         * Allocates a range of the ring
+         *
+         * @return The offset of the allocation, or nothing when the ring does not have enough free space left
+         */
+        std::optional<VkDeviceSize> allocate(VkDeviceSize size, VkDeviceSize alignment);
+
+        /**
+         * Assigns every allocation made since the last call to the batch with the given ticket
+         */
+        void retire(uint64_t ticket);
+
+        /**
+         * Frees the allocations of every batch up to and including the given ticket
+         */
+        void reclaim(uint64_t completedTicket);
+
+        [[nodiscard]] VkBuffer getBuffer() const;
+
+        [[nodiscard]] char *getData() const;
+
+        [[nodiscard]] VkDeviceSize getCapacity() const;
+
+        [[nodiscard]] VkDeviceSize getUsed() const;
+    };
+}
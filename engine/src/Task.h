@@ -0,0 +1,136 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Vixen {
+    /**
+     * A coroutine that starts running as soon as it is called and can be awaited by other coroutines. The task owns the
+     * coroutine frame, destroying a task that is still suspended abandons the coroutine without resuming it.
+     */
+    template<typename T = void>
+    class Task {
+        struct PromiseBase {
+            std::coroutine_handle<> continuation;
+
+            std::exception_ptr exception;
+
+            std::suspend_never initial_suspend() noexcept {
+                return {};
+            }
+
+            struct FinalAwaiter {
+                bool await_ready() noexcept {
+                    return false;
+                }
+
+                /// Resumes the awaiting coroutine, if any, without growing the stack
+                template<typename P>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept {
+                    if (const auto continuation = handle.promise().continuation)
+                        return continuation;
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            FinalAwaiter final_suspend() noexcept {
+                return {};
+            }
+
+            void unhandled_exception() {
+                exception = std::current_exception();
+            }
+        };
+
+        struct ValuePromise : PromiseBase {
+            std::optional<T> value;
+
+            template<typename U>
+            void return_value(U &&result) {
+                value.emplace(std::forward<U>(result));
+            }
+        };
+
+        struct VoidPromise : PromiseBase {
+            void return_void() {}
+        };
+
+    public:
+        struct promise_type : std::conditional_t<std::is_void_v<T>, VoidPromise, ValuePromise> {
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        static decltype(auto) result(std::coroutine_handle<promise_type> handle) {
+            if (!handle.done())
+                throw std::runtime_error("Task has not finished yet");
+            if (handle.promise().exception)
+                std::rethrow_exception(handle.promise().exception);
+            if constexpr (!std::is_void_v<T>)
+                return *handle.promise().value;
+        }
+
+    public:
+        Task(const Task &) = delete;
+
+        Task &operator=(const Task &) = delete;
+
+        Task(Task &&other) noexcept: handle(std::exchange(other.handle, nullptr)) {}
+
+        Task &operator=(Task &&other) noexcept {
+            if (this != &other) {
+                if (handle)
+                    handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task() {
+            if (handle)
+                handle.destroy();
+        }
+
+        [[nodiscard]] bool isDone() const {
+            return !handle || handle.done();
+        }
+
+        /**
+         * Returns the result of a finished task, rethrowing the exception the coroutine exited with
+         */
+        decltype(auto) get() const {
+            return result(handle);
+        }
+
+        auto operator co_await() const noexcept {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() const noexcept {
+                    return handle.done();
+                }
+
+                void await_suspend(std::coroutine_handle<> continuation) const noexcept {
+                    handle.promise().continuation = continuation;
+                }
+
+                decltype(auto) await_resume() const {
+                    return result(handle);
+                }
+            };
+            return Awaiter{handle};
+        }
+    };
+}
@@ -0,0 +1,622 @@
+#include "TransformHierarchy.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <glm/gtc/type_ptr.hpp>
+#include "JobSystem.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VIXEN_TRANSFORM_AVX
+#endif
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VIXEN_TRANSFORM_SSE
+#endif
+
+namespace Vixen {
+    namespace {
+        /**
+         * The arithmetic composing local matrices, once for every width of lanes. The same expressions are evaluated
+         * for every width, so a node gets the same matrix whichever width composed it.
+         */
+        struct ScalarLanes {
+            using Type = float;
+
+            static constexpr size_t width = 1;
+
+            static Type load(const float *source) { return *source; }
+
+            static void store(float *destination, Type value) { *destination = value; }
+
+            static Type set(float value) { return value; }
+
+            static Type add(Type a, Type b) { return a + b; }
+
+            static Type sub(Type a, Type b) { return a - b; }
+
+            static Type mul(Type a, Type b) { return a * b; }
+        };
+
+#ifdef VIXEN_TRANSFORM_SSE
+        struct SseLanes {
+            using Type = __m128;
+
+            static constexpr size_t width = 4;
+
+            static Type load(const float *source) { return _mm_loadu_ps(source); }
+
+            static void store(float *destination, Type value) { _mm_store_ps(destination, value); }
+
+            static Type set(float value) { return _mm_set1_ps(value); }
+
+            static Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+
+            static Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+
+            static Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+        };
+#endif
+
+#ifdef VIXEN_TRANSFORM_AVX
+        struct AvxLanes {
+            using Type = __m256;
+
+            static constexpr size_t width = 8;
+
+            static Type load(const float *source) { return _mm256_loadu_ps(source); }
+
+            static void store(float *destination, Type value) { _mm256_store_ps(destination, value); }
+
+            static Type set(float value) { return _mm256_set1_ps(value); }
+
+            static Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+
+            static Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+
+            static Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+        };
+
+        using Lanes = AvxLanes;
+#elif defined(VIXEN_TRANSFORM_SSE)
+        using Lanes = SseLanes;
+#else
+        using Lanes = ScalarLanes;
+#endif
+
+        /**
+         * The local matrices of a block of nodes as translation * rotation * scale. Writes 12 rows of L::width floats:
+         * the upper three elements of the first three columns followed by the translation.
+         */
+        template<typename L, typename Level>
+        void composeLocal(const Level &level, size_t i, float *local) {
+            using T = typename L::Type;
+            const T x = L::load(&level.rotationX[i]);
+            const T y = L::load(&level.rotationY[i]);
+            const T z = L::load(&level.rotationZ[i]);
+            const T w = L::load(&level.rotationW[i]);
+            const T one = L::set(1.0f);
+            const T two = L::set(2.0f);
+
+            const T x2 = L::mul(x, two);
+            const T y2 = L::mul(y, two);
+            const T z2 = L::mul(z, two);
+            const T xx = L::mul(x, x2);
+            const T yy = L::mul(y, y2);
+            const T zz = L::mul(z, z2);
+            const T xy = L::mul(x, y2);
+            const T xz = L::mul(x, z2);
+            const T yz = L::mul(y, z2);
+            const T wx = L::mul(w, x2);
+            const T wy = L::mul(w, y2);
+            const T wz = L::mul(w, z2);
+
+            const T scaleX = L::load(&level.scaleX[i]);
+            const T scaleY = L::load(&level.scaleY[i]);
+            const T scaleZ = L::load(&level.scaleZ[i]);
+            constexpr size_t width = L::width;
+            L::store(local + 0 * width, L::mul(L::sub(one, L::add(yy, zz)), scaleX));
+            L::store(local + 1 * width, L::mul(L::add(xy, wz), scaleX));
+            L::store(local + 2 * width, L::mul(L::sub(xz, wy), scaleX));
+            L::store(local + 3 * width, L::mul(L::sub(xy, wz), scaleY));
+            L::store(local + 4 * width, L::mul(L::sub(one, L::add(xx, zz)), scaleY));
+            L::store(local + 5 * width, L::mul(L::add(yz, wx), scaleY));
+            L::store(local + 6 * width, L::mul(L::add(xz, wy), scaleZ));
+            L::store(local + 7 * width, L::mul(L::sub(yz, wx), scaleZ));
+            L::store(local + 8 * width, L::mul(L::sub(one, L::add(xx, yy)), scaleZ));
+            L::store(local + 9 * width, L::load(&level.positionX[i]));
+            L::store(local + 10 * width, L::load(&level.positionY[i]));
+            L::store(local + 11 * width, L::load(&level.positionZ[i]));
+        }
+
+#ifdef VIXEN_TRANSFORM_SSE
+        /**
+         * Stores parent * local, or local itself for roots, the matrices are given as columns
+         */
+        void storeWorld(float *world, const float *parent, const __m128 (&local)[4]) {
+            if (!parent) {
+                for (size_t column = 0; column < 4; column++)
+                    _mm_storeu_ps(world + column * 4, local[column]);
+                return;
+            }
+
+            const __m128 parent0 = _mm_loadu_ps(parent);
+            const __m128 parent1 = _mm_loadu_ps(parent + 4);
+            const __m128 parent2 = _mm_loadu_ps(parent + 8);
+            const __m128 parent3 = _mm_loadu_ps(parent + 12);
+            for (size_t column = 0; column < 4; column++) {
+                const __m128 value = local[column];
+                __m128 result = _mm_mul_ps(parent0, _mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 0, 0, 0)));
+                result = _mm_add_ps(result, _mm_mul_ps(parent1, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1))));
+                result = _mm_add_ps(result, _mm_mul_ps(parent2, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2))));
+                result = _mm_add_ps(result, _mm_mul_ps(parent3, _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3))));
+                _mm_storeu_ps(world + column * 4, result);
+            }
+        }
+#endif
+    }
+
+    const size_t TransformHierarchy::lanes = Lanes::width;
+
+    size_t TransformHierarchy::Level::size() const {
+        return slots.size();
+    }
+
+    void TransformHierarchy::Level::push(uint32_t slot, uint32_t parent, const Local &local) {
+        slots.push_back(slot);
+        parents.push_back(parent);
+        positionX.push_back(0.0f);
+        positionY.push_back(0.0f);
+        positionZ.push_back(0.0f);
+        rotationX.push_back(0.0f);
+        rotationY.push_back(0.0f);
+        rotationZ.push_back(0.0f);
+        rotationW.push_back(1.0f);
+        scaleX.push_back(1.0f);
+        scaleY.push_back(1.0f);
+        scaleZ.push_back(1.0f);
+        dirty.push_back(placed);
+        changed.push_back(0);
+        world.emplace_back(1.0f);
+        previous.emplace_back(1.0f);
+        setLocal(size() - 1, local);
+    }
+
+    void TransformHierarchy::Level::moveLast(size_t position) {
+        eachArray([position](auto &array) {
+            array[position] = array.back();
+        });
+    }
+
+    void TransformHierarchy::Level::pop() {
+        eachArray([](auto &array) {
+            array.pop_back();
+        });
+    }
+
+    TransformHierarchy::Local TransformHierarchy::Level::getLocal(size_t position) const {
+        return {
+                {positionX[position], positionY[position], positionZ[position]},
+                glm::quat(rotationW[position], rotationX[position], rotationY[position], rotationZ[position]),
+                {scaleX[position], scaleY[position], scaleZ[position]}
+        };
+    }
+
+    void TransformHierarchy::Level::setLocal(size_t position, const Local &local) {
+        positionX[position] = local.position.x;
+        positionY[position] = local.position.y;
+        positionZ[position] = local.position.z;
+        rotationX[position] = local.rotation.x;
+        rotationY[position] = local.rotation.y;
+        rotationZ[position] = local.rotation.z;
+        rotationW[position] = local.rotation.w;
+        scaleX[position] = local.scale.x;
+        scaleY[position] = local.scale.y;
+        scaleZ[position] = local.scale.z;
+        touch(position);
+    }
+
+    void TransformHierarchy::Level::touch(size_t position) {
+        if (dirty[position] == clean)
+            dirty[position] = moved;
+    }
+
+    const TransformHierarchy::Slot &TransformHierarchy::getSlot(Node node) const {
+        if (!isAlive(node))
+            throw std::runtime_error("Transform node is not alive");
+        return slots[node.index];
+    }
+
+    void TransformHierarchy::insert(uint32_t slot, uint32_t level, const Local &local) {
+        if (level >= levels.size())
+            levels.resize(level + 1);
+
+        auto &node = slots[slot];
+        node.level = level;
+        node.position = static_cast<uint32_t>(levels[level].size());
+        levels[level].push(slot, node.parent == none ? none : slots[node.parent].position, local);
+    }
+
+    void TransformHierarchy::erase(uint32_t slot) {
+        const auto &node = slots[slot];
+        auto &level = levels[node.level];
+        const uint32_t position = node.position;
+        if (position != level.size() - 1) {
+            level.moveLast(position);
+            auto &moved = slots[level.slots[position]];
+            moved.position = position;
+            /// Children are found through their slots, they may sit in another level while a subtree moves
+            for (uint32_t child = moved.firstChild; child != none; child = slots[child].nextSibling)
+                levels[slots[child].level].parents[slots[child].position] = position;
+        }
+        level.pop();
+    }
+
+    void TransformHierarchy::trim() {
+        while (!levels.empty() && levels.back().size() == 0)
+            levels.pop_back();
+    }
+
+    void TransformHierarchy::link(uint32_t slot, uint32_t parent) {
+        auto &node = slots[slot];
+        node.parent = parent;
+        node.previousSibling = none;
+        node.nextSibling = none;
+        if (parent == none)
+            return;
+
+        auto &parentNode = slots[parent];
+        node.nextSibling = parentNode.firstChild;
+        if (parentNode.firstChild != none)
+            slots[parentNode.firstChild].previousSibling = slot;
+        parentNode.firstChild = slot;
+    }
+
+    void TransformHierarchy::unlink(uint32_t slot) {
+        auto &node = slots[slot];
+        if (node.previousSibling != none)
+            slots[node.previousSibling].nextSibling = node.nextSibling;
+        else if (node.parent != none)
+            slots[node.parent].firstChild = node.nextSibling;
+        if (node.nextSibling != none)
+            slots[node.nextSibling].previousSibling = node.previousSibling;
+
+        node.parent = none;
+        node.previousSibling = none;
+        node.nextSibling = none;
+    }
+
+    std::vector<uint32_t> TransformHierarchy::collectSubtree(uint32_t slot) const {
+        std::vector<uint32_t> subtree{slot};
+        for (size_t i = 0; i < subtree.size(); i++)
+            for (uint32_t child = slots[subtree[i]].firstChild; child != none; child = slots[child].nextSibling)
+                subtree.push_back(child);
+        return subtree;
+    }
+
+    void TransformHierarchy::compose(size_t levelIndex, size_t begin, size_t count) {
+        auto &level = levels[levelIndex];
+        const Level *parent = levelIndex > 0 ? &levels[levelIndex - 1] : nullptr;
+
+#ifdef VIXEN_TRANSFORM_SSE
+        if (count == Lanes::width) {
+            alignas(32) float local[12 * Lanes::width];
+            composeLocal<Lanes>(level, begin, local);
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (size_t group = 0; group < Lanes::width; group += 4) {
+                /// Transposing the rows of four nodes gives one column of each of their matrices
+                __m128 columns[4][4];
+                for (size_t column = 0; column < 4; column++) {
+                    const float *rows = local + column * 3 * Lanes::width + group;
+                    __m128 x = _mm_load_ps(rows);
+                    __m128 y = _mm_load_ps(rows + Lanes::width);
+                    __m128 z = _mm_load_ps(rows + 2 * Lanes::width);
+                    __m128 w = column == 3 ? one : zero;
+                    _MM_TRANSPOSE4_PS(x, y, z, w);
+                    columns[0][column] = x;
+                    columns[1][column] = y;
+                    columns[2][column] = z;
+                    columns[3][column] = w;
+                }
+
+                for (size_t lane = 0; lane < 4; lane++) {
+                    const size_t i = begin + group + lane;
+                    if (level.changed[i])
+                        storeWorld(glm::value_ptr(level.world[i]),
+                                   parent ? glm::value_ptr(parent->world[level.parents[i]]) : nullptr,
+                                   columns[lane]);
+                }
+            }
+            return;
+        }
+#endif
+
+        for (size_t i = begin; i < begin + count; i++) {
+            if (!level.changed[i])
+                continue;
+
+            float local[12];
+            composeLocal<ScalarLanes>(level, i, local);
+            const glm::mat4 matrix{
+                    {local[0], local[1], local[2], 0.0f},
+                    {local[3], local[4], local[5], 0.0f},
+                    {local[6], local[7], local[8], 0.0f},
+                    {local[9], local[10], local[11], 1.0f}
+            };
+            level.world[i] = parent ? parent->world[level.parents[i]] * matrix : matrix;
+        }
+    }
+
+    TransformHierarchy::Node TransformHierarchy::create(const glm::vec3 &position, const glm::quat &rotation,
+                                                        const glm::vec3 &scale, Node parent) {
+        uint32_t parentSlot = none;
+        uint32_t level = 0;
+        if (parent != Node{}) {
+            level = getSlot(parent).level + 1;
+            parentSlot = parent.index;
+        }
+
+        uint32_t index;
+        if (freeSlots.empty()) {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        } else {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        slots[index].alive = true;
+        link(index, parentSlot);
+        insert(index, level, {position, glm::normalize(rotation), scale});
+        size++;
+        return {index, slots[index].generation};
+    }
+
+    void TransformHierarchy::destroy(Node node) {
+        if (!isAlive(node))
+            throw std::runtime_error("Transform node is not alive");
+        const auto subtree = collectSubtree(node.index);
+        unlink(node.index);
+
+        /// Parents first, nodes moved into the gaps then never have children that were already erased
+        for (const auto slot : subtree) {
+            erase(slot);
+            auto &removed = slots[slot];
+            /// Generation zero is reserved for the handle of a root's parent
+            const uint32_t generation = removed.generation + 1 == 0 ? 1 : removed.generation + 1;
+            removed = {};
+            removed.generation = generation;
+            freeSlots.push_back(slot);
+        }
+        size -= subtree.size();
+        trim();
+    }
+
+    bool TransformHierarchy::isAlive(Node node) const {
+        return node.index < slots.size() && slots[node.index].generation == node.generation &&
+               slots[node.index].alive;
+    }
+
+    void TransformHierarchy::setParent(Node node, Node parent) {
+        const auto &slot = getSlot(node);
+        uint32_t parentSlot = none;
+        uint32_t level = 0;
+        if (parent != Node{}) {
+            level = getSlot(parent).level + 1;
+            parentSlot = parent.index;
+            for (uint32_t ancestor = parentSlot; ancestor != none; ancestor = slots[ancestor].parent)
+                if (ancestor == node.index)
+                    throw std::runtime_error("A transform node cannot be attached to itself or its descendants");
+        }
+        if (slot.parent == parentSlot)
+            return;
+
+        /// The subtree is taken out of its levels first and inserted again parents first, so positions stay put while
+        /// the children look up their parents
+        /// The world matrices come along so the subtree keeps rendering where it was until the next update
+        struct Detached {
+            Local local;
+            glm::mat4 world;
+            glm::mat4 previous;
+            bool placed;
+        };
+
+        const auto subtree = collectSubtree(node.index);
+        const int64_t shift = static_cast<int64_t>(level) - slot.level;
+        std::vector<Detached> detached;
+        detached.reserve(subtree.size());
+        for (const auto removed : subtree) {
+            const auto &from = levels[slots[removed].level];
+            const uint32_t position = slots[removed].position;
+            detached.push_back({from.getLocal(position), from.world[position], from.previous[position],
+                                from.dirty[position] == Level::placed});
+            erase(removed);
+        }
+
+        unlink(node.index);
+        link(node.index, parentSlot);
+        for (size_t i = 0; i < subtree.size(); i++) {
+            insert(subtree[i], static_cast<uint32_t>(slots[subtree[i]].level + shift), detached[i].local);
+            auto &to = levels[slots[subtree[i]].level];
+            const uint32_t position = slots[subtree[i]].position;
+            to.world[position] = detached[i].world;
+            to.previous[position] = detached[i].previous;
+            to.dirty[position] = detached[i].placed ? Level::placed : Level::moved;
+        }
+        trim();
+    }
+
+    TransformHierarchy::Node TransformHierarchy::getParent(Node node) const {
+        const uint32_t parent = getSlot(node).parent;
+        if (parent == none)
+            return {};
+        return {parent, slots[parent].generation};
+    }
+
+    void TransformHierarchy::setLocal(Node node, const glm::vec3 &position, const glm::quat &rotation,
+                                      const glm::vec3 &scale) {
+        const auto &slot = getSlot(node);
+        levels[slot.level].setLocal(slot.position, {position, glm::normalize(rotation), scale});
+    }
+
+    void TransformHierarchy::setPosition(Node node, const glm::vec3 &position) {
+        const auto &slot = getSlot(node);
+        auto &level = levels[slot.level];
+        level.positionX[slot.position] = position.x;
+        level.positionY[slot.position] = position.y;
+        level.positionZ[slot.position] = position.z;
+        level.touch(slot.position);
+    }
+
+    void TransformHierarchy::setRotation(Node node, const glm::quat &rotation) {
+        const auto &slot = getSlot(node);
+        auto &level = levels[slot.level];
+        const glm::quat normalized = glm::normalize(rotation);
+        level.rotationX[slot.position] = normalized.x;
+        level.rotationY[slot.position] = normalized.y;
+        level.rotationZ[slot.position] = normalized.z;
+        level.rotationW[slot.position] = normalized.w;
+        level.touch(slot.position);
+    }
+
+    void TransformHierarchy::setScale(Node node, const glm::vec3 &scale) {
+        const auto &slot = getSlot(node);
+        auto &level = levels[slot.level];
+        level.scaleX[slot.position] = scale.x;
+        level.scaleY[slot.position] = scale.y;
+        level.scaleZ[slot.position] = scale.z;
+        level.touch(slot.position);
+    }
+
+    glm::vec3 TransformHierarchy::getPosition(Node node) const {
+        const auto &slot = getSlot(node);
+        return levels[slot.level].getLocal(slot.position).position;
+    }
+
+    glm::quat TransformHierarchy::getRotation(Node node) const {
+        const auto &slot = getSlot(node);
+        return levels[slot.level].getLocal(slot.position).rotation;
+    }
+
+    glm::vec3 TransformHierarchy::getScale(Node node) const {
+        const auto &slot = getSlot(node);
+        return levels[slot.level].getLocal(slot.position).scale;
+    }
+
+    const glm::mat4 &TransformHierarchy::getWorldMatrix(Node node) const {
+        const auto &slot = getSlot(node);
+        return levels[slot.level].world[slot.position];
+    }
+
+    glm::mat4 TransformHierarchy::getInterpolatedMatrix(Node node, float alpha) const {
+        const auto &slot = getSlot(node);
+        const auto &level = levels[slot.level];
+        const glm::mat4 &from = level.previous[slot.position];
+        const glm::mat4 &to = level.world[slot.position];
+        if (alpha >= 1.0f || from == to)
+            return to;
+
+        /// Mirrored matrices flip the first axis so the remaining rotation is a proper one, collapsed axes are left as
+        /// they are since the zero scale hides them anyway
+        const auto decompose = [](const glm::mat4 &matrix, glm::vec3 &scale) {
+            scale = {glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])),
+                     glm::length(glm::vec3(matrix[2]))};
+            if (glm::determinant(glm::mat3(matrix)) < 0.0f)
+                scale.x = -scale.x;
+            const glm::vec3 divisor = glm::mix(glm::vec3(1.0f), scale, glm::notEqual(scale, glm::vec3(0.0f)));
+            return glm::quat_cast(glm::mat3(glm::vec3(matrix[0]) / divisor.x, glm::vec3(matrix[1]) / divisor.y,
+                                            glm::vec3(matrix[2]) / divisor.z));
+        };
+
+        glm::vec3 fromScale, toScale;
+        const glm::quat fromRotation = decompose(from, fromScale);
+        const glm::quat toRotation = decompose(to, toScale);
+        const glm::vec3 scale = glm::mix(fromScale, toScale, alpha);
+
+        glm::mat4 matrix = glm::mat4_cast(glm::slerp(fromRotation, toRotation, alpha));
+        matrix[0] *= scale.x;
+        matrix[1] *= scale.y;
+        matrix[2] *= scale.z;
+        matrix[3] = glm::mix(from[3], to[3], alpha);
+        return matrix;
+    }
+
+    bool TransformHierarchy::isComposed(Node node) const {
+        const auto &slot = getSlot(node);
+        return levels[slot.level].dirty[slot.position] != Level::placed;
+    }
+
+    size_t TransformHierarchy::updateRange(size_t levelIndex, size_t begin, size_t end) {
+        auto &level = levels[levelIndex];
+        const Level *parent = levelIndex > 0 ? &levels[levelIndex - 1] : nullptr;
+
+        /// A node changes when its own transform did or its parent changed earlier in this update, levels are visited
+        /// top down so the parents are always decided first
+        size_t changed = 0;
+        size_t placed = 0;
+        for (size_t i = begin; i < end; i++) {
+            const bool change = level.dirty[i] || (parent && parent->changed[level.parents[i]]);
+            /// The previous matrices trail the world matrices by one update, nodes that stopped changing catch up
+            if (change || level.changed[i])
+                level.previous[i] = level.world[i];
+            level.changed[i] = change;
+            if (level.dirty[i] == Level::placed)
+                placed++;
+            else
+                level.dirty[i] = Level::clean;
+            changed += change;
+        }
+        if (changed == 0)
+            return 0;
+
+        for (size_t block = begin; block < end; block += lanes) {
+            const size_t blockSize = std::min(lanes, end - block);
+            const auto first = level.changed.begin() + static_cast<ptrdiff_t>(block);
+            if (std::any_of(first, first + static_cast<ptrdiff_t>(blockSize), [](uint8_t change) {
+                return change != 0;
+            }))
+                compose(levelIndex, block, blockSize);
+        }
+
+        /// Placed nodes have nothing to blend from, they start out at rest
+        for (size_t i = begin; placed > 0 && i < end; i++) {
+            if (level.dirty[i] == Level::placed) {
+                level.previous[i] = level.world[i];
+                level.dirty[i] = Level::clean;
+                placed--;
+            }
+        }
+        return changed;
+    }
+
+    size_t TransformHierarchy::update(JobSystem *jobSystem) {
+        /// Large enough for a job to outweigh scheduling it, and a multiple of every width of lanes
+        static constexpr size_t grain = 4096;
+
+        size_t updated = 0;
+        for (size_t level = 0; level < levels.size(); level++) {
+            const size_t count = levels[level].size();
+            if (!jobSystem || count <= grain) {
+                updated += updateRange(level, 0, count);
+                continue;
+            }
+
+            std::atomic<size_t> changed = 0;
+            jobSystem->parallelFor("Transform update", count, grain, [this, level, &changed](size_t begin, size_t end) {
+                changed += updateRange(level, begin, end);
+            });
+            updated += changed;
+        }
+        return updated;
+    }
+
+    size_t TransformHierarchy::getSize() const {
+        return size;
+    }
+
+    size_t TransformHierarchy::getDepth() const {
+        return levels.size();
+    }
+}
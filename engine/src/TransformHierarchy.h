@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Vixen {
+    class JobSystem;
+
+    /**
+     * A handle to a node of a transform hierarchy
+     */
+    struct TransformNode {
+        uint32_t index = 0;
+
+        /// Live nodes never have generation zero, so a default constructed handle stands for no parent
+        uint32_t generation = 0;
+
+        bool operator==(const TransformNode &) const = default;
+    };
+
+    /**
+     * Parent and child transforms, stored as local translation, rotation and scale and composed into world matrices.
+     * Nodes are grouped into levels by their depth and every level keeps each component of the local transforms in an
+     * array of its own, so the local matrices of 4 nodes, or 8 when the engine is built with AVX, are composed at once.
+     * Levels are updated in order, parents before their children, and only nodes whose local transform changed or
+     * whose parent was updated are composed again.
+     *
+     * The world matrices of the update before the last are kept as well. When updates run at a fixed tick rate,
+     * rendering blends between the two so motion stays smooth at any frame rate.
+     */
+    class TransformHierarchy {
+    public:
+        using Node = TransformNode;
+
+        /**
+         * The amount of nodes composed at once
+         */
+        static const size_t lanes;
+
+    private:
+        static constexpr uint32_t none = UINT32_MAX;
+
+        struct Slot {
+            uint32_t generation = 1;
+
+            bool alive = false;
+
+            uint32_t level = 0;
+
+            uint32_t position = 0;
+
+            uint32_t parent = none;
+
+            uint32_t firstChild = none;
+
+            uint32_t nextSibling = none;
+
+            uint32_t previousSibling = none;
+        };
+
+        struct Local {
+            glm::vec3 position;
+
+            glm::quat rotation;
+
+            glm::vec3 scale;
+        };
+
+        struct Level {
+            /// The states of dirty, a placed node was just added to the level and has no world matrix yet
+            static constexpr uint8_t clean = 0, moved = 1, placed = 2;
+
+            std::vector<float> positionX, positionY, positionZ;
+
+            std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+
+            std::vector<float> scaleX, scaleY, scaleZ;
+
+            std::vector<uint32_t> slots;
+
+            /// The position of every node's parent in the level above
+            std::vector<uint32_t> parents;
+
+            /// Whether the local transform changed since the last update
+            std::vector<uint8_t> dirty;
+
+            /// Whether the world matrix was composed by the last update
+            std::vector<uint8_t> changed;
+
+            std::vector<glm::mat4> world;
+
+            /// The world matrix as of the update before the last
+            std::vector<glm::mat4> previous;
+
+            [[nodiscard]] size_t size() const;
+
+            void push(uint32_t slot, uint32_t parent, const Local &local);
+
+            /**
+             * Moves the last node into a position
+             */
+            void moveLast(size_t position);
+
+            void pop();
+
+            [[nodiscard]] Local getLocal(size_t position) const;
+
+            void setLocal(size_t position, const Local &local);
+
+            /**
+             * Marks a node as moved unless it was just placed
+             */
+            void touch(size_t position);
+
+            template<typename F>
+            void eachArray(F &&function) {
+                function(positionX), function(positionY), function(positionZ);
+                function(rotationX), function(rotationY), function(rotationZ), function(rotationW);
+                function(scaleX), function(scaleY), function(scaleZ);
+                function(slots), function(parents), function(dirty), function(changed);
+                function(world), function(previous);
+            }
+        };
+
+        std::vector<Slot> slots;
+
+        std::vector<uint32_t> freeSlots;
+
+        std::vector<Level> levels;
+
+        size_t size = 0;
+
+        [[nodiscard]] const Slot &getSlot(Node node) const;
+
+        /**
+         * Adds a node to the end of a level, growing the hierarchy by a level when needed
+         */
+        void insert(uint32_t slot, uint32_t level, const Local &local);
+
+        /**
+         * Removes a node from its level, the slot keeps its links
+         */
+        void erase(uint32_t slot);
+
+        /**
+         * Drops the empty levels at the bottom of the hierarchy
+         */
+        void trim();
+
+        void link(uint32_t slot, uint32_t parent);
+
+        void unlink(uint32_t slot);
+
+        /**
+         * The slots of a node and all of its descendants, parents before children
+         */
+        [[nodiscard]] std::vector<uint32_t> collectSubtree(uint32_t slot) const;
+
+        /**
+         * Composes the world matrices of the changed nodes in a range of a level, the range holds at most one block of
+         * lanes
+         */
+        void compose(size_t level, size_t begin, size_t count);
+
+        /**
+         * Decides which nodes of a range of a level changed and composes their world matrices, the range starts at a
+         * block of lanes
+         *
+         * @return The amount of nodes that changed
+         */
+        size_t updateRange(size_t level, size_t begin, size_t end);
+
+    public:
+        TransformHierarchy() = default;
+
+        TransformHierarchy(const TransformHierarchy &) = delete;
+
+        TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+        /**
+         * @param[in] parent The node to attach to, a default constructed node makes a root
+         */
+        Node create(const glm::vec3 &position = {}, const glm::quat &rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                    const glm::vec3 &scale = glm::vec3(1.0f), Node parent = {});
+
+        /**
+         * Destroys a node together with all of its descendants
+         */
+        void destroy(Node node);
+
+        [[nodiscard]] bool isAlive(Node node) const;
+
+        /**
+         * Attaches a node and its descendants to another parent, keeping their local transforms
+         *
+         * @param[in] parent The new parent, a default constructed node makes it a root
+         */
+        void setParent(Node node, Node parent);
+
+        [[nodiscard]] Node getParent(Node node) const;
+
+        void setLocal(Node node, const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale);
+
+        void setPosition(Node node, const glm::vec3 &position);
+
+        /**
+         * @param[in] rotation Normalized before it is stored
+         */
+        void setRotation(Node node, const glm::quat &rotation);
+
+        void setScale(Node node, const glm::vec3 &scale);
+
+        [[nodiscard]] glm::vec3 getPosition(Node node) const;
+
+        [[nodiscard]] glm::quat getRotation(Node node) const;
+
+        [[nodiscard]] glm::vec3 getScale(Node node) const;
+
+        /**
+         * The world matrix as of the last update
+         */
+        [[nodiscard]] const glm::mat4 &getWorldMatrix(Node node) const;
+
+        /**
+         * The world matrix blended between the update before the last and the last update. Translation and scale are
+         * blended linearly and rotation spherically, so rotating nodes keep their size.
+         *
+         * @param[in] alpha Zero for the update before the last, one for the last update
+         */
+        [[nodiscard]] glm::mat4 getInterpolatedMatrix(Node node, float alpha) const;
+
+        /**
+         * Whether the node has a world matrix, nodes only get one from the first update after they were created
+         */
+        [[nodiscard]] bool isComposed(Node node) const;
+
+        /**
+         * Composes the world matrix of every node that changed since the last update and of all of their descendants
+         *
+         * @param[in] jobSystem Splits large levels into jobs when given, levels are still updated one after another
+         * @return The amount of nodes that were updated
+         */
+        size_t update(JobSystem *jobSystem = nullptr);
+
+        /**
+         * The amount of live nodes
+         */
+        [[nodiscard]] size_t getSize() const;
+
+        /**
+         * The depth of the deepest node plus one
+         */
+        [[nodiscard]] size_t getDepth() const;
+    };
+}
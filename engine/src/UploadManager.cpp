@@ -0,0 +1,328 @@
+#include "UploadManager.h"
+
+namespace Vixen {
+    UploadManager::UploadManager(const std::shared_ptr<LogicalDevice> &device, VkDeviceSize stagingCapacity)
+            : device(device), ownershipTransfer(device->getQueueFamilyIndex(QueueType::TRANSFER) !=
+                                                device->getQueueFamilyIndex(QueueType::GRAPHICS)),
+              ring(device, stagingCapacity) {
+        if (ownershipTransfer)
+            logger.trace("Uploads run on a dedicated transfer queue family");
+    }
+
+    UploadManager::~UploadManager() {
+        if (pending.has_value())
+            flush();
+        for (auto &batch : inFlight)
+            (batch.acquire ? batch.acquire : batch.transfer)->wait();
+        inFlight.clear();
+    }
+
+    void *UploadManager::stage(const Buffer &destination, VkDeviceSize size, VkDeviceSize offset) {
+        /// Host writes are visible to every submission made after them, so there is nothing to record
+        if (destination.getMapped() && (destination.getMemoryFlags() & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) &&
+            size <= directUploadLimit)
+            return static_cast<char *>(destination.getMapped()) + offset;
+
+        const auto staging = allocateStaging(size);
+        auto &batch = begin();
+
+        VkBufferCopy region{};
+        region.srcOffset = staging.offset;
+        region.dstOffset = offset;
+        region.size = size;
+        batch.transfer->cmdCopyBuffer(staging.buffer, destination.getBuffer(), {region});
+
+        /// Concurrently shared buffers keep their contents without an ownership transfer, they only need the memory
+        /// dependency recorded by the flush
+        if (destination.isConcurrent())
+            batch.concurrentWrites = true;
+        else if (std::find(batch.buffers.begin(), batch.buffers.end(), destination.getBuffer()) == batch.buffers.end())
+            batch.buffers.push_back(destination.getBuffer());
+        return staging.data;
+    }
+
+    void *UploadManager::stage(Image &destination, VkDeviceSize size) {
+        return stage(destination, size, {0});
+    }
+
+    void *UploadManager::stage(Image &destination, VkDeviceSize size, const std::vector<VkDeviceSize> &levelOffsets) {
+        if (levelOffsets.empty() || (levelOffsets.size() > 1 && levelOffsets.size() != destination.getMipLevels()))
+            throw std::runtime_error("Either one or every mip level of an image must be uploaded");
+
+        const auto staging = allocateStaging(size);
+        auto &batch = begin();
+        const PendingImage image{destination.getImage(), destination.getWidth(), destination.getHeight(),
+                                 destination.getMipLevels(),
+                                 levelOffsets.size() == 1 && destination.getMipLevels() > 1};
+
+        VkImageMemoryBarrier barrier = imageBarrier(image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+        std::vector<VkBufferImageCopy> regions(levelOffsets.size());
+        for (uint32_t level = 0; level < regions.size(); level++) {
+            auto &region = regions[level];
+            region.bufferOffset = staging.offset + levelOffsets[level];
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = {0, 0, 0};
+            region.imageExtent = {std::max(image.width >> level, 1u), std::max(image.height >> level, 1u), 1};
+        }
+
+        batch.transfer->cmdPipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {},
+                                           {barrier})
+                .cmdCopyBufferToImage(staging.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions);
+        batch.images.push_back(image);
+
+        destination.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        return staging.data;
+    }
+
+    void UploadManager::upload(const Buffer &destination, const void *data, VkDeviceSize size, VkDeviceSize offset) {
+        memcpy(stage(destination, size, offset), data, size);
+    }
+
+    void UploadManager::upload(Image &destination, const void *data, VkDeviceSize size) {
+        memcpy(stage(destination, size), data, size);
+    }
+
+    uint64_t UploadManager::flush() {
+        if (!pending.has_value())
+            return nextTicket - 1;
+
+        auto &batch = *pending;
+        for (auto &staging : batch.staging)
+            staging.unmap();
+
+        /// Transfer reads cover geometry copied around the arena when defragmenting
+        const VkAccessFlags consumerAccess = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                             VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        if (ownershipTransfer) {
+            /// Images that need mip levels generated stay in the transfer layout, the blits run on the graphics queue
+            std::vector<VkImageMemoryBarrier> barriers;
+            barriers.reserve(batch.images.size());
+            for (const auto &image : batch.images) {
+                auto &barrier = barriers.emplace_back(imageBarrier(
+                        image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        image.generateMips ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                            : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+                barrier.srcQueueFamilyIndex = device->getQueueFamilyIndex(QueueType::TRANSFER);
+                barrier.dstQueueFamilyIndex = device->getQueueFamilyIndex(QueueType::GRAPHICS);
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = 0;
+            }
+
+            if (!batch.buffers.empty())
+                batch.transfer->cmdReleaseBuffers(batch.buffers, QueueType::GRAPHICS, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                  VK_ACCESS_TRANSFER_WRITE_BIT);
+            if (!barriers.empty())
+                batch.transfer->cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, {}, {}, barriers);
+
+            batch.semaphore = std::make_unique<Semaphore>(device);
+            batch.transfer->submit({}, {batch.semaphore->getSemaphore()}, {});
+
+            for (auto &barrier : barriers) {
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = barrier.newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                        ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+                                        : VK_ACCESS_SHADER_READ_BIT;
+            }
+
+            batch.acquire = std::make_unique<CommandBuffer>(device, QueueType::GRAPHICS);
+            batch.acquire->recordSingleUsage();
+            if (!batch.buffers.empty())
+                batch.acquire->cmdAcquireBuffers(batch.buffers, QueueType::TRANSFER, consumerStages, consumerAccess);
+            /// Chained to the semaphore wait so the writes to concurrent buffers are visible to later submissions
+            std::vector<VkMemoryBarrier> memoryBarriers;
+            if (batch.concurrentWrites) {
+                auto &barrier = memoryBarriers.emplace_back();
+                barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                barrier.srcAccessMask = 0;
+                barrier.dstAccessMask = consumerAccess;
+            }
+            if (!barriers.empty() || !memoryBarriers.empty())
+                batch.acquire->cmdPipelineBarrier(consumerStages, consumerStages, 0, memoryBarriers, {}, barriers);
+            for (const auto &image : batch.images)
+                if (image.generateMips)
+                    recordMipChain(*batch.acquire, image);
+            batch.acquire->submit({batch.semaphore->getSemaphore()}, {}, {consumerStages});
+        } else {
+            /// Both queues are the same, so the mip chains and a barrier can go in the same command buffer as the copies
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = consumerAccess;
+
+            std::vector<VkImageMemoryBarrier> barriers;
+            for (const auto &image : batch.images) {
+                if (image.generateMips) {
+                    recordMipChain(*batch.transfer, image);
+                    continue;
+                }
+
+                auto &transition = barriers.emplace_back(imageBarrier(
+                        image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
+                transition.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                transition.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            }
+
+            batch.transfer->cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, consumerStages, 0, {barrier}, {},
+                                               barriers);
+            batch.transfer->submit();
+        }
+
+        const uint64_t ticket = batch.ticket;
+        ring.retire(ticket);
+        logger.trace("Submitted upload batch {}, {} bytes of the staging ring in use", ticket, ring.getUsed());
+        inFlight.push_back(std::move(batch));
+        pending.reset();
+        return ticket;
+    }
+
+    void UploadManager::poll() {
+        while (!inFlight.empty()) {
+            auto &batch = inFlight.front();
+            if (!(batch.acquire ? batch.acquire : batch.transfer)->isComplete())
+                break;
+
+            completedTicket = batch.ticket;
+            inFlight.pop_front();
+        }
+        ring.reclaim(completedTicket);
+    }
+
+    bool UploadManager::isComplete(uint64_t ticket) {
+        poll();
+        return ticket <= completedTicket;
+    }
+
+    void UploadManager::wait(uint64_t ticket) {
+        if (pending.has_value() && pending->ticket <= ticket)
+            flush();
+
+        for (auto &batch : inFlight) {
+            if (batch.ticket > ticket)
+                break;
+            (batch.acquire ? batch.acquire : batch.transfer)->wait();
+        }
+        poll();
+    }
+
+    bool UploadManager::supportsMipGeneration(VkFormat format) const {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(device->physicalDevice->device, format, &properties);
+
+        const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                              VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (properties.optimalTilingFeatures & required) == required;
+    }
+
+    std::shared_ptr<LogicalDevice> UploadManager::getDevice() const {
+        return device;
+    }
+
+    UploadManager::Batch &UploadManager::begin() {
+        if (!pending.has_value()) {
+            pending.emplace(Batch{nextTicket++, std::make_unique<CommandBuffer>(device, QueueType::TRANSFER)});
+            pending->transfer->recordSingleUsage();
+        }
+        return *pending;
+    }
+
+    UploadManager::Staging UploadManager::allocateStaging(VkDeviceSize size) {
+        if (size > ring.getCapacity()) {
+            logger.warning("Upload of {} bytes exceeds the staging ring, using a dedicated staging buffer", size);
+            auto &staging = begin().staging.emplace_back(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                         VMA_MEMORY_USAGE_CPU_ONLY);
+            return {staging.getBuffer(), 0, staging.map()};
+        }
+
+        while (true) {
+            poll();
+            if (const auto offset = ring.allocate(size, stagingAlignment); offset.has_value())
+                return {ring.getBuffer(), offset.value(), ring.getData() + offset.value()};
+
+            /// The ring is full, submit what is pending and wait for the oldest batch to free its staging memory
+            if (pending.has_value())
+                flush();
+            else if (!inFlight.empty())
+                wait(inFlight.front().ticket);
+        }
+    }
+
+    VkImageMemoryBarrier UploadManager::imageBarrier(const PendingImage &image, VkImageLayout oldLayout,
+                                                     VkImageLayout newLayout) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = image.mipLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+        return barrier;
+    }
+
+    void UploadManager::recordMipChain(CommandBuffer &commandBuffer, const PendingImage &image) {
+        VkImageMemoryBarrier barrier = imageBarrier(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+        barrier.subresourceRange.levelCount = 1;
+
+        auto width = static_cast<int32_t>(image.width);
+        auto height = static_cast<int32_t>(image.height);
+        for (uint32_t level = 1; level < image.mipLevels; level++) {
+            /// Wait for the previous level to be written before reading from it
+            barrier.subresourceRange.baseMipLevel = level - 1;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, {},
+                                             {barrier});
+
+            VkImageBlit blit{};
+            blit.srcOffsets[0] = {0, 0, 0};
+            blit.srcOffsets[1] = {width, height, 1};
+            blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.srcSubresource.mipLevel = level - 1;
+            blit.srcSubresource.baseArrayLayer = 0;
+            blit.srcSubresource.layerCount = 1;
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+            blit.dstOffsets[0] = {0, 0, 0};
+            blit.dstOffsets[1] = {width, height, 1};
+            blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blit.dstSubresource.mipLevel = level;
+            blit.dstSubresource.baseArrayLayer = 0;
+            blit.dstSubresource.layerCount = 1;
+            commandBuffer.cmdBlitImage(image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.image,
+                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, {blit}, VK_FILTER_LINEAR);
+
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                                             {}, {}, {barrier});
+        }
+
+        /// The last level is only ever written to
+        barrier.subresourceRange.baseMipLevel = image.mipLevels - 1;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        commandBuffer.cmdPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, {},
+                                         {}, {barrier});
+    }
+}
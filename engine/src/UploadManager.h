@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "LogicalDevice.h"
+#include "Buffer.h"
+#include "CommandBuffer.h"
+#include "Image.h"
+#include "Semaphore.h"
+#include "StagingRing.h"
+
+namespace Vixen {
+    /**
+     * Batches buffer and image uploads into a single submission on the transfer queue. When the transfer queue belongs
+     * to a different family than the graphics queue, ownership of every destination is released on the transfer queue
+     * and acquired by a small graphics submission that waits on the transfer through a semaphore. Completion is tracked
+     * with polled fences, so loading never blocks the thread that records frames.
+     */
+    class UploadManager {
+        const Logger logger{"UploadManager"};
+
+        struct PendingImage {
+            VkImage image;
+
+            uint32_t width;
+
+            uint32_t height;
+
+            uint32_t mipLevels;
+
+            /// Whether only level 0 was uploaded and the remaining levels are blitted from it
+            bool generateMips;
+        };
+
+        struct Batch {
+            uint64_t ticket;
+
+            std::unique_ptr<CommandBuffer> transfer;
+
+            /// Only used when ownership has to move to the graphics queue family
+            std::unique_ptr<CommandBuffer> acquire;
+
+            std::unique_ptr<Semaphore> semaphore;
+
+            /// Dedicated staging buffers for uploads that do not fit in the staging ring
+            std::vector<Buffer> staging;
+
+            /// Exclusively owned destinations, which have their ownership transferred to the graphics queue family
+            std::vector<VkBuffer> buffers;
+
+            /// Whether any destination is shared concurrently between the queue families
+            bool concurrentWrites = false;
+
+            std::vector<PendingImage> images;
+        };
+
+        const std::shared_ptr<LogicalDevice> device;
+
+        /**
+         * Whether the transfer queue is in another family than the graphics queue
+         */
+        const bool ownershipTransfer;
+
+        StagingRing ring;
+
+        std::optional<Batch> pending;
+
+        std::deque<Batch> inFlight;
+
+        uint64_t nextTicket = 1;
+
+        uint64_t completedTicket = 0;
+
+        struct Staging {
+            VkBuffer buffer;
+            VkDeviceSize offset;
+            void *data;
+        };
+
+        Batch &begin();
+
+        /**
+         * Allocates staging memory from the ring, flushing and waiting for earlier batches when it is full
+         */
+        Staging allocateStaging(VkDeviceSize size);
+
+        /**
+         * A barrier covering every mip level of an uploaded image
+         */
+        static VkImageMemoryBarrier imageBarrier(const PendingImage &image, VkImageLayout oldLayout,
+                                                 VkImageLayout newLayout);
+
+        /**
+         * Blits every mip level from the one above it. Level 0 must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, every
+         * level ends up in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL. The command buffer must be on a graphics queue.
+         */
+        static void recordMipChain(CommandBuffer &commandBuffer, const PendingImage &image);
+
+    public:
+        /**
+         * The pipeline stages that consume uploaded resources on the graphics queue
+         */
+        static constexpr VkPipelineStageFlags consumerStages =
+                VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        /**
+         * Staging allocations are aligned to this, which satisfies the buffer offset requirements of every format
+         */
+        static constexpr VkDeviceSize stagingAlignment = 16;
+
+        /**
+         * Buffer uploads up to this size are written straight into host visible destinations, larger ones still go
+         * through a copy on the transfer queue which does not stall the host on slow writes over the bus
+         */
+        static constexpr VkDeviceSize directUploadLimit = 256 * 1024;
+
+        /**
+         * @param[in] device The device to upload to
+         * @param[in] stagingCapacity The size of the persistently mapped staging ring, larger uploads fall back to a
+         * dedicated staging buffer
+         */
+        explicit UploadManager(const std::shared_ptr<LogicalDevice> &device,
+                               VkDeviceSize stagingCapacity = 64 * 1024 * 1024);
+
+        UploadManager(const UploadManager &) = delete;
+
+        UploadManager &operator=(const UploadManager &) = delete;
+
+        ~UploadManager();
+
+        /**
+         * Reserves staging memory for a copy into a region of a buffer, write the data straight into the returned pointer
+         * before the next flush. The destination must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT. Small
+         * uploads into host visible and coherent destinations return a pointer into the destination itself, the region
+         * must not be in use by the GPU.
+         */
+        void *stage(const Buffer &destination, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        /**
+         * Reserves staging memory for the first mip level of an image, write the data straight into the returned
+         * pointer before the next flush. The remaining mip levels are generated by blitting, the image ends up in
+         * VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+         */
+        void *stage(Image &destination, VkDeviceSize size);
+
+        /**
+         * Reserves staging memory for pre-built mip levels of an image, write the data straight into the returned
+         * pointer before the next flush. The image ends up in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+         *
+         * @param[in] levelOffsets The offset of every level's data within the staging memory, starting at level 0. A
+         * single level makes the remaining levels get generated. Offsets must be aligned to the format's block size.
+         */
+        void *stage(Image &destination, VkDeviceSize size, const std::vector<VkDeviceSize> &levelOffsets);
+
+        void upload(const Buffer &destination, const void *data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        void upload(Image &destination, const void *data, VkDeviceSize size);
+
+        /**
+         * Submits every upload recorded since the last flush. Graphics work submitted afterwards is ordered after the
+         * uploads, so the destinations may be used right away without waiting on the host.
+         *
+         * @return The ticket of the submitted batch, or the last ticket when nothing was pending
+         */
+        uint64_t flush();
+
+        /**
+         * Releases the staging memory of every batch the GPU has finished, call this regularly
+         */
+        void poll();
+
+        [[nodiscard]] bool isComplete(uint64_t ticket);
+
+        /**
+         * Blocks until a batch has finished, prefer polling with isComplete
+         */
+        void wait(uint64_t ticket);
+
+        /**
+         * Whether mip levels of a format can be generated by linear blits
+         */
+        [[nodiscard]] bool supportsMipGeneration(VkFormat format) const;
+
+        [[nodiscard]] std::shared_ptr<LogicalDevice> getDevice() const;
+    };
+}
@@ -0,0 +1,204 @@
+#include "VertexLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/packing.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace Vixen {
+    namespace {
+        struct Bounds {
+            glm::vec3 center;
+            glm::vec3 extent;
+
+            Bounds(const glm::vec3 &minimum, const glm::vec3 &maximum)
+                    : center((minimum + maximum) / 2.0f), extent((maximum - minimum) / 2.0f) {}
+
+            /// Flat axes have no extent and quantize to zero, which maps back onto the center
+            [[nodiscard]] glm::vec4 quantize(const glm::vec3 &vertex) const {
+                glm::vec4 quantized{};
+                for (glm::length_t i = 0; i < 3; i++)
+                    quantized[i] = extent[i] > 0.0f ? glm::clamp((vertex[i] - center[i]) / extent[i], -1.0f, 1.0f)
+                                                    : 0.0f;
+                return quantized;
+            }
+        };
+
+        template<glm::length_t L>
+        float largestError(const glm::vec<L, float> &a, const glm::vec<L, float> &b) {
+            float error = 0.0f;
+            for (glm::length_t i = 0; i < L; i++)
+                error = std::max(error, std::abs(a[i] - b[i]));
+            return error;
+        }
+
+        uint32_t positionSize(VertexLayout::Position position) {
+            return position == VertexLayout::Position::FLOAT ? sizeof(glm::vec3) : sizeof(uint64_t);
+        }
+
+        uint32_t uvSize(VertexLayout::Uv uv) {
+            return uv == VertexLayout::Uv::FLOAT ? sizeof(glm::vec2) : sizeof(uint32_t);
+        }
+
+        uint32_t colorSize(VertexLayout::Color color) {
+            return color == VertexLayout::Color::FLOAT ? sizeof(glm::vec4) : sizeof(uint32_t);
+        }
+
+        glm::vec2 encodeOctahedral(const glm::vec3 &normal) {
+            const float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+            if (sum == 0.0f)
+                return {};
+
+            const glm::vec3 n = normal / sum;
+            if (n.z >= 0.0f)
+                return {n.x, n.y};
+            return {(1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                    (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)};
+        }
+    }
+
+    VertexLayout VertexLayout::choose(const std::vector<glm::vec3> &vertices, const std::vector<glm::vec2> &uvs,
+                                      const std::vector<glm::vec4> &colors, const glm::vec3 &minimum,
+                                      const glm::vec3 &maximum, const Precision &precision) {
+        const Bounds bounds(minimum, maximum);
+        const float positionTolerance = precision.position * glm::length(maximum - minimum);
+        float halfError = 0.0f;
+        float snormError = 0.0f;
+        for (const auto &vertex : vertices) {
+            const glm::vec3 half(glm::unpackHalf4x16(glm::packHalf4x16(glm::vec4(vertex, 0.0f))));
+            const glm::vec3 snorm(glm::unpackSnorm4x16(glm::packSnorm4x16(bounds.quantize(vertex))));
+            halfError = std::max(halfError, largestError(half, vertex));
+            snormError = std::max(snormError, largestError(bounds.center + snorm * bounds.extent, vertex));
+        }
+
+        float uvError = 0.0f;
+        for (const auto &uv : uvs)
+            uvError = std::max(uvError, largestError(glm::unpackHalf2x16(glm::packHalf2x16(uv)), uv));
+
+        bool normalizedColors = true;
+        for (const auto &color : colors)
+            normalizedColors &= glm::all(glm::greaterThanEqual(color, glm::vec4(0.0f))) &&
+                                glm::all(glm::lessThanEqual(color, glm::vec4(1.0f)));
+
+        VertexLayout layout;
+        /// Both quantized encodings take the same space, so the more accurate one wins
+        if (std::min(halfError, snormError) <= positionTolerance)
+            layout.position = halfError < snormError ? Position::HALF : Position::SNORM16;
+        layout.uv = uvError <= precision.uv ? Uv::HALF : Uv::FLOAT;
+        layout.color = normalizedColors ? Color::UNORM8 : Color::FLOAT;
+        return layout;
+    }
+
+    uint32_t VertexLayout::getStride() const {
+        return getNormalOffset() + sizeof(uint32_t);
+    }
+
+    uint32_t VertexLayout::getUvOffset() const {
+        return positionSize(position);
+    }
+
+    uint32_t VertexLayout::getColorOffset() const {
+        return getUvOffset() + uvSize(uv);
+    }
+
+    uint32_t VertexLayout::getNormalOffset() const {
+        return getColorOffset() + colorSize(color);
+    }
+
+    VkVertexInputBindingDescription VertexLayout::getBinding(uint32_t binding) const {
+        VkVertexInputBindingDescription description{};
+        description.binding = binding;
+        description.stride = getStride();
+        description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return description;
+    }
+
+    std::vector<VkVertexInputAttributeDescription> VertexLayout::getAttributes(uint32_t binding) const {
+        VkFormat positionFormat = VK_FORMAT_R32G32B32_SFLOAT;
+        if (position == Position::HALF)
+            positionFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
+        else if (position == Position::SNORM16)
+            positionFormat = VK_FORMAT_R16G16B16A16_SNORM;
+
+        return {
+                {positionLocation, binding, positionFormat, 0},
+                {uvLocation, binding, uv == Uv::HALF ? VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R32G32_SFLOAT,
+                 getUvOffset()},
+                {colorLocation, binding,
+                 color == Color::UNORM8 ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R32G32B32A32_SFLOAT, getColorOffset()},
+                {normalLocation, binding, VK_FORMAT_R16G16_SNORM, getNormalOffset()}
+        };
+    }
+
+    glm::mat4 VertexLayout::getDequantization(const glm::vec3 &minimum, const glm::vec3 &maximum) const {
+        if (position != Position::SNORM16)
+            return glm::mat4(1.0f);
+
+        const Bounds bounds(minimum, maximum);
+        return glm::scale(glm::translate(glm::mat4(1.0f), bounds.center), bounds.extent);
+    }
+
+    void VertexLayout::pack(void *destination, const std::vector<glm::vec3> &vertices,
+                            const std::vector<glm::vec2> &uvs, const std::vector<glm::vec4> &colors,
+                            const std::vector<glm::vec3> &normals, const glm::vec3 &minimum,
+                            const glm::vec3 &maximum) const {
+        if (vertices.size() != uvs.size())
+            throw std::runtime_error("Vertex count must be equal to UV count");
+        if (vertices.size() != colors.size())
+            throw std::runtime_error("Vertex count must be equal to color count");
+        if (vertices.size() != normals.size())
+            throw std::runtime_error("Vertex count must be equal to normal count");
+
+        const Bounds bounds(minimum, maximum);
+        const uint32_t stride = getStride();
+        const uint32_t uvOffset = getUvOffset();
+        const uint32_t colorOffset = getColorOffset();
+        const uint32_t normalOffset = getNormalOffset();
+        auto vertex = static_cast<uint8_t *>(destination);
+        for (size_t i = 0; i < vertices.size(); i++, vertex += stride) {
+            if (position == Position::FLOAT) {
+                memcpy(vertex, &vertices[i], sizeof(glm::vec3));
+            } else {
+                const uint64_t packed = position == Position::HALF
+                                        ? glm::packHalf4x16(glm::vec4(vertices[i], 0.0f))
+                                        : glm::packSnorm4x16(bounds.quantize(vertices[i]));
+                memcpy(vertex, &packed, sizeof(packed));
+            }
+
+            if (uv == Uv::FLOAT) {
+                memcpy(vertex + uvOffset, &uvs[i], sizeof(glm::vec2));
+            } else {
+                const uint32_t packed = glm::packHalf2x16(uvs[i]);
+                memcpy(vertex + uvOffset, &packed, sizeof(packed));
+            }
+
+            if (color == Color::FLOAT) {
+                memcpy(vertex + colorOffset, &colors[i], sizeof(glm::vec4));
+            } else {
+                const uint32_t packed = glm::packUnorm4x8(colors[i]);
+                memcpy(vertex + colorOffset, &packed, sizeof(packed));
+            }
+
+            const uint32_t normal = glm::packSnorm2x16(encodeOctahedral(normals[i]));
+            memcpy(vertex + normalOffset, &normal, sizeof(normal));
+        }
+    }
+
+    uint32_t VertexLayout::encode() const {
+        return static_cast<uint32_t>(position) | static_cast<uint32_t>(uv) << 8 |
+               static_cast<uint32_t>(color) << 16;
+    }
+
+    VertexLayout VertexLayout::decode(uint32_t code) {
+        const uint32_t position = code & 0xFF;
+        const uint32_t uv = code >> 8 & 0xFF;
+        const uint32_t color = code >> 16 & 0xFF;
+        if (position > static_cast<uint32_t>(Position::SNORM16) || uv > static_cast<uint32_t>(Uv::HALF) ||
+            color > static_cast<uint32_t>(Color::UNORM8) || code >> 24 != 0)
+            throw std::runtime_error("Unknown vertex layout");
+
+        return {static_cast<Position>(position), static_cast<Uv>(uv), static_cast<Color>(color)};
+    }
+}
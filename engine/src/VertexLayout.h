@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+namespace Vixen {
+    /**
+     * The layout of a mesh's vertices, every attribute interleaved in a single stream in the order position, uv, color
+     * and normal. Positions, uvs and colors are stored in the most compact encoding that keeps the mesh within the
+     * requested precision, normals are always octahedral encoded in two signed normalized 16 bit components.
+     *
+     * Positions quantized to 16 bit integers span the bounding box of the mesh, the vertex shaders map them back with
+     * the dequantization matrix.
+     */
+    struct VertexLayout {
+        enum class Position : uint8_t {
+            /// Three 32 bit floats
+            FLOAT,
+            /// Four 16 bit floats, the last one unused
+            HALF,
+            /// Four signed normalized 16 bit integers spanning the bounding box, the last one unused
+            SNORM16
+        };
+
+        enum class Uv : uint8_t {
+            FLOAT,
+            HALF
+        };
+
+        enum class Color : uint8_t {
+            FLOAT,
+            /// Only used when every component lies between 0 and 1
+            UNORM8
+        };
+
+        /**
+         * The largest error an encoding may introduce
+         */
+        struct Precision {
+            /// Relative to the diagonal of the bounding box
+            float position = 1.0f / 16384.0f;
+
+            /// In texture coordinates, a quarter texel of a 1024 texel wide texture
+            float uv = 1.0f / 4096.0f;
+        };
+
+        static constexpr uint32_t positionLocation = 0;
+
+        static constexpr uint32_t uvLocation = 1;
+
+        static constexpr uint32_t colorLocation = 2;
+
+        static constexpr uint32_t normalLocation = 3;
+
+        Position position = Position::FLOAT;
+
+        Uv uv = Uv::FLOAT;
+
+        Color color = Color::FLOAT;
+
+        /**
+         * Picks the most compact encoding of every attribute that stays within the precision
+         */
+        static VertexLayout choose(const std::vector<glm::vec3> &vertices, const std::vector<glm::vec2> &uvs,
+                                   const std::vector<glm::vec4> &colors, const glm::vec3 &minimum,
+                                   const glm::vec3 &maximum, const Precision &precision = {});
+
+        [[nodiscard]] uint32_t getStride() const;
+
+        [[nodiscard]] uint32_t getUvOffset() const;
+
+        [[nodiscard]] uint32_t getColorOffset() const;
+
+        [[nodiscard]] uint32_t getNormalOffset() const;
+
+        [[nodiscard]] VkVertexInputBindingDescription getBinding(uint32_t binding = 0) const;
+
+        [[nodiscard]] std::vector<VkVertexInputAttributeDescription> getAttributes(uint32_t binding = 0) const;
+
+        /**
+         * Maps the positions as fetched by the vertex shader back to model space
+         */
+        [[nodiscard]] glm::mat4 getDequantization(const glm::vec3 &minimum, const glm::vec3 &maximum) const;
+
+        /**
+         * Interleaves and encodes the vertex streams
+         *
+         * @param[out] destination getStride() * vertices.size() bytes
+         */
+        void pack(void *destination, const std::vector<glm::vec3> &vertices, const std::vector<glm::vec2> &uvs,
+                  const std::vector<glm::vec4> &colors, const std::vector<glm::vec3> &normals,
+                  const glm::vec3 &minimum, const glm::vec3 &maximum) const;
+
+        /**
+         * Packs the layout into an integer for storing it in files
+         */
+        [[nodiscard]] uint32_t encode() const;
+
+        /**
+         * @throws std::runtime_error When the code does not describe a layout
+         */
+        static VertexLayout decode(uint32_t code);
+
+        bool operator==(const VertexLayout &) const = default;
+    };
+}
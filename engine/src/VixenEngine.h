@@ -5,7 +5,11 @@
 #include "Mesh.h"
 #include "PhysicalDevice.h"
 #include "Render.h"
+#include "RenderThread.h"
 #include "ShaderModule.h"
 #include "Window.h"
 #include "Input.h"
-#include "MeshStore.h"
+#include "MainLoop.h"
+#include "FrameStatistics.h"
+#include "AssetManager.h"
+#include "Task.h"
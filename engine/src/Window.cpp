@@ -3,11 +3,20 @@
 #include "Window.h"
 
 namespace Vixen {
-    Window::Window(const std::string &name, const std::string &icon, GLFWmonitor *monitor, int width, int height) {
+    Window::Window(const std::string &name, const std::string &icon, GLFWmonitor *monitor, int width, int height,
+                   bool headless) {
         glfwSetErrorCallback([](int code, const char* message) {
             Logger{"GLFW"}.error("{} ({})", message, code);
         });
 
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+        /// The null platform creates surfaces through VK_EXT_headless_surface when it is available
+        glfwInitHint(GLFW_PLATFORM, headless ? GLFW_PLATFORM_NULL : GLFW_ANY_PLATFORM);
+#else
+        if (headless)
+            throw std::runtime_error("Headless windows need GLFW 3.4 or newer");
+#endif
+
         if (glfwInit() != GLFW_TRUE)
             logger.critical("Failed to initialize GLFW");
 
@@ -26,6 +35,21 @@ namespace Vixen {
             logger.critical("GLFW failed to create the window!");
         }
 
+        int currentWidth, currentHeight;
+        glfwGetFramebufferSize(window, &currentWidth, &currentHeight);
+        framebufferWidth = currentWidth;
+        framebufferHeight = currentHeight;
+        glfwSetWindowUserPointer(window, this);
+        glfwSetFramebufferSizeCallback(window, [](GLFWwindow *handle, int width, int height) {
+            auto &self = *static_cast<Window *>(glfwGetWindowUserPointer(handle));
+            self.framebufferWidth = width;
+            self.framebufferHeight = height;
+        });
+
+        /// There is no screen to place the window on and nobody to see its icon or move the mouse
+        if (headless)
+            return;
+
         /// Centralize the window on the screen
         const auto primary = glfwGetPrimaryMonitor();
         const auto mode = glfwGetVideoMode(primary);
@@ -55,6 +79,10 @@ namespace Vixen {
         return glfwWindowShouldClose(window) == GLFW_TRUE;
     }
 
+    VkExtent2D Window::getFramebufferSize() const {
+        return {framebufferWidth, framebufferHeight};
+    }
+
     void Window::update() {
         glfwPollEvents();
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vulkan/vulkan.h>
 
 #define GLFW_INCLUDE_NONE
@@ -12,6 +13,13 @@ namespace Vixen {
     class Window {
         Logger logger{"Window"};
 
+        /**
+         * The framebuffer size, updated while events are polled so threads other than the main thread can read it
+         */
+        std::atomic<uint32_t> framebufferWidth = 0;
+
+        std::atomic<uint32_t> framebufferHeight = 0;
+
     public:
         /**
          * The GLFW3 window instance
@@ -26,9 +34,11 @@ namespace Vixen {
          * @param[in] monitor The monitor the window should be fullscreen on or nullptr if fullscreen should not be enabled
          * @param[in] width The width of the window
          * @param[in] height The height of the window
+         * @param[in] headless Whether to create the window without a display, presenting then goes through
+         * VK_EXT_headless_surface. This needs GLFW 3.4 and is meant for benchmarks on machines without a screen.
          */
         explicit Window(const std::string &name, const std::string &icon,
-                        GLFWmonitor *monitor = nullptr, int width = 1280, int height = 720);
+                        GLFWmonitor *monitor = nullptr, int width = 1280, int height = 720, bool headless = false);
 
         Window(const Window &) = delete;
 
@@ -36,6 +46,12 @@ namespace Vixen {
 
         [[nodiscard]] bool shouldClose() const;
 
+        /**
+         * The size of the framebuffer as of the last time events were polled, zero while the window is minimized.
+         * Unlike GLFW this may be called from any thread.
+         */
+        [[nodiscard]] VkExtent2D getFramebufferSize() const;
+
         /**
          * Update the GLFW3 window, this polls GLFW3 events
          */
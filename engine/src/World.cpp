@@ -0,0 +1,266 @@
+#include "World.h"
+#include <mutex>
+
+namespace Vixen {
+    namespace {
+        struct ComponentRegistry {
+            std::mutex mutex;
+
+            std::unordered_map<std::type_index, ComponentId> ids;
+
+            std::vector<ComponentInfo> infos;
+        };
+
+        /// Kept in the engine library so every module agrees on the ids
+        ComponentRegistry &getRegistry() {
+            static ComponentRegistry registry;
+            return registry;
+        }
+    }
+
+    Archetype::Archetype(Mask mask, const std::vector<std::pair<ComponentId, ComponentInfo>> &components)
+            : mask(mask) {
+        columnIndices.fill(-1);
+        for (const auto &[component, info] : components) {
+            if (info.alignment > alignof(Chunk))
+                throw std::runtime_error("Component alignment exceeds the chunk alignment");
+            columns.push_back({component, info, 0});
+        }
+        /// Placing the most aligned arrays first keeps the padding between them small
+        std::stable_sort(columns.begin(), columns.end(), [](const Column &a, const Column &b) {
+            return a.info.alignment > b.info.alignment;
+        });
+        for (size_t i = 0; i < columns.size(); i++)
+            columnIndices[columns[i].component] = static_cast<int16_t>(i);
+
+        size_t rowSize = sizeof(Entity);
+        for (const auto &column : columns)
+            rowSize += column.info.size;
+
+        const auto layout = [this](size_t rows) {
+            size_t offset = rows * sizeof(Entity);
+            for (auto &column : columns) {
+                offset = (offset + column.info.alignment - 1) / column.info.alignment * column.info.alignment;
+                column.offset = offset;
+                offset += rows * column.info.size;
+            }
+            return offset;
+        };
+        capacity = chunkSize / rowSize;
+        while (capacity > 0 && layout(capacity) > chunkSize)
+            capacity--;
+        if (capacity == 0)
+            throw std::runtime_error("Components do not fit in a chunk");
+    }
+
+    Archetype::~Archetype() {
+        for (size_t row = 0; row < size; row++)
+            for (const auto &column : columns)
+                column.info.destroy(getComponent(row, column));
+    }
+
+    const Archetype::Mask &Archetype::getMask() const {
+        return mask;
+    }
+
+    bool Archetype::has(ComponentId component) const {
+        return component < maxComponents && mask.test(component);
+    }
+
+    size_t Archetype::getSize() const {
+        return size;
+    }
+
+    size_t Archetype::getCapacity() const {
+        return capacity;
+    }
+
+    size_t Archetype::getChunkCount() const {
+        return (size + capacity - 1) / capacity;
+    }
+
+    size_t Archetype::getChunkSize(size_t chunk) const {
+        return std::min(capacity, size - chunk * capacity);
+    }
+
+    void *Archetype::getColumn(size_t chunk, ComponentId component) const {
+        return chunks[chunk]->data.data() + columns[columnIndices[component]].offset;
+    }
+
+    Entity *Archetype::getEntities(size_t chunk) const {
+        return reinterpret_cast<Entity *>(chunks[chunk]->data.data());
+    }
+
+    size_t Archetype::allocate(Entity entity) {
+        /// Chunks are left uninitialized, components are constructed into them
+        if (size == chunks.size() * capacity)
+            chunks.push_back(std::unique_ptr<Chunk>(new Chunk));
+
+        const size_t row = size++;
+        getEntities(row / capacity)[row % capacity] = entity;
+        return row;
+    }
+
+    std::optional<Entity> Archetype::remove(size_t row) {
+        for (const auto &column : columns)
+            column.info.destroy(getComponent(row, column));
+
+        const size_t last = --size;
+        std::optional<Entity> moved;
+        if (row != last) {
+            for (const auto &column : columns) {
+                void *source = getComponent(last, column);
+                column.info.moveConstruct(getComponent(row, column), source);
+                column.info.destroy(source);
+            }
+            moved = getEntities(last / capacity)[last % capacity];
+            getEntities(row / capacity)[row % capacity] = *moved;
+        }
+
+        /// Keep one spare chunk so an entity moving back and forth at a chunk boundary does not allocate every time
+        while (chunks.size() > getChunkCount() + 1)
+            chunks.pop_back();
+        return moved;
+    }
+
+    void *Archetype::getComponent(size_t row, ComponentId component) const {
+        return getComponent(row, columns[columnIndices[component]]);
+    }
+
+    void *Archetype::getComponent(size_t row, const Column &column) const {
+        return chunks[row / capacity]->data.data() + column.offset + row % capacity * column.info.size;
+    }
+
+    ComponentId World::registerComponent(std::type_index type, const ComponentInfo &info) {
+        auto &registry = getRegistry();
+        std::scoped_lock lock(registry.mutex);
+        if (const auto existing = registry.ids.find(type); existing != registry.ids.end())
+            return existing->second;
+        if (registry.infos.size() == Archetype::maxComponents)
+            throw std::runtime_error("Too many component types");
+
+        const auto id = static_cast<ComponentId>(registry.infos.size());
+        registry.infos.push_back(info);
+        registry.ids.emplace(type, id);
+        return id;
+    }
+
+    ComponentInfo World::getComponentInfo(ComponentId component) {
+        auto &registry = getRegistry();
+        std::scoped_lock lock(registry.mutex);
+        return registry.infos[component];
+    }
+
+    Archetype &World::getArchetype(const Archetype::Mask &mask) {
+        if (const auto existing = archetypeMasks.find(mask); existing != archetypeMasks.end())
+            return *existing->second;
+
+        std::vector<std::pair<ComponentId, ComponentInfo>> components;
+        for (ComponentId component = 0; component < Archetype::maxComponents; component++)
+            if (mask.test(component))
+                components.emplace_back(component, getComponentInfo(component));
+
+        auto &archetype = *archetypes.emplace_back(std::make_unique<Archetype>(mask, components));
+        archetypeMasks.emplace(mask, &archetype);
+        return archetype;
+    }
+
+    Archetype &World::getNeighbour(Archetype &archetype, ComponentId component, bool add) {
+        auto &edges = add ? archetype.addEdges : archetype.removeEdges;
+        if (const auto edge = edges.find(component); edge != edges.end())
+            return *edge->second;
+
+        auto mask = archetype.getMask();
+        mask.set(component, add);
+        auto &neighbour = getArchetype(mask);
+        edges.emplace(component, &neighbour);
+        return neighbour;
+    }
+
+    World::Slot &World::getSlot(Entity entity) {
+        if (!isAlive(entity))
+            throw std::runtime_error("Entity is not alive");
+        return slots[entity.index];
+    }
+
+    const World::Slot &World::getSlot(Entity entity) const {
+        if (!isAlive(entity))
+            throw std::runtime_error("Entity is not alive");
+        return slots[entity.index];
+    }
+
+    Entity World::allocate(Archetype &archetype) {
+        uint32_t index;
+        if (freeSlots.empty()) {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        } else {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+
+        auto &slot = slots[index];
+        const Entity entity{index, slot.generation};
+        slot.archetype = &archetype;
+        slot.row = archetype.allocate(entity);
+        size++;
+        return entity;
+    }
+
+    void World::move(Entity entity, Archetype &target) {
+        auto &slot = slots[entity.index];
+        auto &source = *slot.archetype;
+        const size_t row = target.allocate(entity);
+        for (const auto &column : source.columns)
+            if (target.has(column.component))
+                column.info.moveConstruct(target.getComponent(row, column.component),
+                                          source.getComponent(slot.row, column));
+
+        if (const auto moved = source.remove(slot.row))
+            slots[moved->index].row = slot.row;
+        slot.archetype = &target;
+        slot.row = row;
+    }
+
+    void World::destroy(Entity entity) {
+        auto &slot = getSlot(entity);
+        if (const auto moved = slot.archetype->remove(slot.row))
+            slots[moved->index].row = slot.row;
+
+        slot.archetype = nullptr;
+        /// Generation zero is reserved for handles that were never alive
+        if (++slot.generation == 0)
+            slot.generation = 1;
+        freeSlots.push_back(entity.index);
+        size--;
+    }
+
+    void World::clear() {
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            auto &slot = slots[i];
+            if (!slot.archetype)
+                continue;
+
+            slot.archetype = nullptr;
+            if (++slot.generation == 0)
+                slot.generation = 1;
+            freeSlots.push_back(i);
+        }
+        archetypeMasks.clear();
+        archetypes.clear();
+        size = 0;
+    }
+
+    bool World::isAlive(Entity entity) const {
+        return entity.index < slots.size() && slots[entity.index].generation == entity.generation &&
+               slots[entity.index].archetype != nullptr;
+    }
+
+    size_t World::getSize() const {
+        return size;
+    }
+
+    const std::vector<std::unique_ptr<Archetype>> &World::getArchetypes() const {
+        return archetypes;
+    }
+}
@@ -0,0 +1,412 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Vixen {
+    /**
+     * A handle to an entity of a world. Slots of destroyed entities are reused with a new generation, so handles to
+     * them stop being alive instead of silently referring to whatever entity takes the slot next.
+     */
+    struct Entity {
+        uint32_t index = 0;
+
+        /// Live entities never have generation zero, so a default constructed handle is never alive
+        uint32_t generation = 0;
+
+        bool operator==(const Entity &) const = default;
+    };
+
+    using ComponentId = uint32_t;
+
+    /**
+     * How to move and destroy a component without knowing its type
+     */
+    struct ComponentInfo {
+        size_t size;
+
+        size_t alignment;
+
+        void (*moveConstruct)(void *destination, void *source);
+
+        void (*destroy)(void *component);
+
+        template<typename T>
+        static ComponentInfo of() {
+            return {
+                    sizeof(T),
+                    alignof(T),
+                    [](void *destination, void *source) {
+                        new(destination) T(std::move(*static_cast<T *>(source)));
+                    },
+                    [](void *component) {
+                        static_cast<T *>(component)->~T();
+                    }
+            };
+        }
+    };
+
+    /**
+     * Entities with the same set of components. Components are stored in chunks of 16 KiB, every chunk holds an array
+     * of each component and of the entity handles, so queries walk memory linearly. Rows are packed: every chunk but
+     * the last is full, and removing a row moves the last row into the gap.
+     */
+    class Archetype {
+    public:
+        static constexpr size_t chunkSize = 16 * 1024;
+
+        static constexpr size_t maxComponents = 64;
+
+        using Mask = std::bitset<maxComponents>;
+
+        struct alignas(64) Chunk {
+            std::array<std::byte, chunkSize> data;
+        };
+
+    private:
+        struct Column {
+            ComponentId component;
+
+            ComponentInfo info;
+
+            /// The offset of the component array within every chunk
+            size_t offset;
+        };
+
+        Mask mask;
+
+        std::vector<Column> columns;
+
+        /// The position of every component's column, indexed by component id
+        std::array<int16_t, maxComponents> columnIndices{};
+
+        size_t capacity = 0;
+
+        size_t size = 0;
+
+        std::vector<std::unique_ptr<Chunk>> chunks;
+
+        /// Archetypes reached by adding or removing a single component, filled in as entities move around
+        std::unordered_map<ComponentId, Archetype *> addEdges;
+
+        std::unordered_map<ComponentId, Archetype *> removeEdges;
+
+        friend class World;
+
+    public:
+        Archetype(Mask mask, const std::vector<std::pair<ComponentId, ComponentInfo>> &components);
+
+        Archetype(const Archetype &) = delete;
+
+        Archetype &operator=(const Archetype &) = delete;
+
+        ~Archetype();
+
+        [[nodiscard]] const Mask &getMask() const;
+
+        [[nodiscard]] bool has(ComponentId component) const;
+
+        /**
+         * The amount of entities in this archetype
+         */
+        [[nodiscard]] size_t getSize() const;
+
+        /**
+         * The amount of entities a chunk holds
+         */
+        [[nodiscard]] size_t getCapacity() const;
+
+        [[nodiscard]] size_t getChunkCount() const;
+
+        /**
+         * The amount of entities in a chunk
+         */
+        [[nodiscard]] size_t getChunkSize(size_t chunk) const;
+
+        /**
+         * The array of a component in a chunk, the archetype must have the component
+         */
+        [[nodiscard]] void *getColumn(size_t chunk, ComponentId component) const;
+
+        [[nodiscard]] Entity *getEntities(size_t chunk) const;
+
+        template<typename T>
+        [[nodiscard]] T *getColumn(size_t chunk, ComponentId component) const {
+            return static_cast<T *>(getColumn(chunk, component));
+        }
+
+    private:
+        /**
+         * Appends an uninitialized row for an entity, the caller constructs its components
+         *
+         * @return The row of the entity
+         */
+        size_t allocate(Entity entity);
+
+        /**
+         * Destroys the components of a row, including ones that were moved out, and fills the gap with the last row
+         *
+         * @return The entity that was moved into the row, or nothing when the last row was removed
+         */
+        std::optional<Entity> remove(size_t row);
+
+        [[nodiscard]] void *getComponent(size_t row, ComponentId component) const;
+
+        [[nodiscard]] void *getComponent(size_t row, const Column &column) const;
+    };
+
+    template<typename... Ts>
+    class Query;
+
+    /**
+     * Stores entities and their components grouped by archetype, the set of component types an entity has. Adding or
+     * removing a component moves the entity to another archetype. Entities must not be created or destroyed and
+     * components must not be added or removed while a query is iterating.
+     */
+    class World {
+        struct Slot {
+            uint32_t generation = 1;
+
+            Archetype *archetype = nullptr;
+
+            size_t row = 0;
+        };
+
+        std::vector<Slot> slots;
+
+        std::vector<uint32_t> freeSlots;
+
+        std::vector<std::unique_ptr<Archetype>> archetypes;
+
+        std::unordered_map<Archetype::Mask, Archetype *> archetypeMasks;
+
+        size_t size = 0;
+
+        static ComponentId registerComponent(std::type_index type, const ComponentInfo &info);
+
+        [[nodiscard]] static ComponentInfo getComponentInfo(ComponentId component);
+
+        Archetype &getArchetype(const Archetype::Mask &mask);
+
+        /**
+         * The archetype with one component added to or removed from another
+         */
+        Archetype &getNeighbour(Archetype &archetype, ComponentId component, bool add);
+
+        Slot &getSlot(Entity entity);
+
+        [[nodiscard]] const Slot &getSlot(Entity entity) const;
+
+        Entity allocate(Archetype &archetype);
+
+        /**
+         * Moves an entity to another archetype, components missing from the target are destroyed and components missing
+         * from the source are left uninitialized
+         */
+        void move(Entity entity, Archetype &target);
+
+    public:
+        /**
+         * The id of a component type, shared by every world
+         */
+        template<typename T>
+        static ComponentId getComponentId() {
+            static const ComponentId id = registerComponent(typeid(T), ComponentInfo::of<T>());
+            return id;
+        }
+
+        World() = default;
+
+        World(const World &) = delete;
+
+        World &operator=(const World &) = delete;
+
+        template<typename... Ts>
+        Entity create(Ts &&...components) {
+            Archetype::Mask mask;
+            (mask.set(getComponentId<std::decay_t<Ts>>()), ...);
+            if (mask.count() != sizeof...(Ts))
+                throw std::runtime_error("An entity can only have one component of each type");
+
+            auto &archetype = getArchetype(mask);
+            const Entity entity = allocate(archetype);
+            const size_t row = slots[entity.index].row;
+            (new(archetype.getComponent(row, getComponentId<std::decay_t<Ts>>()))
+                    std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+            return entity;
+        }
+
+        void destroy(Entity entity);
+
+        /**
+         * Destroys every entity, handles to them stop being alive
+         */
+        void clear();
+
+        [[nodiscard]] bool isAlive(Entity entity) const;
+
+        template<typename T>
+        [[nodiscard]] bool has(Entity entity) const {
+            return getSlot(entity).archetype->has(getComponentId<T>());
+        }
+
+        /**
+         * The component of an entity, throws when the entity does not have it. The reference is invalidated by adding
+         * or removing components and by creating or destroying entities.
+         */
+        template<typename T>
+        T &get(Entity entity) {
+            const auto &slot = getSlot(entity);
+            const ComponentId component = getComponentId<T>();
+            if (!slot.archetype->has(component))
+                throw std::runtime_error("Entity does not have the component");
+            return *static_cast<T *>(slot.archetype->getComponent(slot.row, component));
+        }
+
+        /**
+         * Adds a component to an entity, replacing it when the entity already has one
+         */
+        template<typename T>
+        T &add(Entity entity, T component) {
+            const auto &slot = getSlot(entity);
+            const ComponentId id = getComponentId<T>();
+            if (slot.archetype->has(id)) {
+                auto *existing = static_cast<T *>(slot.archetype->getComponent(slot.row, id));
+                existing->~T();
+                return *new(existing) T(std::move(component));
+            }
+
+            move(entity, getNeighbour(*slot.archetype, id, true));
+            return *new(slot.archetype->getComponent(slot.row, id)) T(std::move(component));
+        }
+
+        template<typename T>
+        void remove(Entity entity) {
+            const auto &slot = getSlot(entity);
+            const ComponentId id = getComponentId<T>();
+            if (slot.archetype->has(id))
+                move(entity, getNeighbour(*slot.archetype, id, false));
+        }
+
+        /**
+         * Iterates every entity with all of the components, const components are only read
+         */
+        template<typename... Ts>
+        [[nodiscard]] Query<Ts...> query() {
+            return Query<Ts...>(*this);
+        }
+
+        template<typename... Ts>
+        [[nodiscard]] Query<Ts...> query() const {
+            static_assert((std::is_const_v<Ts> && ...), "Components can only be read through a const world");
+            return Query<Ts...>(*this);
+        }
+
+        /**
+         * The amount of live entities
+         */
+        [[nodiscard]] size_t getSize() const;
+
+        [[nodiscard]] const std::vector<std::unique_ptr<Archetype>> &getArchetypes() const;
+    };
+
+    /**
+     * Visits the entities having a set of components chunk by chunk, so every component is read from a contiguous array
+     */
+    template<typename... Ts>
+    class Query {
+        const World &world;
+
+        Archetype::Mask required;
+
+        Archetype::Mask excluded;
+
+        const std::array<ComponentId, sizeof...(Ts)> components{World::getComponentId<std::remove_const_t<Ts>>()...};
+
+        template<typename F, size_t... I>
+        void invoke(F &function, const Archetype &archetype, size_t chunk, std::index_sequence<I...>) const {
+            function(archetype.getChunkSize(chunk), static_cast<const Entity *>(archetype.getEntities(chunk)),
+                     archetype.template getColumn<Ts>(chunk, components[I])...);
+        }
+
+        [[nodiscard]] bool matches(const Archetype &archetype) const {
+            return (archetype.getMask() & required) == required && (archetype.getMask() & excluded).none();
+        }
+
+    public:
+        explicit Query(const World &world) : world(world) {
+            for (const auto component : components)
+                required.set(component);
+        }
+
+        /**
+         * Only visits entities that also have these components, like tags that are never read
+         */
+        template<typename... Us>
+        Query &with() {
+            (required.set(World::getComponentId<Us>()), ...);
+            return *this;
+        }
+
+        /**
+         * Skips entities having any of these components
+         */
+        template<typename... Us>
+        Query &without() {
+            (excluded.set(World::getComponentId<Us>()), ...);
+            return *this;
+        }
+
+        /**
+         * Calls the function with the amount of entities in a chunk, their handles and an array of every component
+         */
+        template<typename F>
+        void eachChunk(F &&function) const {
+            for (const auto &archetype : world.getArchetypes()) {
+                if (!matches(*archetype))
+                    continue;
+                for (size_t chunk = 0; chunk < archetype->getChunkCount(); chunk++)
+                    invoke(function, *archetype, chunk, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        /**
+         * Calls the function with the components of every entity, optionally preceded by the entity itself
+         */
+        template<typename F>
+        void each(F &&function) const {
+            eachChunk([&function](size_t count, const Entity *entities, Ts *...columns) {
+                for (size_t i = 0; i < count; i++) {
+                    if constexpr (std::is_invocable_v<F &, Entity, Ts &...>)
+                        function(entities[i], columns[i]...);
+                    else
+                        function(columns[i]...);
+                }
+            });
+        }
+
+        /**
+         * The amount of entities the query visits
+         */
+        [[nodiscard]] size_t count() const {
+            size_t count = 0;
+            for (const auto &archetype : world.getArchetypes())
+                if (matches(*archetype))
+                    count += archetype->getSize();
+            return count;
+        }
+    };
+}
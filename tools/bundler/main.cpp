@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <VixenEngine.h>
+#include <Bundle.h>
+#include <MeshCache.h>
+#include <MeshImporter.h>
+
+namespace {
+    const Vixen::Logger logger{"Bundler"};
+
+    /**
+     * Parses a zstd compression level, throws when the value is not a level zstd accepts
+     */
+    int parseLevel(const std::string &value) {
+        size_t end = 0;
+        int level = 0;
+        try {
+            level = std::stoi(value, &end);
+        } catch (const std::invalid_argument &) {
+        } catch (const std::out_of_range &) {
+        }
+        /// stoi stops at the first character that is not a digit, the whole value has to be the level
+        if (end == 0 || end != value.size() || level < Vixen::Bundle::getMinLevel() ||
+            level > Vixen::Bundle::getMaxLevel())
+            throw std::runtime_error(fmt::format("--level expects a whole number from {} to {}, got \"{}\"",
+                                                 Vixen::Bundle::getMinLevel(), Vixen::Bundle::getMaxLevel(), value));
+        return level;
+    }
+
+    struct Bundler {
+        std::filesystem::path root;
+
+        std::vector<Vixen::Bundle::Source> sources;
+
+        std::set<std::string> names;
+
+        /**
+         * The name the engine looks an asset up by, its normalized path relative to the root
+         */
+        [[nodiscard]] std::string nameOf(const std::filesystem::path &path) const {
+            const auto normal = path.lexically_normal();
+            return (root.empty() ? normal : normal.lexically_relative(root)).generic_string();
+        }
+
+        static std::vector<uint8_t> readFile(const std::filesystem::path &path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("Failed to open file");
+            return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        }
+
+        /**
+         * Adds an image under its own name, the transcoded KTX2 file next to it is stored in its place when there is
+         * one just like the engine prefers it when loading loose files
+         */
+        bool addImage(const std::filesystem::path &path) {
+            auto name = nameOf(path);
+            if (!names.insert(name).second)
+                return true;
+
+            auto compressed = path;
+            compressed.replace_extension(".ktx2");
+            const bool transcoded = std::filesystem::exists(compressed);
+            try {
+                sources.push_back({std::move(name), transcoded ? Vixen::Bundle::Type::KTX2 : Vixen::Bundle::Type::IMAGE,
+                                   readFile(transcoded ? compressed : path)});
+            } catch (std::runtime_error &error) {
+                logger.error("Failed to read image \"{}\" ({})", path.string(), error.what());
+                return false;
+            }
+            return true;
+        }
+
+        bool addModel(const std::filesystem::path &path) {
+            std::vector<Vixen::MeshData> meshes;
+            try {
+                meshes = Vixen::MeshImporter::import(path.string());
+            } catch (std::runtime_error &error) {
+                logger.error("Failed to import model \"{}\" ({})", path.string(), error.what());
+                return false;
+            }
+
+            /// The bundle replaces the model file, so there is nothing to check the mesh cache source against
+            std::ostringstream stream(std::ios::binary);
+            Vixen::MeshCache::write(stream, {0, 0, Vixen::MeshImporter::importFlags}, meshes);
+            const auto contents = stream.str();
+
+            auto name = nameOf(path);
+            if (names.insert(name).second)
+                sources.push_back({std::move(name), Vixen::Bundle::Type::MESH, {contents.begin(), contents.end()}});
+
+            bool success = true;
+            for (const auto &mesh : meshes)
+                if (!mesh.texture.empty())
+                    success &= addImage(Vixen::MeshImporter::resolve(path.string(), mesh.texture));
+            return success;
+        }
+    };
+}
+
+/**
+ * Packs models, their textures and loose images into a compressed bundle the engine can mount. Models are stored
+ * imported, so loading them from the bundle skips Assimp. Asset names are relative to the root directory, which has to
+ * match the root the bundle is mounted with.
+ */
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+
+    const std::set<std::string> imageExtensions{".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".ktx2"};
+    Bundler bundler;
+    int level = 19;
+    int i = 1;
+    try {
+        for (; i < argc; i++) {
+            const std::string argument = argv[i];
+            if (!argument.starts_with("--"))
+                break;
+            if (argument != "--level" && argument != "--root")
+                throw std::runtime_error(fmt::format("Unknown argument \"{}\"", argument));
+            if (i + 1 >= argc)
+                throw std::runtime_error(fmt::format("{} misses its value", argument));
+
+            if (argument == "--level")
+                level = parseLevel(argv[++i]);
+            else
+                bundler.root = std::filesystem::path(argv[++i]).lexically_normal();
+        }
+        if (argc - i < 2)
+            throw std::runtime_error("No output and assets given");
+    } catch (const std::runtime_error &error) {
+        logger.error("{}", error.what());
+        logger.error("Usage: {} [--level <level>] [--root <directory>] <output> <model or image>...", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::filesystem::path output(argv[i++]);
+    bool success = true;
+    for (; i < argc; i++) {
+        const std::filesystem::path path(argv[i]);
+        auto extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (imageExtensions.contains(extension))
+            success &= bundler.addImage(path);
+        else
+            success &= bundler.addModel(path);
+    }
+
+    try {
+        Vixen::Bundle::write(output, bundler.sources, level);
+    } catch (std::exception &error) {
+        logger.error("Failed to write \"{}\" ({})", output.string(), error.what());
+        return EXIT_FAILURE;
+    }
+
+    const auto bundle = Vixen::Bundle(output);
+    uint64_t size = 0, compressedSize = 0;
+    for (const auto &entry : bundle.getEntries()) {
+        size += entry.size;
+        compressedSize += entry.compressedSize;
+    }
+    logger.info("Bundled {} assets into \"{}\", {} bytes compressed to {}", bundle.getEntries().size(), output.string(),
+                size, compressedSize);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
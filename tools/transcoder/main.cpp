@@ -0,0 +1,241 @@
+#define STB_DXT_IMPLEMENTATION
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <stb_dxt.h>
+#include <VixenEngine.h>
+#include <Ktx2.h>
+
+namespace {
+    const Vixen::Logger logger{"Transcoder"};
+
+    enum class Encoding {
+        COLOR,
+        NORMAL
+    };
+
+    struct Surface {
+        uint32_t width;
+
+        uint32_t height;
+
+        /// Tightly packed RGBA8 pixels
+        std::vector<uint8_t> pixels;
+    };
+
+    float toLinear(uint8_t value) {
+        const float c = static_cast<float>(value) / 255.0f;
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    uint8_t toSrgb(float value) {
+        const float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+    }
+
+    uint8_t toUnorm(float value) {
+        return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    /**
+     * Halves a surface with a box filter, color is averaged in linear space and normals are renormalized
+     */
+    Surface downsample(const Surface &source, Encoding encoding) {
+        Surface target{std::max(source.width / 2, 1u), std::max(source.height / 2, 1u), {}};
+        target.pixels.resize(static_cast<size_t>(target.width) * target.height * 4);
+
+        for (uint32_t y = 0; y < target.height; y++) {
+            for (uint32_t x = 0; x < target.width; x++) {
+                float sum[4]{};
+                for (uint32_t dy = 0; dy < 2; dy++) {
+                    for (uint32_t dx = 0; dx < 2; dx++) {
+                        const uint32_t sx = std::min(x * 2 + dx, source.width - 1);
+                        const uint32_t sy = std::min(y * 2 + dy, source.height - 1);
+                        const uint8_t *pixel = &source.pixels[(static_cast<size_t>(sy) * source.width + sx) * 4];
+                        for (uint32_t c = 0; c < 4; c++)
+                            sum[c] += encoding == Encoding::COLOR && c < 3 ? toLinear(pixel[c])
+                                                                           : static_cast<float>(pixel[c]) / 255.0f;
+                    }
+                }
+
+                uint8_t *pixel = &target.pixels[(static_cast<size_t>(y) * target.width + x) * 4];
+                if (encoding == Encoding::COLOR) {
+                    for (uint32_t c = 0; c < 3; c++)
+                        pixel[c] = toSrgb(sum[c] / 4.0f);
+                } else {
+                    float normal[3];
+                    for (uint32_t c = 0; c < 3; c++)
+                        normal[c] = sum[c] / 2.0f - 1.0f;
+                    const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] +
+                                                   normal[2] * normal[2]);
+                    for (uint32_t c = 0; c < 3; c++)
+                        pixel[c] = toUnorm((length > 0.0f ? normal[c] / length : 0.0f) * 0.5f + 0.5f);
+                }
+                pixel[3] = toUnorm(sum[3] / 4.0f);
+            }
+        }
+
+        return target;
+    }
+
+    bool hasAlpha(const Surface &surface) {
+        for (size_t i = 3; i < surface.pixels.size(); i += 4)
+            if (surface.pixels[i] != 255)
+                return true;
+        return false;
+    }
+
+    std::vector<uint8_t> compress(const Surface &surface, VkFormat format) {
+        const uint32_t blocksX = (surface.width + 3) / 4;
+        const uint32_t blocksY = (surface.height + 3) / 4;
+        const size_t blockBytes = format == VK_FORMAT_BC1_RGB_SRGB_BLOCK ? 8 : 16;
+        std::vector<uint8_t> output(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+        uint8_t block[64];
+        for (uint32_t by = 0; by < blocksY; by++) {
+            for (uint32_t bx = 0; bx < blocksX; bx++) {
+                /// Blocks hanging over the edge repeat the last row and column
+                for (uint32_t y = 0; y < 4; y++) {
+                    for (uint32_t x = 0; x < 4; x++) {
+                        const uint32_t sx = std::min(bx * 4 + x, surface.width - 1);
+                        const uint32_t sy = std::min(by * 4 + y, surface.height - 1);
+                        const uint8_t *pixel = &surface.pixels[(static_cast<size_t>(sy) * surface.width + sx) * 4];
+                        if (format == VK_FORMAT_BC5_UNORM_BLOCK) {
+                            block[(y * 4 + x) * 2] = pixel[0];
+                            block[(y * 4 + x) * 2 + 1] = pixel[1];
+                        } else {
+                            std::copy(pixel, pixel + 4, &block[(y * 4 + x) * 4]);
+                        }
+                    }
+                }
+
+                uint8_t *destination = &output[(static_cast<size_t>(by) * blocksX + bx) * blockBytes];
+                if (format == VK_FORMAT_BC5_UNORM_BLOCK)
+                    stb_compress_bc5_block(destination, block);
+                else
+                    stb_compress_dxt_block(destination, block, format == VK_FORMAT_BC3_SRGB_BLOCK, STB_DXT_HIGHQUAL);
+            }
+        }
+
+        return output;
+    }
+
+    bool transcode(const std::filesystem::path &source, Encoding encoding) {
+        auto target = source;
+        target.replace_extension(".ktx2");
+        if (std::filesystem::exists(target) &&
+            std::filesystem::last_write_time(target) >= std::filesystem::last_write_time(source)) {
+            logger.info("Skipping \"{}\", it is up to date", source.string());
+            return true;
+        }
+
+        int32_t width, height, channels;
+        stbi_uc *pixels = stbi_load(source.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            logger.error("Failed to open \"{}\"", source.string());
+            return false;
+        }
+
+        Surface surface{static_cast<uint32_t>(width), static_cast<uint32_t>(height), {}};
+        surface.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+        stbi_image_free(pixels);
+
+        VkFormat format = VK_FORMAT_BC5_UNORM_BLOCK;
+        if (encoding == Encoding::COLOR)
+            format = hasAlpha(surface) ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+
+        std::vector<std::vector<uint8_t>> levels;
+        const uint32_t levelCount = Vixen::Image::fullMipLevels(surface.width, surface.height);
+        for (uint32_t level = 0; level < levelCount; level++) {
+            if (level > 0)
+                surface = downsample(surface, encoding);
+            levels.push_back(compress(surface, format));
+        }
+
+        std::ofstream file(target, std::ios::binary);
+        try {
+            Vixen::Ktx2::write(file, format, static_cast<uint32_t>(width), static_cast<uint32_t>(height), levels);
+        } catch (std::runtime_error &error) {
+            logger.error("Failed to write \"{}\" ({})", target.string(), error.what());
+            return false;
+        }
+
+        logger.info("Transcoded \"{}\" to {} with {} mip levels", source.string(), string_VkFormat(format), levelCount);
+        return true;
+    }
+
+    bool transcodeModel(const std::filesystem::path &path) {
+        Assimp::Importer importer;
+        const auto aiScene = importer.ReadFile(path.string(), 0);
+        if (!aiScene) {
+            logger.error("Failed to open model \"{}\"", path.string());
+            return false;
+        }
+
+        std::set<std::pair<std::filesystem::path, Encoding>> textures;
+        for (uint32_t i = 0; i < aiScene->mNumMaterials; i++) {
+            const auto &material = aiScene->mMaterials[i];
+            for (const auto &[type, encoding] : {std::pair{aiTextureType_DIFFUSE, Encoding::COLOR},
+                                                 std::pair{aiTextureType_NORMALS, Encoding::NORMAL}}) {
+                for (uint32_t x = 0; x < material->GetTextureCount(type); x++) {
+                    aiString str;
+                    material->GetTexture(type, x, &str);
+                    std::string relative = str.C_Str();
+                    /// Embedded textures are referenced by index and have no file to transcode
+                    if (relative.empty() || relative[0] == '*')
+                        continue;
+
+                    std::replace(relative.begin(), relative.end(), '\\', '/');
+                    textures.emplace(std::filesystem::path(path).remove_filename().append(relative), encoding);
+                }
+            }
+        }
+
+        bool success = true;
+        for (const auto &[texture, encoding] : textures)
+            success &= transcode(texture, encoding);
+        return success;
+    }
+}
+
+/**
+ * Transcodes textures to block compressed KTX2 files with a full mip chain, the engine picks these up in place of the
+ * source image when they are placed next to it. Color textures become BC1 or BC3 depending on whether they use alpha,
+ * normal maps become BC5.
+ */
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::info);
+
+    if (argc < 2) {
+        logger.error("Usage: {} [--normal] <model or image>...", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::set<std::string> imageExtensions{".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd"};
+    bool success = true;
+    auto encoding = Encoding::COLOR;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "--normal") {
+            encoding = Encoding::NORMAL;
+            continue;
+        }
+
+        const std::filesystem::path path(argument);
+        auto extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (imageExtensions.contains(extension))
+            success &= transcode(path, encoding);
+        else
+            success &= transcodeModel(path);
+        encoding = Encoding::COLOR;
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}